@@ -0,0 +1,25 @@
+#ifndef _bench_utils_H_
+#define _bench_utils_H_
+
+#include <stdlib.h>
+#include <time.h>
+
+/* Seconds on a monotonic clock, for timing a stretch of code. */
+double bench_now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Fill str with characters drawn uniformly from alphabet. */
+void bench_random_string(char* str, size_t str_len, const char* alphabet,
+                         size_t alphabet_len)
+{
+  size_t i = 0;
+  for(i = 0; i < str_len; i++) {
+    str[i] = alphabet[rand() % alphabet_len];
+  }
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_utils.h"
+#include "lca/lca_suffix_tree.h"
+#include "lca/succinct_lca.h"
+#include "kolpakov_kucherov/augmented_string.h"
+
+/*
+ * Time lowest common ancestor queries on random pairs of leaves of the
+ * suffix tree of a random DNA string, with an LCASuffixTree_T and with a
+ * SuccinctLCA_T, and LCE queries on random pairs of
+ * positions of an augmented string, one at a time and in batches.
+ */
+
+#define STRING_LENGTH 1000000
+#define NUM_QUERIES   5000000
+
+void report(const char* name, double start, double end, size_t checksum)
+{
+  printf("%-22s %8.3f s   %6.1f ns/query   (checksum %zu)\n", name, end - start,
+         (end - start) * 1e9 / NUM_QUERIES, checksum);
+}
+
+void bench_lca(const char* str, const size_t* positions)
+{
+  double start = bench_now();
+  LCASuffixTree_T tree = LCASuffixTree_create((char*)str, STRING_LENGTH);
+  double built = bench_now();
+  if(tree == NULL) {
+    printf("failed to build tree\n");
+    return;
+  }
+  printf("LCASuffixTree build    %8.3f s\n", built - start);
+
+  Node_T* leaves = SuffixTree_create_leaf_array((SuffixTree_T)tree);
+  Node_T* pairs = malloc(2 * NUM_QUERIES * sizeof(Node_T));
+  Node_T* lcas = malloc(NUM_QUERIES * sizeof(Node_T));
+  size_t i = 0;
+  for(i = 0; i < 2 * NUM_QUERIES; i++) {
+    pairs[i] = leaves[positions[i]];
+  }
+
+  size_t depth_sum = 0;
+  start = bench_now();
+  for(i = 0; i < NUM_QUERIES; i++) {
+    Node_T lca = LCASuffixTree_get_lca(tree, pairs[2 * i], pairs[2 * i + 1]);
+    depth_sum += Node_get_edge_depth(lca);
+  }
+  report("LCA one at a time", start, bench_now(), depth_sum);
+
+  depth_sum = 0;
+  start = bench_now();
+  LCASuffixTree_get_lca_batch(tree, pairs, NUM_QUERIES, lcas);
+  double end = bench_now();
+  for(i = 0; i < NUM_QUERIES; i++) {
+    depth_sum += Node_get_edge_depth(lcas[i]);
+  }
+  report("LCA batch", start, end, depth_sum);
+
+  free(lcas);
+  free(pairs);
+  free(leaves);
+  LCASuffixTree_delete(&tree);
+}
+
+void bench_succinct_lca(const char* str, const size_t* positions)
+{
+  SuffixTree_T tree = SuffixTree_create((char*)str, STRING_LENGTH);
+  if(tree == NULL) {
+    printf("failed to build tree\n");
+    return;
+  }
+  double start = bench_now();
+  SuccinctLCA_T lca = SuccinctLCA_create(tree);
+  double built = bench_now();
+  if(lca == NULL) {
+    printf("failed to build SuccinctLCA_T\n");
+    SuffixTree_delete(&tree);
+    return;
+  }
+  printf("SuccinctLCA build      %8.3f s   %5.2f bytes/node\n", built - start,
+         (double)SuccinctLCA_get_size(lca) / SuffixTree_get_num_nodes(tree));
+
+  Node_T* leaves = SuffixTree_create_leaf_array(tree);
+  size_t i = 0, depth_sum = 0;
+  start = bench_now();
+  for(i = 0; i < NUM_QUERIES; i++) {
+    Node_T lca_node = SuccinctLCA_get_lca(lca, leaves[positions[2 * i]],
+                                          leaves[positions[2 * i + 1]]);
+    depth_sum += Node_get_edge_depth(lca_node);
+  }
+  report("Succinct LCA", start, bench_now(), depth_sum);
+
+  free(leaves);
+  SuccinctLCA_delete(&lca);
+  SuffixTree_delete(&tree);
+}
+
+void bench_lce(const char* str, const size_t* positions,
+               enum AugmentedStringBackend backend, const char* name)
+{
+  double start = bench_now();
+  AugmentedString_T aug_string = AugmentedString_create_with_backend(
+      (char*)str, STRING_LENGTH, backend);
+  double built = bench_now();
+  if(aug_string == NULL) {
+    printf("failed to build augmented string\n");
+    return;
+  }
+  printf("%s build %8.3f s\n", name, built - start);
+
+  size_t* lengths = malloc(NUM_QUERIES * sizeof(size_t));
+  size_t i = 0, sum = 0;
+  start = bench_now();
+  for(i = 0; i < NUM_QUERIES; i++) {
+    sum += AugmentedString_lce(aug_string, positions[2 * i], positions[2 * i + 1]);
+  }
+  report("LCE one at a time", start, bench_now(), sum);
+
+  sum = 0;
+  start = bench_now();
+  AugmentedString_lce_batch(aug_string, positions, NUM_QUERIES, lengths);
+  double end = bench_now();
+  for(i = 0; i < NUM_QUERIES; i++) {
+    sum += lengths[i];
+  }
+  report("LCE batch", start, end, sum);
+
+  free(lengths);
+  AugmentedString_delete(&aug_string);
+}
+
+int main()
+{
+  char* str = malloc(STRING_LENGTH);
+  bench_random_string(str, STRING_LENGTH, "ACGT", 4);
+
+  size_t* positions = malloc(2 * NUM_QUERIES * sizeof(size_t));
+  size_t i = 0;
+  srand(1);
+  for(i = 0; i < 2 * NUM_QUERIES; i++) {
+    positions[i] = rand() % STRING_LENGTH;
+  }
+
+  bench_lca(str, positions);
+  bench_succinct_lca(str, positions);
+  bench_lce(str, positions, AUGMENTED_STRING_SUFFIX_TREE, "Augmented tree ");
+  bench_lce(str, positions, AUGMENTED_STRING_SUFFIX_ARRAY, "Augmented array");
+
+  free(positions);
+  free(str);
+  return 0;
+}
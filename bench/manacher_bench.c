@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_utils.h"
+#include "manacher/manacher.h"
+#include "manacher/manacher_complement.h"
+#include "manacher/manacher_packed.h"
+#include "manacher/manacher_parallel.h"
+#include "manacher/palindrome_radii.h"
+
+/*
+ * Time manacher, manacher_narrow at each width, and manacher_parallel with
+ * increasing numbers of threads on a random DNA string, checking that every
+ * run gives the same radii, and time manacher_with_relation,
+ * manacher_complement and manacher_packed on the same string. Then time
+ * manacher and manacher_packed on a string with long low-complexity
+ * stretches.
+ */
+
+#define STRING_LENGTH 20000000
+
+int main()
+{
+  char* str = malloc(STRING_LENGTH);
+  srand(1);
+  bench_random_string(str, STRING_LENGTH, "ACGT", 4);
+
+  double start = bench_now();
+  size_t* expected = manacher(str, STRING_LENGTH);
+  double sequential = bench_now() - start;
+  printf("manacher                 %7.3f s   %6zu MB\n", sequential,
+         (2 * STRING_LENGTH + 1) * sizeof(size_t) >> 20);
+
+  enum RadiusWidth widths[] = {RADIUS_WIDTH_32, RADIUS_WIDTH_16};
+  size_t w = 0;
+  for(w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+    start = bench_now();
+    PalindromeRadii_T narrow = manacher_narrow(str, STRING_LENGTH, widths[w]);
+    double elapsed = bench_now() - start;
+    size_t i = 0;
+    int same = 1;
+    for(i = 0; i < 2 * STRING_LENGTH + 1 && same; i++) {
+      same = PalindromeRadii_get(narrow, i) == expected[i];
+    }
+    printf("manacher_narrow %2d       %7.3f s   %6zu MB%s\n", widths[w], elapsed,
+           PalindromeRadii_get_size(narrow) >> 20, same ? "" : "   RADII DIFFER");
+    PalindromeRadii_delete(&narrow);
+    if(!same) return 1;
+  }
+
+  unsigned int num_threads = 0;
+  for(num_threads = 1; num_threads <= 16; num_threads *= 2) {
+    start = bench_now();
+    size_t* radii = manacher_parallel(str, STRING_LENGTH, num_threads);
+    double elapsed = bench_now() - start;
+    int same = memcmp(radii, expected, (2 * STRING_LENGTH + 1) * sizeof(size_t)) == 0;
+    printf("manacher_parallel %3u    %7.3f s   %5.2fx%s\n", num_threads, elapsed,
+           sequential / elapsed, same ? "" : "   RADII DIFFER");
+    free(radii);
+    if(!same) return 1;
+  }
+
+  const char* relation_names[] = {"exact", "case-insensitive", "reverse complement"};
+  enum PalindromeRelation relation = RELATION_EXACT;
+  for(relation = RELATION_EXACT; relation <= RELATION_REVERSE_COMPLEMENT; relation++) {
+    start = bench_now();
+    size_t* relation_radii = manacher_with_relation(str, STRING_LENGTH, relation);
+    double elapsed = bench_now() - start;
+    int same = relation != RELATION_EXACT ||
+               memcmp(relation_radii, expected, (2 * STRING_LENGTH + 1) * sizeof(size_t)) == 0;
+    printf("relation %-18s%7.3f s   %5.2fx%s\n", relation_names[relation], elapsed,
+           sequential / elapsed, same ? "" : "   RADII DIFFER");
+    free(relation_radii);
+    if(!same) return 1;
+  }
+
+  start = bench_now();
+  size_t* complement_radii = manacher_complement(str, STRING_LENGTH);
+  printf("manacher_complement      %7.3f s   %6zu MB\n", bench_now() - start,
+         (STRING_LENGTH + 1) * sizeof(size_t) >> 20);
+  free(complement_radii);
+
+  start = bench_now();
+  PackedSequence_T sequence = PackedSequence_create(str, STRING_LENGTH);
+  double packing = bench_now() - start;
+  start = bench_now();
+  size_t* radii = manacher_packed(sequence);
+  double elapsed = bench_now() - start;
+  int same = memcmp(radii, expected, (2 * STRING_LENGTH + 1) * sizeof(size_t)) == 0;
+  printf("manacher_packed          %7.3f s   %6zu MB input, packed in %.3f s%s\n",
+         elapsed, PackedSequence_get_size(sequence) >> 20, packing,
+         same ? "" : "   RADII DIFFER");
+  free(radii);
+  PackedSequence_delete(&sequence);
+  if(!same) return 1;
+  free(expected);
+
+  /* Low-complexity stretches, where arms run long: every other block of 1000
+   * characters alternates two bases. */
+  size_t i = 0;
+  for(i = 0; i < STRING_LENGTH; i++) {
+    if((i / 1000) % 2 == 0) str[i] = i % 2 ? 'A' : 'T';
+  }
+  start = bench_now();
+  expected = manacher(str, STRING_LENGTH);
+  printf("manacher, low complexity %7.3f s\n", bench_now() - start);
+  sequence = PackedSequence_create(str, STRING_LENGTH);
+  start = bench_now();
+  radii = manacher_packed(sequence);
+  elapsed = bench_now() - start;
+  same = memcmp(radii, expected, (2 * STRING_LENGTH + 1) * sizeof(size_t)) == 0;
+  printf("packed, low complexity   %7.3f s%s\n", elapsed, same ? "" : "   RADII DIFFER");
+  free(radii);
+  PackedSequence_delete(&sequence);
+  if(!same) return 1;
+
+  free(expected);
+  free(str);
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bench_utils.h"
+#include "lca/lca_suffix_tree.h"
+#include "lca/offline_lca.h"
+
+/*
+ * Compare answering a known set of LCA queries on random leaf pairs with an
+ * LCASuffixTree_T against answering them offline on a plain SuffixTree_T.
+ * Both times include building the tree. Each run is in its own process so
+ * that its peak memory can be reported.
+ */
+
+#define STRING_LENGTH 2000000
+
+void run(int offline, size_t num_pairs)
+{
+  char* str = malloc(STRING_LENGTH);
+  srand(1);
+  bench_random_string(str, STRING_LENGTH, "ACGT", 4);
+  size_t* positions = malloc(2 * num_pairs * sizeof(size_t));
+  size_t i = 0;
+  for(i = 0; i < 2 * num_pairs; i++) {
+    positions[i] = rand() % STRING_LENGTH;
+  }
+
+  double start = bench_now();
+  SuffixTree_T tree = offline ?
+                      SuffixTree_create(str, STRING_LENGTH) :
+                      (SuffixTree_T)LCASuffixTree_create(str, STRING_LENGTH);
+  Node_T* leaves = SuffixTree_create_leaf_array(tree);
+  Node_T* pairs = malloc(2 * num_pairs * sizeof(Node_T));
+  Node_T* lcas = malloc(num_pairs * sizeof(Node_T));
+  for(i = 0; i < 2 * num_pairs; i++) {
+    pairs[i] = leaves[positions[i]];
+  }
+  double built = bench_now();
+
+  if(offline) {
+    OfflineLCA_find(tree, pairs, num_pairs, lcas);
+  } else {
+    LCASuffixTree_get_lca_batch((LCASuffixTree_T)tree, pairs, num_pairs, lcas);
+  }
+  double answered = bench_now();
+
+  size_t depth_sum = 0;
+  for(i = 0; i < num_pairs; i++) {
+    depth_sum += Node_get_edge_depth(lcas[i]);
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  printf("%-8s %9zu pairs   build %7.3f s   queries %7.3f s   total %7.3f s   "
+         "peak %6ld MB   (depth sum %zu)\n",
+         offline ? "offline" : "online", num_pairs, built - start,
+         answered - built, answered - start, usage.ru_maxrss / 1024, depth_sum);
+  fflush(stdout);
+}
+
+int main()
+{
+  size_t query_counts[] = {100000, 1000000, 10000000};
+  size_t q = 0;
+  int offline = 0;
+  for(q = 0; q < sizeof(query_counts) / sizeof(query_counts[0]); q++) {
+    for(offline = 0; offline < 2; offline++) {
+      pid_t pid = fork();
+      if(pid == 0) {
+        run(offline, query_counts[q]);
+        _exit(0);
+      }
+      waitpid(pid, NULL, 0);
+    }
+  }
+  return 0;
+}
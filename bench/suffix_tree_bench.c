@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_utils.h"
+#include "suffix_tree/suffix_tree.h"
+
+/*
+ * Compare suffix tree construction and search with sons kept in sibling
+ * lists against sons kept in a child table, for a DNA and an ASCII string.
+ */
+
+#define STRING_LENGTH 2000000
+#define NUM_QUERIES   200000
+#define QUERY_LENGTH  20
+
+void bench_alphabet(const char* name, const char* alphabet)
+{
+  size_t alphabet_len = strlen(alphabet);
+  char* str = malloc(STRING_LENGTH);
+  bench_random_string(str, STRING_LENGTH, alphabet, alphabet_len);
+
+  const char* modes[] = {"sibling list", "child table"};
+  int mode = 0;
+  for(mode = 0; mode < 2; mode++) {
+    double start = bench_now();
+    SuffixTree_T tree = mode == 0 ?
+                        SuffixTree_create(str, STRING_LENGTH) :
+                        SuffixTree_create_with_alphabet(str, STRING_LENGTH, alphabet);
+    double built = bench_now();
+    if(tree == NULL) {
+      printf("%s: failed to build tree with %s\n", name, modes[mode]);
+      continue;
+    }
+
+    size_t i = 0, found = 0;
+    srand(1);
+    for(i = 0; i < NUM_QUERIES; i++) {
+      size_t query_start = rand() % (STRING_LENGTH - QUERY_LENGTH);
+      if(SuffixTree_find_substring(tree, str + query_start, QUERY_LENGTH) !=
+         (SuffixTreeIndex_T)-1) {
+        found++;
+      }
+    }
+    double searched = bench_now();
+
+    printf("%-6s %-13s build %8.3f s   %zu searches %8.3f s   (%zu found)\n",
+           name, modes[mode], built - start, (size_t)NUM_QUERIES,
+           searched - built, found);
+    SuffixTree_delete(&tree);
+  }
+  free(str);
+}
+
+int main()
+{
+  char ascii[128];
+  int c = 0, n = 0;
+  for(c = ' '; c <= '~'; c++) {
+    if(c != '$') ascii[n++] = c;
+  }
+  ascii[n] = '\0';
+
+  bench_alphabet("DNA", "ACGTN");
+  bench_alphabet("ASCII", ascii);
+  return 0;
+}
@@ -0,0 +1,258 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "edit_palindromes.h"
+#include "manacher/manacher.h"
+
+#include "utils/dbg.h"
+
+#define MIN(A, B) ((A) < (B) ? A : B)
+
+/* Rows of the alignment per word */
+#define WORD_BITS 64
+
+/*
+ * The exact palindrome of radius R at center C is query_string[FIRST:LAST+1].
+ * An empty palindrome between two characters has LAST = FIRST - 1.
+ */
+#define FIRST(C, R) ((C) / 2 - (R))
+#define LAST(C, R) (((C) - 1) / 2 + (R))
+
+/*
+ * The alignment of the rest of the left arm of a center, reversed, against the
+ * rest of its right arm. Row i is the first i characters of the left arm and
+ * column j the first j of the right arm. Myers' algorithm keeps a column as
+ * bit vectors of whether each row is one more (pv) or one less (mv) than the
+ * row above it, a word per 64 rows, along with the value of the bottom row of
+ * each word.
+ */
+struct Alignment {
+  char*     pattern;
+  uint64_t* pv;
+  uint64_t* mv;
+  size_t*   bottom;
+  size_t    num_words;
+  size_t    num_words_allocated;
+};
+
+static int Alignment_reserve(struct Alignment* alignment, size_t num_words)
+{
+  if(num_words <= alignment->num_words_allocated) return 0;
+
+  char* tmp_pattern = realloc(alignment->pattern, num_words * WORD_BITS);
+  check_mem(tmp_pattern);
+  alignment->pattern = tmp_pattern;
+  uint64_t* tmp_pv = realloc(alignment->pv, num_words * sizeof(uint64_t));
+  check_mem(tmp_pv);
+  alignment->pv = tmp_pv;
+  uint64_t* tmp_mv = realloc(alignment->mv, num_words * sizeof(uint64_t));
+  check_mem(tmp_mv);
+  alignment->mv = tmp_mv;
+  size_t* tmp_bottom = realloc(alignment->bottom, num_words * sizeof(size_t));
+  check_mem(tmp_bottom);
+  alignment->bottom = tmp_bottom;
+
+  alignment->num_words_allocated = num_words;
+  return 0;
+error:
+  return 1;
+}
+
+/* Bits set where the 64 characters at block equal c. */
+static inline uint64_t match_mask(const char* block, char c)
+{
+#if defined(__SSE2__)
+  __m128i chars = _mm_set1_epi8(c);
+  uint64_t mask = 0;
+  int i = 0;
+  for(i = 0; i < 4; i++) {
+    __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(block + 16 * i)),
+                                chars);
+    mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(eq) << (16 * i);
+  }
+  return mask;
+#else
+  uint64_t mask = 0;
+  int i = 0;
+  for(i = 0; i < WORD_BITS; i++) {
+    mask |= (uint64_t)(block[i] == c) << i;
+  }
+  return mask;
+#endif
+}
+
+/*
+ * Advance one word of the column by one character of the text, given the
+ * change along the row above the word, and return the change along its
+ * bottom row. This is Myers' step with the carries between words from Hyyrö.
+ */
+static inline int advance_word(uint64_t* pv_word, uint64_t* mv_word, uint64_t eq,
+                               int h_in)
+{
+  uint64_t pv = *pv_word;
+  uint64_t mv = *mv_word;
+  uint64_t xv = eq | mv;
+  if(h_in < 0) eq |= 1;
+  uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+  uint64_t ph = mv | ~(xh | pv);
+  uint64_t mh = pv & xh;
+
+  int h_out = 0;
+  if(ph >> (WORD_BITS - 1)) h_out = 1;
+  if(mh >> (WORD_BITS - 1)) h_out = -1;
+
+  ph <<= 1;
+  mh <<= 1;
+  if(h_in < 0) mh |= 1;
+  else if(h_in > 0) ph |= 1;
+
+  *pv_word = mh | ~(xv | ph);
+  *mv_word = ph & xv;
+  return h_out;
+}
+
+/* The value of row i, given that row 0 is column. */
+static inline size_t cell(const struct Alignment* alignment, size_t i,
+                          size_t column)
+{
+  if(i == 0) return column;
+  size_t word = (i - 1) / WORD_BITS;
+  size_t bit = (i - 1) % WORD_BITS;
+  uint64_t below = bit == WORD_BITS - 1 ? 0 : ~(uint64_t)0 << (bit + 1);
+  return alignment->bottom[word] - __builtin_popcountll(alignment->pv[word] & below)
+                                 + __builtin_popcountll(alignment->mv[word] & below);
+}
+
+/*
+ * Find the longest prefixes left of query_string[:first], reversed, and
+ * right of query_string[right_start:] within max_edits of each other.
+ */
+static int extend(struct Alignment* alignment, const char* query_string,
+                  size_t query_length, size_t first, size_t right_start,
+                  size_t max_edits, size_t* left, size_t* right, size_t* edits)
+{
+  size_t num_words = 1;
+  size_t right_available = query_length - right_start;
+
+  while(1) {
+    int rc = Alignment_reserve(alignment, num_words);
+    check(rc == 0, "Failed to allocate alignment.");
+    alignment->num_words = num_words;
+
+    size_t rows = MIN(first, num_words * WORD_BITS);
+    size_t i = 0;
+    size_t w = 0;
+    for(i = 0; i < rows; i++) alignment->pattern[i] = query_string[first - 1 - i];
+    for(w = 0; w < num_words; w++) {
+      alignment->pv[w] = ~(uint64_t)0;
+      alignment->mv[w] = 0;
+      alignment->bottom[w] = (w + 1) * WORD_BITS;
+    }
+    /* Rows past the arm are never matched */
+    uint64_t last_mask = rows % WORD_BITS == 0 ? ~(uint64_t)0 :
+                         ((uint64_t)1 << (rows % WORD_BITS)) - 1;
+    size_t used_words = rows == 0 ? 0 : (rows - 1) / WORD_BITS + 1;
+
+    /* Column 0: deleting the first i characters of the left arm. */
+    *left = MIN(max_edits, rows);
+    *right = 0;
+    *edits = *left;
+    int reached_bottom = rows <= max_edits;
+
+    size_t column = 0;
+    size_t last_column = MIN(right_available, rows + max_edits);
+    for(column = 1; column <= last_column; column++) {
+      char c = query_string[right_start + column - 1];
+      int h = 1;
+      for(w = 0; w < used_words; w++) {
+        uint64_t eq = match_mask(alignment->pattern + w * WORD_BITS, c);
+        if(w == used_words - 1) eq &= last_mask;
+        h = advance_word(&alignment->pv[w], &alignment->mv[w], eq, h);
+        alignment->bottom[w] += h;
+      }
+
+      /* Only cells within max_edits of the diagonal can be within max_edits */
+      size_t lo = column > max_edits ? column - max_edits : 0;
+      size_t hi = MIN(rows, column + max_edits);
+      int any = 0;
+      for(i = lo; i <= hi; i++) {
+        size_t value = cell(alignment, i, column);
+        if(value > max_edits) continue;
+        any = 1;
+        if(i == rows) reached_bottom = 1;
+        if(i + column > *left + *right ||
+           (i + column == *left + *right && value < *edits)) {
+          *left = i;
+          *right = column;
+          *edits = value;
+        }
+      }
+      if(!any) break;
+    }
+
+    /* A longer stretch of the left arm might have let it go further. */
+    if(!reached_bottom || rows == first) break;
+    num_words *= 2;
+  }
+
+  return 0;
+error:
+  return 1;
+}
+
+int edit_palindromes_foreach(char* query_string, size_t query_length,
+                             size_t max_edits, size_t min_length,
+                             EditPalindromeFunc_T palindrome_func, void* data)
+{
+  size_t* pal_radii = NULL;
+  struct Alignment alignment = {NULL, NULL, NULL, NULL, 0, 0};
+
+  check(palindrome_func, "Need a function to call on palindromes.");
+  if(query_length == 0) return 0;
+
+  pal_radii = manacher(query_string, query_length);
+  check(pal_radii, "Manacher's algorithm failed.");
+
+  size_t pos = 0;
+  for(pos = 1; pos < 2 * query_length; pos++) {
+    size_t first = FIRST(pos, pal_radii[pos]);
+    size_t last = LAST(pos, pal_radii[pos]);
+    size_t left = 0;
+    size_t right = 0;
+    size_t edits = 0;
+
+    if(max_edits > 0) {
+      int rc = extend(&alignment, query_string, query_length, first, last + 1,
+                      max_edits, &left, &right, &edits);
+      check(rc == 0, "Failed to extend palindrome at center %zu.", pos);
+    }
+
+    struct EditPalindrome palindrome;
+    palindrome.center = pos;
+    palindrome.start = first - left;
+    palindrome.length = last + 1 - first + left + right;
+    palindrome.edits = edits;
+    if(palindrome.length < min_length || palindrome.length == 0) continue;
+    if(palindrome_func(&palindrome, data) != 0) break;
+  }
+
+  free(pal_radii);
+  free(alignment.pattern);
+  free(alignment.pv);
+  free(alignment.mv);
+  free(alignment.bottom);
+  return 0;
+
+error:
+  if(pal_radii) free(pal_radii);
+  free(alignment.pattern);
+  free(alignment.pv);
+  free(alignment.mv);
+  free(alignment.bottom);
+  return 1;
+}
@@ -0,0 +1,76 @@
+#ifndef _edit_palindromes_H_
+#define _edit_palindromes_H_
+
+#include <stdlib.h>
+
+/* TYPES */
+
+/*
+ * An approximate palindrome found by edit_palindromes_foreach. It is
+ * query_string[start:start+length], using Python slice syntax, around the
+ * manacher center center. Its left arm, read out from the center, is within
+ * edits insertions, deletions and substitutions of its right arm, so the whole
+ * palindrome is within 2 * edits of its reverse.
+ *
+ * Members:
+ *  size_t center           :   Center, from 1 to 2 * query_length - 1
+ *  size_t start            :   Index of the first character
+ *  size_t length           :   Number of characters
+ *  size_t edits            :   Edit distance between the arms
+ */
+struct EditPalindrome {
+  size_t center;
+  size_t start;
+  size_t length;
+  size_t edits;
+};
+
+/*
+ * The function pointer type called for each palindrome found by
+ * edit_palindromes_foreach.
+ *
+ * Params:
+ *  const struct EditPalindrome* palindrome :   The palindrome found. Only
+ *                                              valid during the call.
+ *  void* data                              :   Pointer to caller data.
+ *
+ * Returns:
+ *  0 to continue the search, anything else to stop it.
+ */
+typedef int (*EditPalindromeFunc_T)(const struct EditPalindrome* palindrome,
+                                    void* data);
+
+/* FUNCTIONS */
+
+/*
+ * Find the longest palindrome at each center whose arms are within
+ * max_edits edits of each other, and call palindrome_func on those at least
+ * min_length long, in order of center.
+ *
+ * Matching a common prefix first never costs an edit, so each center starts
+ * from its exact palindrome from manacher. The rest of the left arm, reversed,
+ * is then aligned against the rest of the right arm with Myers' bit-parallel
+ * edit distance, 64 rows of the alignment per machine word. The alignment
+ * stops as soon as no cell within max_edits of the diagonal is within
+ * max_edits edits, and the longest pair of arm prefixes within max_edits is
+ * taken, with ties going to fewer edits. The left arm is first aligned 64
+ * characters at a time, and that is doubled whenever the alignment could use
+ * more.
+ *
+ * Params:
+ *  char* query_string                  :   String to be searched
+ *  size_t query_length                 :   Length of query_string, not
+ *                                          including null terminator
+ *  size_t max_edits                    :   Most edits between the arms
+ *  size_t min_length                   :   Shortest palindrome to report
+ *  EditPalindromeFunc_T palindrome_func:   Called on every palindrome
+ *  void* data                          :   Passed to palindrome_func
+ *
+ * Returns:
+ *  0 if the search completed or was stopped by palindrome_func, else 1.
+ */
+int edit_palindromes_foreach(char* query_string, size_t query_length,
+                             size_t max_edits, size_t min_length,
+                             EditPalindromeFunc_T palindrome_func, void* data);
+
+#endif
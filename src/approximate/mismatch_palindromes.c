@@ -0,0 +1,212 @@
+#include <stdlib.h>
+
+#include "mismatch_palindromes.h"
+
+#include "utils/dbg.h"
+
+#define MIN(A, B) ((A) < (B) ? A : B)
+
+/* The number of centers whose LCE queries are made together. */
+#define CENTER_BLOCK_SIZE 4096
+
+/*
+ * The palindrome of radius R at center C is query_string[FIRST:LAST+1]. An
+ * empty palindrome between two characters has LAST = FIRST - 1.
+ */
+#define FIRST(C, R) ((C) / 2 - (R))
+#define LAST(C, R) (((C) - 1) / 2 + (R))
+
+/* Whether the palindrome of radius R at center C has another pair around it. */
+#define HAS_PAIR(C, R, N) (FIRST(C, R) > 0 && LAST(C, R) + 1 < (N))
+
+size_t* mismatch_palindromes(char* query_string, size_t query_length,
+                             size_t max_mismatches)
+{
+  AugmentedString_T augmented_string = NULL;
+  size_t* pal_radii = NULL;
+
+  if(query_length == 0) {
+    pal_radii = calloc(1, sizeof(size_t));
+    check_mem(pal_radii);
+    return pal_radii;
+  }
+
+  augmented_string = AugmentedString_create_with_backend(
+      query_string, query_length, AUGMENTED_STRING_SUFFIX_ARRAY);
+  check(augmented_string, "Could not create augmented string.");
+
+  pal_radii = mismatch_palindromes_from_augmented_string(augmented_string,
+                                                         max_mismatches);
+  check(pal_radii, "Mismatch palindrome search failed.");
+
+  AugmentedString_delete(&augmented_string);
+  return pal_radii;
+
+error:
+  AugmentedString_delete(&augmented_string);
+  return NULL;
+}
+
+size_t* mismatch_palindromes_from_augmented_string(AugmentedString_T augmented_string,
+                                                   size_t max_mismatches)
+{
+  size_t* pal_radii = NULL;
+  size_t* active = NULL;
+  size_t* mismatches = NULL;
+  size_t* pairs = NULL;
+  size_t* lengths = NULL;
+
+  check(augmented_string, "Cannot search a NULL AugmentedString_T.");
+
+  size_t query_length = AugmentedString_get_query_length(augmented_string);
+  size_t pal_radii_length = 2 * query_length + 1;
+  /* Query character i is at 2 * query_length - i in the reverse. */
+  size_t reverse_end = 2 * query_length;
+
+  pal_radii = calloc(pal_radii_length, sizeof(size_t));
+  check_mem(pal_radii);
+  if(query_length == 0) return pal_radii;
+
+  active = malloc(CENTER_BLOCK_SIZE * sizeof(size_t));
+  check_mem(active);
+  mismatches = malloc(CENTER_BLOCK_SIZE * sizeof(size_t));
+  check_mem(mismatches);
+  pairs = malloc(2 * CENTER_BLOCK_SIZE * sizeof(size_t));
+  check_mem(pairs);
+  lengths = malloc(CENTER_BLOCK_SIZE * sizeof(size_t));
+  check_mem(lengths);
+
+  /* The first and last centers always have radius zero. */
+  size_t block_start = 1;
+  for(block_start = 1; block_start < pal_radii_length - 1;
+      block_start += CENTER_BLOCK_SIZE) {
+    size_t block_end = MIN(block_start + CENTER_BLOCK_SIZE, pal_radii_length - 1);
+    size_t num_active = 0;
+    size_t pos = 0;
+
+    for(pos = block_start; pos < block_end; pos++) {
+      mismatches[pos - block_start] = 0;
+      if(HAS_PAIR(pos, 0, query_length)) active[num_active++] = pos;
+    }
+
+    /* Each round jumps every active center over its next run of matching
+     * pairs, then spends a mismatch on the pair after it, if it has one and
+     * any mismatches to spend. */
+    while(num_active > 0) {
+      size_t i = 0;
+      for(i = 0; i < num_active; i++) {
+        pos = active[i];
+        pairs[2 * i] = LAST(pos, pal_radii[pos]) + 1;
+        pairs[2 * i + 1] = reverse_end - (FIRST(pos, pal_radii[pos]) - 1);
+      }
+      int rc = AugmentedString_lce_batch(augmented_string, pairs, num_active,
+                                         lengths);
+      check(rc == 0, "LCE lookups failed.");
+
+      size_t num_still_active = 0;
+      for(i = 0; i < num_active; i++) {
+        pos = active[i];
+        size_t radius = pal_radii[pos] + lengths[i];
+        if(HAS_PAIR(pos, radius, query_length) &&
+           mismatches[pos - block_start] < max_mismatches) {
+          mismatches[pos - block_start]++;
+          radius++;
+          if(HAS_PAIR(pos, radius, query_length)) active[num_still_active++] = pos;
+        }
+        pal_radii[pos] = radius;
+      }
+      num_active = num_still_active;
+    }
+  }
+
+  free(active);
+  free(mismatches);
+  free(pairs);
+  free(lengths);
+  return pal_radii;
+
+error:
+  if(active) free(active);
+  if(mismatches) free(mismatches);
+  if(pairs) free(pairs);
+  if(lengths) free(lengths);
+  if(pal_radii) free(pal_radii);
+  return NULL;
+}
+
+size_t* mismatch_palindromes_packed(PackedSequence_T sequence, size_t max_mismatches)
+{
+  check(sequence, "Cannot search a NULL PackedSequence_T.");
+
+  size_t query_length = PackedSequence_get_length(sequence);
+  size_t* pal_radii = calloc(2 * query_length + 1, sizeof(size_t));
+  check_mem(pal_radii);
+
+  size_t pos = 0;
+  for(pos = 1; pos < 2 * query_length; pos++) {
+    size_t radius = 0;
+    size_t mismatches = 0;
+    while(1) {
+      radius += PackedSequence_extend_arms(sequence, FIRST(pos, radius),
+                                           LAST(pos, radius));
+      if(!HAS_PAIR(pos, radius, query_length) || mismatches == max_mismatches) break;
+      mismatches++;
+      radius++;
+    }
+    pal_radii[pos] = radius;
+  }
+
+  return pal_radii;
+
+error:
+  return NULL;
+}
+
+int verify_mismatch_palindrome_radii(char* query_string, size_t query_length,
+                                     size_t max_mismatches, size_t* pal_radii)
+{
+  size_t pos = 0;
+
+  if(pal_radii[0] != 0 || pal_radii[2 * query_length] != 0) {
+    log_warn("First and last elements should be zero.");
+    return 1;
+  }
+
+  for(pos = 1; pos < 2 * query_length; pos++) {
+    size_t radius = pal_radii[pos];
+    size_t num_mismatches = 0;
+    size_t i = 0;
+
+    if(radius > pos / 2 || LAST(pos, radius) >= query_length) {
+      log_warn("Palindrome centered at %zu with radius %zu runs off the string.",
+               pos, radius);
+      return 1;
+    }
+
+    for(i = 0; i < radius; i++) {
+      num_mismatches += query_string[FIRST(pos, i) - 1] !=
+                        query_string[LAST(pos, i) + 1];
+    }
+    if(num_mismatches > max_mismatches) {
+      log_warn("Palindrome centered at %zu with radius %zu has %zu mismatches.",
+               pos, radius, num_mismatches);
+      return 1;
+    }
+
+    /* It can't be extended: the string ends, or the next pair is one
+     * mismatch too many. */
+    if(HAS_PAIR(pos, radius, query_length) && num_mismatches < max_mismatches) {
+      log_warn("Palindrome centered at %zu with radius %zu is not maximal.",
+               pos, radius);
+      return 1;
+    }
+    if(HAS_PAIR(pos, radius, query_length) &&
+       query_string[FIRST(pos, radius) - 1] == query_string[LAST(pos, radius) + 1]) {
+      log_warn("Palindrome centered at %zu with radius %zu is not maximal.",
+               pos, radius);
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef _mismatch_palindromes_H_
+#define _mismatch_palindromes_H_
+
+#include <stdlib.h>
+#include "kolpakov_kucherov/augmented_string.h"
+#include "packed/packed_sequence.h"
+
+/*
+ * Find the longest palindrome with at most max_mismatches mismatches at each
+ * center of a string. Centers and radii are as in manacher: there are
+ * 2 * query_length + 1 centers, and the radius is the number of pairs of
+ * characters on either side of the center, so that a palindrome at an odd
+ * center has 2 * radius + 1 characters and one at an even center has
+ * 2 * radius. A pair whose characters differ is a mismatch, and each
+ * palindrome is extended until the next pair would be one too many
+ * mismatches, or the string ends.
+ *
+ * Each run of matching pairs is jumped in one longest common extension query
+ * between the string and its reverse, so a center takes at most
+ * max_mismatches + 1 queries, and the whole search O(n * max_mismatches).
+ * The queries for a block of centers are made together, one round per
+ * mismatch.
+ *
+ * The string must not contain '#', which separates it from its reverse.
+ *
+ * Input:
+ *    char* query_string      :   String to be search for palindromes
+ *    size_t query_length     :   Length of query_string, not including null
+ *                                terminator
+ *    size_t max_mismatches   :   Most mismatched pairs in a palindrome
+ *
+ * Output:
+ *    size_t* pal_radii       :   Radius of the longest palindrome at each
+ *                                possible center, or NULL on failure
+ */
+size_t* mismatch_palindromes(char* query_string, size_t query_length,
+                             size_t max_mismatches);
+
+/*
+ * Like mismatch_palindromes, but with an AugmentedString_T of the query that
+ * has already been built, so that it can be searched with several values of
+ * max_mismatches.
+ */
+size_t* mismatch_palindromes_from_augmented_string(AugmentedString_T augmented_string,
+                                                   size_t max_mismatches);
+
+/*
+ * Like mismatch_palindromes, but on a packed DNA sequence, with N equal only
+ * to N. Each run of matching pairs is jumped by comparing 32 bases a word
+ * instead of by an LCE query, so there is no index to build. That is faster
+ * unless runs of matching pairs are very long.
+ */
+size_t* mismatch_palindromes_packed(PackedSequence_T sequence, size_t max_mismatches);
+
+/*
+ * Check that each radius is that of a palindrome with at most max_mismatches
+ * mismatches that can't be extended any further.
+ *
+ * Output:
+ *    int ret_code          :   0 if all palindromes are correct, otherwise 1
+ */
+int     verify_mismatch_palindrome_radii(char* query_string, size_t query_length,
+                                         size_t max_mismatches, size_t* pal_radii);
+
+#endif
@@ -0,0 +1,262 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "eertree.h"
+
+#include "utils/dbg.h"
+
+/* The roots. Palindrome number i is node i + FIRST_PALINDROME. */
+#define IMAGINARY_ROOT 0
+#define EMPTY_ROOT 1
+#define FIRST_PALINDROME 2
+
+/* The imaginary root is never anyone's child, so 0 also means no node in the
+ * edge lists. */
+#define NO_CHILD 0
+
+struct EertreeNode {
+  uint32_t length;
+  uint32_t suffix_link;
+  /* The edges out of a node are a list through its children */
+  uint32_t first_child;
+  uint32_t next_sibling;
+  /* The number of positions where this is the longest palindrome ending */
+  uint32_t count;
+  uint32_t first_end;
+  char     letter;
+};
+
+struct Eertree_T {
+  struct EertreeNode* nodes;
+  uint32_t            num_nodes;
+  uint32_t            num_nodes_allocated;
+
+  char*               str;
+  /* The longest palindrome ending at each position of str */
+  uint32_t*           suffix_nodes;
+  size_t              length;
+  size_t              num_allocated;
+
+  /* The longest palindromic suffix of str */
+  uint32_t            last;
+
+  /* The number of occurrences of each node, totaled on demand */
+  uint32_t*           totals;
+  int                 totals_current;
+};
+
+static uint32_t get_child(const Eertree_T tree, uint32_t node, char c)
+{
+  uint32_t child = tree->nodes[node].first_child;
+  while(child != NO_CHILD && tree->nodes[child].letter != c) {
+    child = tree->nodes[child].next_sibling;
+  }
+  return child;
+}
+
+/*
+ * Follow suffix links from node to the first palindrome X such that cXc ends
+ * at position, which is at worst the imaginary root.
+ */
+static uint32_t find_extendable(const Eertree_T tree, uint32_t node,
+                                size_t position, char c)
+{
+  while(node != IMAGINARY_ROOT) {
+    size_t length = tree->nodes[node].length;
+    if(position > length && tree->str[position - length - 1] == c) break;
+    node = tree->nodes[node].suffix_link;
+  }
+  return node;
+}
+
+/* Make room for one more character and one more node. */
+static int reserve(Eertree_T tree)
+{
+  check(tree->length < UINT32_MAX - 1, "Eertree_T strings are limited to %u characters.",
+        UINT32_MAX - 1);
+
+  if(tree->length == tree->num_allocated) {
+    size_t new_num_allocated = tree->num_allocated ? 2 * tree->num_allocated : 64;
+    char* tmp_str = realloc(tree->str, new_num_allocated * sizeof(char));
+    check_mem(tmp_str);
+    tree->str = tmp_str;
+    uint32_t* tmp_suffix_nodes = realloc(tree->suffix_nodes,
+                                         new_num_allocated * sizeof(uint32_t));
+    check_mem(tmp_suffix_nodes);
+    tree->suffix_nodes = tmp_suffix_nodes;
+    tree->num_allocated = new_num_allocated;
+  }
+
+  if(tree->num_nodes == tree->num_nodes_allocated) {
+    uint32_t new_num_allocated = tree->num_nodes_allocated < UINT32_MAX / 2 ?
+                                 2 * tree->num_nodes_allocated : UINT32_MAX;
+    struct EertreeNode* tmp_nodes = realloc(tree->nodes, new_num_allocated *
+                                            sizeof(struct EertreeNode));
+    check_mem(tmp_nodes);
+    tree->nodes = tmp_nodes;
+    tree->num_nodes_allocated = new_num_allocated;
+  }
+
+  return 0;
+error:
+  return 1;
+}
+
+Eertree_T Eertree_create(const char* str, size_t str_length)
+{
+  Eertree_T tree = NULL;
+  size_t i = 0;
+
+  tree = calloc(1, sizeof(struct Eertree_T));
+  check_mem(tree);
+
+  tree->num_nodes_allocated = 16;
+  tree->nodes = calloc(tree->num_nodes_allocated, sizeof(struct EertreeNode));
+  check_mem(tree->nodes);
+
+  /* Both roots link to the imaginary root, which can extend by anything. */
+  tree->nodes[IMAGINARY_ROOT].suffix_link = IMAGINARY_ROOT;
+  tree->nodes[EMPTY_ROOT].suffix_link = IMAGINARY_ROOT;
+  tree->num_nodes = FIRST_PALINDROME;
+  tree->last = EMPTY_ROOT;
+
+  for(i = 0; i < str_length; i++) {
+    int rc = Eertree_append(tree, str[i]);
+    check(rc == 0, "Failed to append character %zu.", i);
+  }
+
+  return tree;
+
+error:
+  Eertree_delete(&tree);
+  return NULL;
+}
+
+void Eertree_delete(Eertree_T* tree)
+{
+  if(!tree || !*tree) return;
+  if((*tree)->nodes) free((*tree)->nodes);
+  if((*tree)->str) free((*tree)->str);
+  if((*tree)->suffix_nodes) free((*tree)->suffix_nodes);
+  if((*tree)->totals) free((*tree)->totals);
+  free(*tree);
+  *tree = NULL;
+}
+
+int Eertree_append(Eertree_T tree, char c)
+{
+  check(tree, "Cannot append to a NULL Eertree_T.");
+  int rc = reserve(tree);
+  check(rc == 0, "Failed to make room in the Eertree_T.");
+
+  size_t position = tree->length;
+  tree->str[position] = c;
+
+  uint32_t parent = find_extendable(tree, tree->last, position, c);
+  uint32_t node = get_child(tree, parent, c);
+
+  if(node == NO_CHILD) {
+    node = tree->num_nodes++;
+    struct EertreeNode* new_node = &tree->nodes[node];
+    new_node->letter = c;
+    new_node->count = 0;
+    new_node->first_end = position;
+    new_node->first_child = NO_CHILD;
+
+    if(parent == IMAGINARY_ROOT) {
+      new_node->length = 1;
+      new_node->suffix_link = EMPTY_ROOT;
+    } else {
+      new_node->length = tree->nodes[parent].length + 2;
+      uint32_t link_parent = find_extendable(tree, tree->nodes[parent].suffix_link,
+                                             position, c);
+      new_node->suffix_link = get_child(tree, link_parent, c);
+    }
+
+    new_node->next_sibling = tree->nodes[parent].first_child;
+    tree->nodes[parent].first_child = node;
+  }
+
+  tree->nodes[node].count++;
+  tree->suffix_nodes[position] = node;
+  tree->last = node;
+  tree->length++;
+  tree->totals_current = 0;
+
+  return 0;
+error:
+  return 1;
+}
+
+size_t Eertree_get_length(Eertree_T tree)
+{
+  return tree->length;
+}
+
+size_t Eertree_get_num_palindromes(Eertree_T tree)
+{
+  return tree->num_nodes - FIRST_PALINDROME;
+}
+
+size_t Eertree_get_palindrome_length(Eertree_T tree, size_t palindrome)
+{
+  return tree->nodes[palindrome + FIRST_PALINDROME].length;
+}
+
+size_t Eertree_get_first_start(Eertree_T tree, size_t palindrome)
+{
+  struct EertreeNode* node = &tree->nodes[palindrome + FIRST_PALINDROME];
+  return node->first_end + 1 - node->length;
+}
+
+size_t Eertree_get_count(Eertree_T tree, size_t palindrome)
+{
+  if(!tree->totals_current) {
+    uint32_t* tmp_totals = realloc(tree->totals, tree->num_nodes * sizeof(uint32_t));
+    check_mem(tmp_totals);
+    tree->totals = tmp_totals;
+
+    /* A palindrome occurs wherever it or a palindrome it's a suffix of is the
+     * longest one ending, and suffix links always point to earlier nodes. */
+    uint32_t node = 0;
+    for(node = 0; node < tree->num_nodes; node++) {
+      tree->totals[node] = tree->nodes[node].count;
+    }
+    for(node = tree->num_nodes - 1; node >= FIRST_PALINDROME; node--) {
+      tree->totals[tree->nodes[node].suffix_link] += tree->totals[node];
+    }
+    tree->totals_current = 1;
+  }
+
+  return tree->totals[palindrome + FIRST_PALINDROME];
+
+error:
+  return 0;
+}
+
+size_t Eertree_get_longest_suffix(Eertree_T tree, size_t position)
+{
+  return tree->suffix_nodes[position] - FIRST_PALINDROME;
+}
+
+int Eertree_find(Eertree_T tree, const char* palindrome, size_t length,
+                 size_t* index)
+{
+  size_t i = 0;
+  if(length == 0) return 0;
+
+  for(i = 0; i < length / 2; i++) {
+    if(palindrome[i] != palindrome[length - 1 - i]) return 0;
+  }
+
+  /* Grow the palindrome out from its middle, one edge per character of its
+   * right half. */
+  uint32_t node = length % 2 == 1 ? IMAGINARY_ROOT : EMPTY_ROOT;
+  for(i = length / 2; i < length; i++) {
+    node = get_child(tree, node, palindrome[i]);
+    if(node == NO_CHILD) return 0;
+  }
+
+  *index = node - FIRST_PALINDROME;
+  return 1;
+}
@@ -0,0 +1,84 @@
+#ifndef _eertree_H_
+#define _eertree_H_
+
+#include <stdlib.h>
+
+/* TYPES */
+
+/*
+ * An Eertree_T, or palindromic tree, has a node for each distinct palindrome
+ * in a string, and is built online a character at a time in linear time. Each
+ * node has an edge labeled c to the palindrome cXc for its own palindrome X,
+ * and a suffix link to its longest proper palindromic suffix. Two roots stand
+ * for the empty palindrome and for an imaginary one of length -1, whose child
+ * on c is the single character c.
+ *
+ * The palindromes are numbered from 0 in the order they first end in the
+ * string. Nodes are 32-bit indices with edges kept in lists, around 28 bytes
+ * apiece, and the tree also keeps a copy of the string and the longest
+ * palindromic suffix ending at each position, so about 5 bytes per character
+ * on top of the nodes. Strings are limited to UINT32_MAX - 1 characters.
+ */
+typedef struct Eertree_T* Eertree_T;
+
+/* FUNCTIONS */
+
+/*
+ * Create an Eertree_T for the first str_length characters of str. str is
+ * copied, and can be empty.
+ *
+ * Returns:
+ *  Eertree_T tree, or NULL on failure.
+ */
+Eertree_T Eertree_create(const char* str, size_t str_length);
+
+/* Delete an Eertree_T, freeing all its memory. */
+void      Eertree_delete(Eertree_T* tree);
+
+/*
+ * Add a character to the end of the string of an Eertree_T.
+ *
+ * Returns:
+ *  0 on success, else 1. On failure the tree is unchanged.
+ */
+int       Eertree_append(Eertree_T tree, char c);
+
+/* The length of the string so far. */
+size_t    Eertree_get_length(Eertree_T tree);
+
+/* The number of distinct non-empty palindromes in the string. */
+size_t    Eertree_get_num_palindromes(Eertree_T tree);
+
+/* The length of palindrome number palindrome. */
+size_t    Eertree_get_palindrome_length(Eertree_T tree, size_t palindrome);
+
+/* The position in the string where palindrome number palindrome first starts. */
+size_t    Eertree_get_first_start(Eertree_T tree, size_t palindrome);
+
+/*
+ * The number of times palindrome number palindrome occurs in the string,
+ * counting overlapping occurrences. The first call after the string changes
+ * totals the counts of every palindrome, which takes time linear in the number
+ * of palindromes.
+ */
+size_t    Eertree_get_count(Eertree_T tree, size_t palindrome);
+
+/* The number of the longest palindrome that ends at position in the string. */
+size_t    Eertree_get_longest_suffix(Eertree_T tree, size_t position);
+
+/*
+ * Look up a palindrome by its characters.
+ *
+ * Params:
+ *  Eertree_T tree          :   Tree to search
+ *  const char* palindrome  :   Characters of the palindrome
+ *  size_t length           :   Number of characters, at least 1
+ *  size_t* index           :   Set to the number of the palindrome if found
+ *
+ * Returns:
+ *  1 if the characters are a palindrome that occurs in the string, else 0.
+ */
+int       Eertree_find(Eertree_T tree, const char* palindrome, size_t length,
+                       size_t* index);
+
+#endif
@@ -1,75 +1,150 @@
 #include "augmented_string.h"
 
 #include "utils/dbg.h"
-#include "lca/lca_suffix_tree.h"
+#include "utils/mapped_file.h"
 
 #define QPR_LENGTH(A) (2*(A)+2)
 
 struct AugmentedString_T {
-  LCASuffixTree_T tree;
-  Node_T* leaf_array;
+  enum AugmentedStringBackend backend;
+  /* Set with the suffix tree backend */
+  SuffixTree_T tree;
+  /* The query, '#' and the reversed query, which the tree borrows. */
+  char* tree_buffer;
+  /* Set with the suffix array backend */
+  SuffixArray_T suffix_array;
+  /* LCE queries by position. The suffix array owns its own. */
+  LCE_T lce;
   size_t query_length;
   size_t augmented_length;
 };
 
 AugmentedString_T AugmentedString_create(char* query_string, size_t query_length)
+{
+  return AugmentedString_create_with_backend(query_string, query_length,
+                                             AUGMENTED_STRING_SUFFIX_TREE);
+}
+
+AugmentedString_T AugmentedString_create_with_backend(
+                      char* query_string,
+                      size_t query_length,
+                      enum AugmentedStringBackend backend)
+{
+  return AugmentedString_create_mapped(query_string, query_string, query_length,
+                                       backend);
+}
+
+AugmentedString_T AugmentedString_create_mapped(
+                      const char* left_string,
+                      const char* right_string,
+                      size_t query_length,
+                      enum AugmentedStringBackend backend)
 {
   AugmentedString_T augmented_string = NULL;
-  char* query_and_reverse = NULL;
-  LCASuffixTree_T tree = NULL;
-  Node_T* leaf_array = NULL;
+  char* buffer = NULL;
+
+  check(backend == AUGMENTED_STRING_SUFFIX_TREE ||
+        backend == AUGMENTED_STRING_SUFFIX_ARRAY,
+        "Unknown augmented string backend %d.", backend);
 
   augmented_string = calloc(1, sizeof(struct AugmentedString_T));
   check_mem(augmented_string);
+  augmented_string->backend = backend;
+  augmented_string->query_length = query_length;
+  augmented_string->augmented_length = QPR_LENGTH(query_length) - 1;
 
-  query_and_reverse = malloc(QPR_LENGTH(query_length) * sizeof(char));
-  check_mem(query_and_reverse);
+  /* A suffix tree is built in place in a buffer with room for a character
+   * before the string, so the query and its reverse are written straight
+   * into it. */
+  size_t offset = backend == AUGMENTED_STRING_SUFFIX_TREE ? 1 : 0;
+  buffer = malloc(SUFFIX_TREE_BUFFER_LENGTH(augmented_string->augmented_length) *
+                  sizeof(char));
+  check_mem(buffer);
+  char* query_and_reverse = buffer + offset;
 
-  strncpy(query_and_reverse, query_string, query_length);
+  memcpy(query_and_reverse, right_string, query_length);
   query_and_reverse[query_length] = '#';
 
   size_t i = 0;
   for(i = 0; i < query_length; i++) {
-    query_and_reverse[query_length + 1 + i] = query_string[query_length - 1 - i];
+    query_and_reverse[query_length + 1 + i] = left_string[query_length - 1 - i];
   }
-  query_and_reverse[QPR_LENGTH(query_length) - 1] = '\0';
 
-  tree = LCASuffixTree_create(query_and_reverse, QPR_LENGTH(query_length) - 1);
-  augmented_string->tree = tree;
-  check(tree, "Could not create suffix tree for the query string.");
-  
-  leaf_array = SuffixTree_create_leaf_array((SuffixTree_T)tree);
-  augmented_string->leaf_array = leaf_array;
-  check(leaf_array, "Could not create leaf array for the query string.");
+  if(backend == AUGMENTED_STRING_SUFFIX_ARRAY) {
+    augmented_string->suffix_array = SuffixArray_create(
+        query_and_reverse, augmented_string->augmented_length);
+    /* The suffix array has what it needs of the full string. */
+    free(buffer);
+    buffer = NULL;
+    check(augmented_string->suffix_array,
+          "Could not create suffix array for the query string.");
+    augmented_string->lce = SuffixArray_get_lce(augmented_string->suffix_array);
+  } else {
+    augmented_string->tree_buffer = buffer;
+    buffer = NULL;
+    augmented_string->tree = SuffixTree_create_borrowed(
+        augmented_string->tree_buffer, augmented_string->augmented_length);
+    check(augmented_string->tree, "Could not create suffix tree for the query string.");
+
+    augmented_string->lce = LCE_create_from_suffix_tree(augmented_string->tree);
+    check(augmented_string->lce, "Could not create LCE table for the query string.");
+  }
 
-  augmented_string->query_length = query_length;
-  augmented_string->augmented_length = QPR_LENGTH(query_length) - 1;
-  
-  /* The suffix tree has a copy of the full string. */
-  free(query_and_reverse);
-  
-  return augmented_string; 
+  return augmented_string;
 
 error:
-  if(augmented_string) free(augmented_string);
-  if(query_and_reverse) free(query_and_reverse);
-  if(leaf_array) free(leaf_array);
-  LCASuffixTree_delete(&tree);
+  if(buffer) free(buffer);
+  AugmentedString_delete(&augmented_string);
 
   return NULL;
 }
 
+AugmentedString_T AugmentedString_create_from_file(
+                      const char* path,
+                      enum AugmentedStringBackend backend)
+{
+  MappedFile_T file = MappedFile_open(path);
+  check(file, "Could not map %s.", path);
+
+  AugmentedString_T augmented_string = AugmentedString_create_with_backend(
+      MappedFile_get_data(file), MappedFile_get_length(file), backend);
+  MappedFile_close(&file);
+  return augmented_string;
+
+error:
+  return NULL;
+}
+
 void AugmentedString_delete(AugmentedString_T* aug_string)
 {
   if(!aug_string) return;
-  
+
   if(*aug_string) {
-    LCASuffixTree_delete(&(*aug_string)->tree);
-    if((*aug_string)->leaf_array) free((*aug_string)->leaf_array);
+    SuffixTree_delete(&(*aug_string)->tree);
+    if((*aug_string)->tree_buffer) free((*aug_string)->tree_buffer);
+    if((*aug_string)->suffix_array) {
+      SuffixArray_delete(&(*aug_string)->suffix_array);
+    } else {
+      LCE_delete(&(*aug_string)->lce);
+    }
     free(*aug_string);
+    *aug_string = NULL;
   }
 }
 
+size_t AugmentedString_lce(AugmentedString_T augmented_string,
+                           size_t pos1, size_t pos2)
+{
+  return LCE_lookup(augmented_string->lce, pos1, pos2);
+}
+
+int AugmentedString_lce_batch(AugmentedString_T augmented_string,
+                              const size_t* pairs, size_t num_pairs,
+                              size_t* lengths)
+{
+  return LCE_lookup_batch(augmented_string->lce, pairs, num_pairs, lengths);
+}
+
 size_t AugmentedString_common_prefix_suffix_length(
                        AugmentedString_T augmented_string,
                        size_t left_pos,
@@ -77,23 +152,31 @@ size_t AugmentedString_common_prefix_suffix_length(
 {
   size_t adjusted_left_pos = augmented_string->augmented_length - left_pos - 1;
 
-  Node_T node1 = augmented_string->leaf_array[adjusted_left_pos];
-  Node_T node2 = augmented_string->leaf_array[right_pos];
-
-  printf("Node1: %zu Node2: %zu\n", Node_get_index(node1), Node_get_index(node2));
+  /* This has always been the depth of the deepest common ancestor of two
+   * leaves, and the depth of a leaf counts the tree's terminator. */
+  if(adjusted_left_pos == right_pos) {
+    return augmented_string->augmented_length - right_pos + 1;
+  }
 
-  Node_T lca = LCASuffixTree_get_lca(augmented_string->tree, node1, node2);
-  
-  printf("LCA: %zu\n", Node_get_index(lca));
+  return LCE_lookup(augmented_string->lce, adjusted_left_pos, right_pos);
+}
 
-  return Node_get_edge_depth(lca);
+enum AugmentedStringBackend AugmentedString_get_backend(
+                      AugmentedString_T augmented_string)
+{
+  return augmented_string->backend;
 }
 
-LCASuffixTree_T AugmentedString_get_tree(AugmentedString_T augmented_string)
+SuffixTree_T AugmentedString_get_tree(AugmentedString_T augmented_string)
 {
   return augmented_string->tree;
 }
 
+SuffixArray_T AugmentedString_get_suffix_array(AugmentedString_T augmented_string)
+{
+  return augmented_string->suffix_array;
+}
+
 size_t AugmentedString_get_query_length(AugmentedString_T augmented_string)
 {
   return augmented_string->query_length;
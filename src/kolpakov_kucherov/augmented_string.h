@@ -1,24 +1,104 @@
 #ifndef _augmented_string_H_
 #define _augmented_string_H_
 
-#include "lca/lca_suffix_tree.h"
+#include "lca/lce.h"
+#include "suffix_tree/suffix_tree.h"
+#include "suffix_array/suffix_array.h"
 #include <stdlib.h>
 
 /* TYPES */
 
 typedef struct AugmentedString_T* AugmentedString_T;
 
+/*
+ * The index built over the query string and its reverse. Both answer the
+ * same queries, but a suffix array takes a small fraction of the memory of a
+ * suffix tree.
+ */
+enum AugmentedStringBackend {
+  AUGMENTED_STRING_SUFFIX_TREE,
+  AUGMENTED_STRING_SUFFIX_ARRAY
+};
 
+/*
+ * Create an augmented string indexed by a suffix tree, which takes a query of
+ * any length that fits in memory.
+ */
 AugmentedString_T AugmentedString_create(char* query_string, size_t query_length);
 
+/*
+ * Create an augmented string indexed by the given backend. The augmented
+ * string is 2 * query_length + 1 characters, and the suffix array indexes it
+ * in 32 bits, so with AUGMENTED_STRING_SUFFIX_ARRAY query_length must be less
+ * than 2^31 - 1. The suffix tree backend has no limit.
+ */
+AugmentedString_T AugmentedString_create_with_backend(
+                      char* query_string,
+                      size_t query_length,
+                      enum AugmentedStringBackend backend);
+
+/*
+ * Create an augmented string whose query is right_string and whose reverse is
+ * the reverse of left_string, both query_length long. With a string mapped
+ * for each arm of a relation, as by Relation_map_string, LCEs between the
+ * query and the reverse pair characters under that relation.
+ */
+AugmentedString_T AugmentedString_create_mapped(
+                      const char* left_string,
+                      const char* right_string,
+                      size_t query_length,
+                      enum AugmentedStringBackend backend);
+
+/*
+ * Create an augmented string of the contents of a file. The file is mapped
+ * rather than read. With AUGMENTED_STRING_SUFFIX_TREE the query and its
+ * reverse are written straight into the buffer of the suffix tree, so the
+ * index is the only copy held, and the file can be of any length. With
+ * AUGMENTED_STRING_SUFFIX_ARRAY the file must be shorter than 2^31 - 1
+ * characters, not counting a trailing newline.
+ */
+AugmentedString_T AugmentedString_create_from_file(
+                      const char* path,
+                      enum AugmentedStringBackend backend);
+
 void              AugmentedString_delete(AugmentedString_T* augmented_string);
 
+/*
+ * The number of characters the suffixes of the augmented string at pos1 and
+ * pos2 have in common. Positions below the query length are in the query,
+ * the query length is the separator, and the reverse of the query follows.
+ * Lookups don't touch the suffix tree, and they are safe to make from several
+ * threads at once.
+ */
+size_t            AugmentedString_lce(AugmentedString_T augmented_string,
+                                      size_t pos1, size_t pos2);
+
+/*
+ * AugmentedString_lce for many pairs of positions at once, which is faster
+ * when there are many. pairs holds 2 * num_pairs positions, and lengths gets
+ * num_pairs answers.
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+int               AugmentedString_lce_batch(AugmentedString_T augmented_string,
+                                            const size_t* pairs,
+                                            size_t num_pairs,
+                                            size_t* lengths);
+
 size_t            AugmentedString_common_prefix_suffix_length(
                       AugmentedString_T augmented_string,
                       size_t left_pos,
                       size_t right_pos);
 
-LCASuffixTree_T   AugmentedString_get_tree(AugmentedString_T augmented_string);
+enum AugmentedStringBackend AugmentedString_get_backend(
+                      AugmentedString_T augmented_string);
+
+/* The suffix tree of a string with the suffix tree backend, else NULL. */
+SuffixTree_T      AugmentedString_get_tree(AugmentedString_T augmented_string);
+
+/* The suffix array of a string with the suffix array backend, else NULL. */
+SuffixArray_T     AugmentedString_get_suffix_array(AugmentedString_T augmented_string);
 
 size_t            AugmentedString_get_query_length(AugmentedString_T augmented_string);
 
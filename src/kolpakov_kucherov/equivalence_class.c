@@ -93,8 +93,9 @@ size_t* annotate_substr_classes(size_t str_length, size_t substr_length,
   dfs_data->substr_classes = calloc(1, str_length * sizeof(size_t));
   check_mem(dfs_data->substr_classes);
    
-  SuffixTree_walk(stree, SuffixTree_get_root(stree), annotate_substr_node_func,
-                  dfs_data, 0);
+  int rc = SuffixTree_walk(stree, SuffixTree_get_root(stree),
+                           annotate_substr_node_func, dfs_data, 0);
+  check(rc == 0, "Walk of the suffix tree failed.");
 
   size_t* substr_classes = dfs_data->substr_classes;
   free(dfs_data->class_label);
@@ -111,6 +112,52 @@ error:
   return NULL;
 }
 
+/*
+ * Like annotate_substr_classes, but with a suffix array instead of a suffix
+ * tree. Suffixes whose first substr_length characters are equal sit next to
+ * each other in the suffix array, so a scan in rank order starts a new class
+ * whenever the LCP with the previous suffix drops below substr_length.
+ *
+ * Inputs:
+ *    size_t substr_length        :   Length of substrings used to assign class
+ *                                    ids
+ *    SuffixArray_T suffix_array  :   Suffix array of the string
+ *
+ * Outputs:
+ *    size_t* substr_classes  :   Array with an id for each position in the
+ *                                string
+ */
+size_t* annotate_substr_classes_with_suffix_array(size_t substr_length,
+                                                  const SuffixArray_T suffix_array)
+{
+  size_t str_length = SuffixArray_get_length(suffix_array);
+  size_t* substr_classes = calloc(str_length + 1, sizeof(size_t));
+  check_mem(substr_classes);
+
+  size_t class_label = 0;
+  int new_class = 1;
+  size_t rank = 0;
+  for(rank = 0; rank < str_length; rank++) {
+    if(SuffixArray_get_lcp(suffix_array, rank) < substr_length) {
+      new_class = 1;
+    }
+
+    size_t suffix_start = SuffixArray_get_suffix(suffix_array, rank);
+    if(str_length - suffix_start >= substr_length) {
+      if(new_class) {
+        class_label++;
+        new_class = 0;
+      }
+      substr_classes[suffix_start] = class_label;
+    }
+  }
+
+  return substr_classes;
+
+error:
+  return NULL;
+}
+
 /*
  * Test the substring classes found by annotate_substr_classes. Check that
  * every pair of identical substrings has the same class id and every pair of
@@ -225,10 +272,16 @@ Table_T EquivClassTable_create(AugmentedString_T augmented_string,
   size_t query_length = AugmentedString_get_query_length(augmented_string);
   table->query_length = query_length;
 
-  substr_classes = annotate_substr_classes(
-      AugmentedString_get_augmented_length(augmented_string),
-      substr_length,
-      (SuffixTree_T)AugmentedString_get_tree(augmented_string));
+  if(AugmentedString_get_backend(augmented_string) == AUGMENTED_STRING_SUFFIX_ARRAY) {
+    substr_classes = annotate_substr_classes_with_suffix_array(
+        substr_length,
+        AugmentedString_get_suffix_array(augmented_string));
+  } else {
+    substr_classes = annotate_substr_classes(
+        AugmentedString_get_augmented_length(augmented_string),
+        substr_length,
+        AugmentedString_get_tree(augmented_string));
+  }
   check(substr_classes, "Failed annotation of substring equivalence classes.");
 
 
@@ -238,12 +291,16 @@ Table_T EquivClassTable_create(AugmentedString_T augmented_string,
   table->reverse_classes = calloc(query_length + 1, sizeof(Index_T));
   check_mem(table->reverse_classes);
 
-  memcpy(table->forward_classes, substr_classes,
-         sizeof(Index_T)*(query_length - substr_length + 1));
+  /* A string shorter than substr_length has no substrings to classify, and
+   * every position keeps the class 0 of no substring. */
+  if(substr_length <= query_length) {
+    memcpy(table->forward_classes, substr_classes,
+           sizeof(Index_T)*(query_length - substr_length + 1));
 
-  size_t i = 0;
-  for(i = 0; i < query_length - substr_length + 1; i++) {
-    (table->reverse_classes)[query_length - i] = substr_classes[query_length + i + 1];
+    size_t i = 0;
+    for(i = 0; i < query_length - substr_length + 1; i++) {
+      (table->reverse_classes)[query_length - i] = substr_classes[query_length + i + 1];
+    }
   }
   
   free(substr_classes);
@@ -9,17 +9,13 @@
 #define List_T  EquivClassList_T
 #define Array_T EquivClassArray_T
 
-#define STARTING_NEXT_RUN_COUNT 10
-
 /* PRIVATE TYPES */
 typedef struct List_T {
   size_t length;
   Item_T first_item;
   Item_T last_item;
   Item_T previous_start_item;
-  Item_T* next_run_ptrs;
-  size_t num_runs;
-  size_t num_allocated_runs;
+  Item_T run_start_item;
 }* List_T;
 
 struct Array_T {
@@ -41,12 +37,11 @@ List_T EquivClassList_set_new_run(List_T list, Item_T item);
 void EquivClassList_init(List_T* list)
 {
   *list = malloc(sizeof(struct List_T));
+  (*list)->length = 0;
   (*list)->first_item = NULL;
   (*list)->last_item = NULL;
   (*list)->previous_start_item = NULL;
-  (*list)->next_run_ptrs = calloc(STARTING_NEXT_RUN_COUNT, sizeof(Item_T));
-  (*list)->num_allocated_runs = STARTING_NEXT_RUN_COUNT;
-  (*list)->num_runs = 0;
+  (*list)->run_start_item = NULL;
 }
 
 /* Delete a List_T and all its items. */
@@ -60,7 +55,6 @@ void EquivClassList_delete(List_T* list)
     free(item);
     item = next_item; 
   }
-  free((*list)->next_run_ptrs);
   free(*list);
 
 error:
@@ -75,10 +69,11 @@ List_T EquivClassList_add(List_T list, size_t position)
   check_mem(new_item);
   new_item->position = position;
   new_item->next_item = NULL;
-  new_item->next_run = list->next_run_ptrs[list->num_runs];
+  new_item->next_run = NULL;
    
   if(!(list->first_item)) {
    list->first_item = new_item; 
+   list->run_start_item = new_item;
   } else {
     list->last_item->next_item = new_item;
   }
@@ -92,14 +87,20 @@ error:
 }
 
 
+/*
+ * Start a new run at item, which must be the last item of the list. The run
+ * that item closes is complete now, so point each of its items at item. Items
+ * of the open run keep a NULL next_run until it closes too, and each item is
+ * linked once, so this is linear in the length of the list overall.
+ */
 List_T EquivClassList_set_new_run(List_T list, Item_T item)
 {
-  list->next_run_ptrs[list->num_runs] = item;
-  list->num_runs++;
-  if(list->num_allocated_runs > list->num_runs) {
-    list->next_run_ptrs = realloc(list->next_run_ptrs, 2*list->num_allocated_runs);
+  Item_T run_item = list->run_start_item;
+  while(run_item != item) {
+    run_item->next_run = item;
+    run_item = run_item->next_item;
   }
-  list->next_run_ptrs[list->num_runs] = NULL;
+  list->run_start_item = item;
 
   return list;
 }
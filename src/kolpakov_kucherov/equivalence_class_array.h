@@ -29,8 +29,9 @@
  *  size_t position    :   Index in the query_string
  *  Item_T next_item   :   Pointer to the next item in this
  *                          equivalence class
- *  Item_T next_run    :   Pointer to the next run, as defined in
- *                          the K&K paper.
+ *  Item_T next_run    :   Pointer to the first item of the next
+ *                          run, as defined in the K&K paper, or
+ *                          NULL while this item's run is still open
  */
 typedef struct Item_T {
   size_t position;
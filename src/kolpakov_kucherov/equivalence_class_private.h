@@ -9,6 +9,9 @@
 size_t* annotate_substr_classes(size_t str_length, size_t substr_length,
                                 const SuffixTree_T stree);
 
+size_t* annotate_substr_classes_with_suffix_array(size_t substr_length,
+                                                  const SuffixArray_T suffix_array);
+
 int verify_substr_classes(const char* str, size_t str_len, size_t substr_len,
                           const size_t* substr_classes);
 
@@ -2,27 +2,66 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "kolpakov_kucherov/kolpakov_kucherov.h"
 #include "kolpakov_kucherov/equivalence_class.h"
 #include "kolpakov_kucherov/equivalence_class_array.h"
 #include "suffix_tree/suffix_tree.h"
+#include "utils/mapped_file.h"
 
 #include "utils/dbg.h"
 
-void length_constrained_palindromes(char* query_string, size_t query_length,
-                                    size_t min_arm_length, size_t min_gap_length,
-                                    size_t max_gap_length)
+#define STARTING_PALINDROME_COUNT 16
+
+int length_constrained_palindromes_foreach(char* query_string, size_t query_length,
+                                           size_t min_arm_length, size_t min_gap_length,
+                                           size_t max_gap_length,
+                                           GappedPalindromeFunc_T palindrome_func,
+                                           void* data)
 {
+  return length_constrained_palindromes_foreach_with_relation(
+      query_string, query_length, min_arm_length, min_gap_length, max_gap_length,
+      RELATION_EXACT, palindrome_func, data);
+}
+
+int length_constrained_palindromes_foreach_with_relation(
+        char* query_string, size_t query_length,
+        size_t min_arm_length, size_t min_gap_length, size_t max_gap_length,
+        enum PalindromeRelation relation,
+        GappedPalindromeFunc_T palindrome_func, void* data)
+{
+  AugmentedString_T aug_string = NULL;
+  EquivClassTable_T eq_table = NULL;
+  EquivClassArray_T eq_array = NULL;
+  char* left_string = NULL;
+  char* right_string = NULL;
+  int ret_val = 1;
+
+  check(palindrome_func, "Cannot search for palindromes without a palindrome_func.");
+  check(min_arm_length > 0 && min_gap_length <= max_gap_length,
+        "Invalid length constraints: min_arm_length %zu, gap length %zu - %zu.",
+        min_arm_length, min_gap_length, max_gap_length);
+
+  /* Left arms are compared in left_string, and right arms in right_string. For
+   * exact palindromes, both are query_string. */
+  int rc = Relation_map_string(relation, query_string, query_length,
+                               &left_string, &right_string);
+  check(rc == 0, "Could not map string for relation.");
+
   /* Augment the string with a suffix tree of the string plus its reverse. */
-  AugmentedString_T aug_string = AugmentedString_create(query_string, query_length);
+  aug_string = AugmentedString_create_mapped(left_string, right_string, query_length,
+                                             AUGMENTED_STRING_SUFFIX_TREE);
+  check(aug_string, "Could not create augmented string.");
 
-  EquivClassTable_T eq_table = EquivClassTable_create(aug_string,
-                                                      min_arm_length);
+  eq_table = EquivClassTable_create(aug_string, min_arm_length);
+  check(eq_table, "Could not create equivalence class table.");
   
   EquivClassIndex_T num_classes = EquivClassTable_num_classes(eq_table);
 
-  EquivClassArray_T eq_array = EquivClassArray_create(num_classes); 
+  eq_array = EquivClassArray_create(num_classes); 
+  check(eq_array, "Could not create equivalence class array.");
 
   EquivClassArray_T tmp_eq_array;
+  struct GappedPalindrome palindrome;
   size_t j = 0;
   for(j = 0; j < query_length; j++) {
 
@@ -31,11 +70,10 @@ void length_constrained_palindromes(char* query_string, size_t query_length,
     /* We can continue if we're not past min_arm_length yet. */
     if(left_class == 0) continue;
     
-    tmp_eq_array = EquivClassArray_add(eq_array, left_class, j, query_string);
+    tmp_eq_array = EquivClassArray_add(eq_array, left_class, j, left_string);
     check(tmp_eq_array, "Failed addition off position to equivalence class array.");
     eq_array = tmp_eq_array;
 
-    //size_t right_class = forward_table[j];
     EquivClassIndex_T right_class = EquivClassTable_forward_lookup(eq_table, j);
 
     EquivClassItem_T search_item =
@@ -45,7 +83,9 @@ void length_constrained_palindromes(char* query_string, size_t query_length,
      * not a palindrome, and we can continue. */
     if(!search_item) continue;
 
-    while(search_item->position < j - max_gap_length) {
+    /* Written as additions so that positions near the start of the string
+     * don't underflow. */
+    while(search_item->position + max_gap_length < j) {
       EquivClassItem_T next_search_item = search_item->next_item;
       if(next_search_item) {
         search_item = search_item->next_item;
@@ -58,29 +98,172 @@ void length_constrained_palindromes(char* query_string, size_t query_length,
                                                        right_class,
                                                        search_item);
 
-    /* Make sure that the search_item isn't NULL before continuing with another
-     * iteration. */
-    while(search_item && search_item->position <= j - min_gap_length) {
-      if(query_string[search_item->position] != query_string[j - 1]) {
+    /* Every item in the class may be too far to the left. */
+    if(search_item->position + max_gap_length < j) continue;
+
+    /* Every item of a run has the same character at its gap start, so either
+     * each item in the run gives a palindrome whose gap can't shrink, or none
+     * does and the whole run is skipped. */
+    while(search_item && search_item->position + min_gap_length <= j) {
+      if(left_string[search_item->position] == right_string[j - 1]) {
+        search_item = search_item->next_run;
+      } else {
         size_t pal_length = AugmentedString_common_prefix_suffix_length(
             aug_string, search_item->position - 1, j);
-        printf("Palindrome at %zu - %zu, %zu\n", search_item->position, j, pal_length);
-        printf("Palindrome bounds: (%zu-%zu), (%zu-%zu)\n",
-               search_item->position - pal_length, search_item->position,
-               j, j + pal_length);
+
+        palindrome.left_arm_start = search_item->position - pal_length;
+        palindrome.gap_start = search_item->position;
+        palindrome.gap_end = j;
+        palindrome.arm_length = pal_length;
+
+        if(palindrome_func(&palindrome, data) != 0) {
+          ret_val = 0;
+          goto error;
+        }
+        search_item = search_item->next_item;
       }
-      search_item = search_item->next_run;
     }
   }
+  ret_val = 0;
 
-  EquivClassArray_delete(&eq_array);
-  EquivClassTable_delete(&eq_table);
+error:
+  if(eq_array) EquivClassArray_delete(&eq_array);
+  if(eq_table) EquivClassTable_delete(&eq_table);
   AugmentedString_delete(&aug_string);
+  Relation_free_strings(query_string, &left_string, &right_string);
+  return ret_val;
+}
+
+int length_constrained_palindromes_file(const char* path,
+                                        size_t min_arm_length, size_t min_gap_length,
+                                        size_t max_gap_length,
+                                        GappedPalindromeFunc_T palindrome_func,
+                                        void* data)
+{
+  MappedFile_T file = MappedFile_open(path);
+  check(file, "Could not map %s.", path);
+
+  int rc = length_constrained_palindromes_foreach(MappedFile_get_data(file),
+                                                  MappedFile_get_length(file),
+                                                  min_arm_length, min_gap_length,
+                                                  max_gap_length, palindrome_func,
+                                                  data);
+  MappedFile_close(&file);
+  return rc;
+
+error:
+  return 1;
+}
+
+/* A little helper struct for collecting palindromes into an array. */
+struct CollectData {
+  GappedPalindromeArray_T results;
+  int append_failed;
+};
+
+/* The GappedPalindromeFunc_T used by length_constrained_palindromes_collect. */
+static int collect_palindrome_func(const struct GappedPalindrome* palindrome, void* vcollect_data)
+{
+  struct CollectData* collect_data = vcollect_data;
+  if(GappedPalindromeArray_append(collect_data->results, palindrome) != 0) {
+    /* Stop the search, and remember that it was stopped by a failure. */
+    collect_data->append_failed = 1;
+    return 1;
+  }
+  return 0;
+}
+
+int length_constrained_palindromes_collect(char* query_string, size_t query_length,
+                                           size_t min_arm_length, size_t min_gap_length,
+                                           size_t max_gap_length,
+                                           GappedPalindromeArray_T results)
+{
+  check(results, "Cannot collect palindromes into a NULL GappedPalindromeArray_T.");
+
+  struct CollectData collect_data = {results, 0};
+  int rc = length_constrained_palindromes_foreach(query_string, query_length,
+                                                  min_arm_length, min_gap_length,
+                                                  max_gap_length,
+                                                  collect_palindrome_func,
+                                                  &collect_data);
+  check(rc == 0, "Length-constrained palindrome search failed.");
+  check(!collect_data.append_failed, "Failed to append palindrome to results.");
+
+  return 0;
 
 error:
-  return;
+  return 1;
 }
 
+/* The GappedPalindromeFunc_T used by length_constrained_palindromes. */
+static int print_palindrome_func(const struct GappedPalindrome* palindrome, void* data)
+{
+  (void)data;
+  printf("Palindrome at %zu - %zu, %zu\n", palindrome->gap_start,
+         palindrome->gap_end, palindrome->arm_length);
+  printf("Palindrome bounds: (%zu-%zu), (%zu-%zu)\n",
+         palindrome->left_arm_start, palindrome->gap_start,
+         palindrome->gap_end, palindrome->gap_end + palindrome->arm_length);
+  return 0;
+}
 
+void length_constrained_palindromes(char* query_string, size_t query_length,
+                                    size_t min_arm_length, size_t min_gap_length,
+                                    size_t max_gap_length)
+{
+  length_constrained_palindromes_foreach(query_string, query_length,
+                                         min_arm_length, min_gap_length,
+                                         max_gap_length, print_palindrome_func,
+                                         NULL);
+}
+
+GappedPalindromeArray_T GappedPalindromeArray_create(void)
+{
+  GappedPalindromeArray_T array = calloc(1, sizeof(struct GappedPalindromeArray_T));
+  check_mem(array);
 
+  array->palindromes = calloc(STARTING_PALINDROME_COUNT, sizeof(struct GappedPalindrome));
+  check_mem(array->palindromes);
+  array->num_allocated = STARTING_PALINDROME_COUNT;
+  array->length = 0;
 
+  return array;
+
+error:
+  GappedPalindromeArray_delete(&array);
+  return NULL;
+}
+
+void GappedPalindromeArray_delete(GappedPalindromeArray_T* array)
+{
+  if(!array) return;
+
+  if(*array) {
+    if((*array)->palindromes) free((*array)->palindromes);
+    free(*array);
+    *array = NULL;
+  }
+}
+
+int GappedPalindromeArray_append(GappedPalindromeArray_T array,
+                                 const struct GappedPalindrome* palindrome)
+{
+  check(array, "Attempting to append to a NULL GappedPalindromeArray_T.");
+
+  if(array->length == array->num_allocated) {
+    size_t new_num_allocated = 2 * array->num_allocated;
+    struct GappedPalindrome* tmp_palindromes = realloc(
+        array->palindromes, new_num_allocated * sizeof(struct GappedPalindrome));
+    check_mem(tmp_palindromes);
+    array->palindromes = tmp_palindromes;
+    array->num_allocated = new_num_allocated;
+  }
+
+  array->palindromes[array->length] = *palindrome;
+  array->length++;
+
+  return 0;
+
+error:
+  return 1;
+}
@@ -3,9 +3,146 @@
 
 #include <stdlib.h>
 
+#include "utils/relation.h"
 
+/* TYPES */
+
+/*
+ * A gapped palindrome uvu^T found by the length-constrained search. The left
+ * arm u is query_string[left_arm_start:gap_start], the gap v is
+ * query_string[gap_start:gap_end], and the right arm u^T is
+ * query_string[gap_end:gap_end+arm_length], using Python slice syntax.
+ *
+ * Members:
+ *  size_t left_arm_start   :   Index of the first character of the left arm
+ *  size_t gap_start        :   Index of the first character of the gap
+ *  size_t gap_end          :   Index one past the last character of the gap,
+ *                              which is also the start of the right arm
+ *  size_t arm_length       :   Length of each arm
+ */
+struct GappedPalindrome {
+  size_t left_arm_start;
+  size_t gap_start;
+  size_t gap_end;
+  size_t arm_length;
+};
+
+/*
+ * A growable array of gapped palindromes. The caller creates it, the search
+ * appends to it, and the caller deletes it.
+ *
+ * Members:
+ *  struct GappedPalindrome* palindromes  :   The palindromes found so far
+ *  size_t length                         :   Number of palindromes in the
+ *                                            array
+ *  size_t num_allocated                  :   Capacity of palindromes
+ */
+typedef struct GappedPalindromeArray_T {
+  struct GappedPalindrome* palindromes;
+  size_t length;
+  size_t num_allocated;
+}* GappedPalindromeArray_T;
+
+/*
+ * The function pointer type called for each palindrome found by
+ * length_constrained_palindromes_foreach.
+ *
+ * Params:
+ *  const struct GappedPalindrome* palindrome   :   The palindrome found. Only
+ *                                                  valid during the call.
+ *  void* data                                  :   Pointer to caller data.
+ *
+ * Returns:
+ *  0 to continue the search, anything else to stop it.
+ */
+typedef int (*GappedPalindromeFunc_T)(const struct GappedPalindrome* palindrome,
+                                      void* data);
+
+/* FUNCTIONS */
+
+/*
+ * Find the gapped palindromes in a string whose arms are at least
+ * min_arm_length long and whose gaps are between min_gap_length and
+ * max_gap_length, calling palindrome_func on each one as it is found. Nothing
+ * is printed. The search indexes the string with a suffix tree, so there is no
+ * limit on its length but memory.
+ *
+ * Params:
+ *  char* query_string                      :   String to be searched
+ *  size_t query_length                     :   Length of query_string, not
+ *                                              including null terminator
+ *  size_t min_arm_length                   :   Minimum length of each arm,
+ *                                              which must be at least 1
+ *  size_t min_gap_length                   :   Minimum length of the gap
+ *  size_t max_gap_length                   :   Maximum length of the gap,
+ *                                              which must be at least
+ *                                              min_gap_length
+ *  GappedPalindromeFunc_T palindrome_func  :   Called on every palindrome
+ *  void* data                              :   Passed to palindrome_func
+ *
+ * Returns:
+ *  0 if the search completed or was stopped by palindrome_func, else 1.
+ */
+int  length_constrained_palindromes_foreach(char* query_string, size_t query_length,
+                                            size_t min_arm_length, size_t min_gap_length,
+                                            size_t max_gap_length,
+                                            GappedPalindromeFunc_T palindrome_func,
+                                            void* data);
+
+/*
+ * Like length_constrained_palindromes_foreach, but with the arms paired under
+ * relation, so that the right arm is the left arm reversed and mapped through
+ * it. With RELATION_REVERSE_COMPLEMENT these are inverted repeats. The string
+ * is mapped once for each arm before the search, which then runs unchanged.
+ */
+int  length_constrained_palindromes_foreach_with_relation(
+         char* query_string, size_t query_length,
+         size_t min_arm_length, size_t min_gap_length, size_t max_gap_length,
+         enum PalindromeRelation relation,
+         GappedPalindromeFunc_T palindrome_func, void* data);
+
+/*
+ * Like length_constrained_palindromes_foreach, on the contents of a file. The
+ * file is mapped rather than read, and stays mapped for the search. As there,
+ * the file can be of any length that its index fits in memory.
+ */
+int  length_constrained_palindromes_file(const char* path,
+                                         size_t min_arm_length, size_t min_gap_length,
+                                         size_t max_gap_length,
+                                         GappedPalindromeFunc_T palindrome_func,
+                                         void* data);
+
+/*
+ * Like length_constrained_palindromes_foreach, but append every palindrome
+ * found to a caller-owned GappedPalindromeArray_T.
+ *
+ * Returns:
+ *  0 on success, else 1. On failure, results holds the palindromes found
+ *  before the failure.
+ */
+int  length_constrained_palindromes_collect(char* query_string, size_t query_length,
+                                            size_t min_arm_length, size_t min_gap_length,
+                                            size_t max_gap_length,
+                                            GappedPalindromeArray_T results);
+
+/* Find the gapped palindromes in a string and print them to stdout. */
 void length_constrained_palindromes(char* query_string, size_t query_length,
                                     size_t min_arm_length, size_t min_gap_length,
                                     size_t max_gap_length);
 
+/* Create an empty GappedPalindromeArray_T. */
+GappedPalindromeArray_T GappedPalindromeArray_create(void);
+
+/* Free a GappedPalindromeArray_T and the palindromes it holds. */
+void                    GappedPalindromeArray_delete(GappedPalindromeArray_T* array);
+
+/*
+ * Append a palindrome to a GappedPalindromeArray_T, growing it if needed.
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+int                     GappedPalindromeArray_append(GappedPalindromeArray_T array,
+                                                     const struct GappedPalindrome* palindrome);
+
 #endif
@@ -58,6 +58,7 @@ EulerTour_T EulerTour_create(SuffixTree_T tree)
   check_mem(euler_tour->first_instances);
   
   pos_in_tour = calloc(1, sizeof(size_t));
+  check_mem(pos_in_tour);
 
   euler_data = malloc(sizeof(struct EulerTourWalkData));
   check_mem(euler_data);
@@ -67,9 +68,10 @@ EulerTour_T EulerTour_create(SuffixTree_T tree)
   euler_data->first_instances = euler_tour->first_instances;
   euler_data->pos_in_tour = pos_in_tour;
 
-  SuffixTree_euler_walk(tree, SuffixTree_get_root(tree),
-                        euler_tour_node_func, euler_data,
-                        0);
+  int rc = SuffixTree_euler_walk(tree, SuffixTree_get_root(tree),
+                                 euler_tour_node_func, euler_data,
+                                 0);
+  check(rc == 0, "Euler walk of the suffix tree failed.");
 
   free(euler_data);
   free(pos_in_tour);
@@ -11,8 +11,11 @@
  *    2. Partition that array into blocks, and compute minima between blocks
  *    using the Sparse Table algorithm. This creates and retains a table of size
  *    nlogn.
- *    3. Precompute all possible within-block queries. This creates and stores
- *    tables of total size sqrt(n)log^2n.
+ *    3. Precompute all possible within-block queries. Each block is
+ *    identified by its pattern of +1 and -1 steps when the tour is
+ *    partitioned, and each pattern gets one bitmask per position, for a total
+ *    of sqrt(n)logn words. A query within a block is then a shift and a count
+ *    of trailing zeros.
  */
 
 #include "lca_suffix_tree.h"
@@ -33,6 +36,9 @@
 #define MAX(a,b) ((a) > (b) ? a : b)
 #define MIN(a,b) ((a) < (b) ? a : b)
 
+/* The number of queries whose loads are in flight together in a batch */
+#define LCA_BATCH_SIZE 32
+
 struct LCASuffixTree_T {
   /* 
    * This has to be the first element in the struct. Changing that will break
@@ -126,51 +132,23 @@ void LCASuffixTree_delete(LCASuffixTree_T* lca_suffix_tree)
  }
 }
 
-Node_T LCASuffixTree_get_lca(LCASuffixTree_T lca_suffix_tree, Node_T node1, Node_T node2)
+/*
+ * Find the position of the minimum depth in the Euler tour between two tour
+ * positions, inclusive. start_tour_pos must not be after end_tour_pos.
+ */
+size_t min_depth_tour_pos(LCASuffixTree_T lca_suffix_tree, size_t start_tour_pos,
+                          size_t end_tour_pos)
 {
-  size_t node_id1 = Node_get_index(node1);
-  size_t node_id2 = Node_get_index(node2);
-  /* First, we find a position of each requested node in the Euler tour arrays. */
-  size_t tour_pos_1 = lca_suffix_tree->euler_tour->first_instances[node_id1];
-  size_t tour_pos_2 = lca_suffix_tree->euler_tour->first_instances[node_id2];
-
-  /* We'll need to know which one is first for some of the lookups to work
-   * right. */
-  size_t start_tour_pos = MIN(tour_pos_1, tour_pos_2);
-  size_t end_tour_pos = MAX(tour_pos_1, tour_pos_2);
-
-  /* Now, we want to know which block each node position falls in. */
-  size_t block_index_1 = TourPartition_get_block_index(lca_suffix_tree->tour_partition,
-                                                       start_tour_pos);
-  size_t block_index_2 = TourPartition_get_block_index(lca_suffix_tree->tour_partition,
-                                                       end_tour_pos);
-
-  /* And the position, within its block, of each node position. */
-  size_t pos_in_block_1 = TourPartition_get_pos_in_block(lca_suffix_tree->tour_partition,
-                                                         start_tour_pos);
-  size_t pos_in_block_2 = TourPartition_get_pos_in_block(lca_suffix_tree->tour_partition,
-                                                         end_tour_pos);
-  
-  /* Then get the blocks themselves. Note that these are block in the node
-   * depths, not the node ids. block_size_[12] give the true size of each
-   * block, which may be different if it's the last block. */
-  size_t* block_1 = NULL, *block_2 = NULL;
-
-  block_1 = calloc(lca_suffix_tree->tour_partition->block_length,
-                   sizeof(size_t));
-  check_mem(block_1);
-
-  size_t block_size_1 = TourPartition_get_block(
-      &block_1, lca_suffix_tree->tour_partition, block_index_1,
-      lca_suffix_tree->euler_tour->depths); 
+  EulerTour_T euler_tour = lca_suffix_tree->euler_tour;
+  TourPartition_T tour_partition = lca_suffix_tree->tour_partition;
+  size_t block_length = tour_partition->block_length;
 
-  block_2 = calloc(lca_suffix_tree->tour_partition->block_length,
-                   sizeof(size_t));
-  check_mem(block_2);
-
-  size_t block_size_2 = TourPartition_get_block(
-      &block_2, lca_suffix_tree->tour_partition, block_index_2,
-      lca_suffix_tree->euler_tour->depths);
+  /* First, we want to know which block each node position falls in, and the
+   * position within its block of each node position. */
+  size_t block_index_1 = start_tour_pos / block_length;
+  size_t block_index_2 = end_tour_pos / block_length;
+  size_t pos_in_block_1 = start_tour_pos - block_index_1 * block_length;
+  size_t pos_in_block_2 = end_tour_pos - block_index_2 * block_length;
 
   /* The value we want to calculate is the position of the minimum value
    * between the node positions in the depth array. */ 
@@ -179,36 +157,30 @@ Node_T LCASuffixTree_get_lca(LCASuffixTree_T lca_suffix_tree, Node_T node1, Node
   /* If the two nodes lie in the same block, then we just need to do an RMQ on
    * that block using the positions of each node within the block. */
   if(block_index_1 == block_index_2) {
-    size_t min_pos_in_block = BlockRMQDatabase_lookup(
-        lca_suffix_tree->block_rmq_db, block_1, block_size_1,
+    size_t min_pos_in_block = BlockRMQDatabase_lookup_by_id(
+        lca_suffix_tree->block_rmq_db, tour_partition->block_ids[block_index_1],
         pos_in_block_1, pos_in_block_2 + 1);
-    check(min_pos_in_block != (size_t)-1, "BlockRMQDatabase lookup failed.");
 
-    pos_of_min_depth = block_index_1 * lca_suffix_tree->tour_partition->block_length + min_pos_in_block;
+    pos_of_min_depth = block_index_1 * block_length + min_pos_in_block;
   } else {
     /* Different blocks, so we need to look in each block and then between the
      * blocks to find the minimum value. */
 
     /* Get the positions of the minimum values in each block. For the first
      * block, start at the position and go to the end. For the second block,
-     * start at the beginning and go to the position. */
-    size_t min_pos_in_block_1 = BlockRMQDatabase_lookup(
-        lca_suffix_tree->block_rmq_db,
-        block_1, block_size_1,
-        pos_in_block_1,
-        block_size_1);
-    check(min_pos_in_block_1 != (size_t)-1, "BlockRMQDatabase lookup failed.");
-
-    size_t min_pos_in_block_2 = BlockRMQDatabase_lookup(
-        lca_suffix_tree->block_rmq_db,
-        block_2, block_size_2,
-        0,
-        pos_in_block_2 + 1);
-    check(min_pos_in_block_2 != (size_t)-1, "BlockRMQDatabase lookup failed.");
+     * start at the beginning and go to the position. The first block can't
+     * be the short last block, so it is full. */
+    size_t min_pos_1 = block_index_1 * block_length + BlockRMQDatabase_lookup_by_id(
+        lca_suffix_tree->block_rmq_db, tour_partition->block_ids[block_index_1],
+        pos_in_block_1, block_length);
+
+    size_t min_pos_2 = block_index_2 * block_length + BlockRMQDatabase_lookup_by_id(
+        lca_suffix_tree->block_rmq_db, tour_partition->block_ids[block_index_2],
+        0, pos_in_block_2 + 1);
 
     /* Get the depths at each of these positions. */ 
-    size_t min_depth_in_block_1 = block_1[min_pos_in_block_1];
-    size_t min_depth_in_block_2 = block_2[min_pos_in_block_2];
+    size_t min_depth_in_block_1 = euler_tour->depths[min_pos_1];
+    size_t min_depth_in_block_2 = euler_tour->depths[min_pos_2];
     
     /* Now get the block index for the block that contains the minimum value
      * between the nodes' blocks. */
@@ -218,16 +190,15 @@ Node_T LCASuffixTree_get_lca(LCASuffixTree_T lca_suffix_tree, Node_T node1, Node
     if(block_index_2 > block_index_1 + 1) {
       size_t min_between_block_index = SparseTable_lookup(
           lca_suffix_tree->block_sparse_table,
-          lca_suffix_tree->tour_partition->block_minima,
+          tour_partition->block_minima,
           block_index_1 + 1, block_index_2);
 
       /* And the position, within the tour, of the minimum value in that
       * block. */
-      min_between_tour_pos = min_between_block_index *
-                             lca_suffix_tree->tour_partition->block_length +
-                             lca_suffix_tree->tour_partition->minima_positions[min_between_block_index];
+      min_between_tour_pos = min_between_block_index * block_length +
+                             tour_partition->minima_positions[min_between_block_index];
 
-      min_depth_between_blocks = lca_suffix_tree->euler_tour->depths[min_between_tour_pos];
+      min_depth_between_blocks = tour_partition->block_minima[min_between_block_index];
     } else {
       min_depth_between_blocks = (size_t)-1;
       min_between_tour_pos = (size_t)-1;
@@ -235,23 +206,100 @@ Node_T LCASuffixTree_get_lca(LCASuffixTree_T lca_suffix_tree, Node_T node1, Node
 
     if(min_depth_in_block_1 <= min_depth_between_blocks &&
        min_depth_in_block_1 <= min_depth_in_block_2) {
-      pos_of_min_depth = block_index_1 * lca_suffix_tree->tour_partition->block_length + min_pos_in_block_1;
+      pos_of_min_depth = min_pos_1;
     } else if(min_depth_in_block_2 <= min_depth_between_blocks &&
               min_depth_in_block_2 <= min_depth_in_block_1) {
-      pos_of_min_depth = block_index_2 * lca_suffix_tree->tour_partition->block_length + min_pos_in_block_2;
-    } else if(min_depth_between_blocks <= min_depth_in_block_1 &&
-              min_depth_between_blocks <= min_depth_in_block_2) {
+      pos_of_min_depth = min_pos_2;
+    } else {
       pos_of_min_depth = min_between_tour_pos;
     }
   }
-  free(block_1);
-  free(block_2);
-  return lca_suffix_tree->euler_tour->nodes[pos_of_min_depth];
+  return pos_of_min_depth;
+}
+
+Node_T LCASuffixTree_get_lca(LCASuffixTree_T lca_suffix_tree, Node_T node1, Node_T node2)
+{
+  EulerTour_T euler_tour = lca_suffix_tree->euler_tour;
+
+  /* First, we find a position of each requested node in the Euler tour arrays. */
+  size_t tour_pos_1 = euler_tour->first_instances[Node_get_index(node1)];
+  size_t tour_pos_2 = euler_tour->first_instances[Node_get_index(node2)];
+
+  /* We'll need to know which one is first for some of the lookups to work
+   * right. */
+  size_t pos_of_min_depth = min_depth_tour_pos(lca_suffix_tree,
+                                               MIN(tour_pos_1, tour_pos_2),
+                                               MAX(tour_pos_1, tour_pos_2));
+  return euler_tour->nodes[pos_of_min_depth];
+}
+
+/*
+ * Prefetch everything min_depth_tour_pos will read for a pair of tour
+ * positions.
+ */
+void prefetch_tour_range(LCASuffixTree_T lca_suffix_tree, size_t start_tour_pos,
+                         size_t end_tour_pos)
+{
+  EulerTour_T euler_tour = lca_suffix_tree->euler_tour;
+  TourPartition_T tour_partition = lca_suffix_tree->tour_partition;
+  size_t block_index_1 = start_tour_pos / tour_partition->block_length;
+  size_t block_index_2 = end_tour_pos / tour_partition->block_length;
+
+  __builtin_prefetch(&tour_partition->block_ids[block_index_1]);
+  __builtin_prefetch(&tour_partition->block_ids[block_index_2]);
+  __builtin_prefetch(&euler_tour->depths[start_tour_pos]);
+  __builtin_prefetch(&euler_tour->depths[end_tour_pos]);
+  if(block_index_2 > block_index_1 + 1) {
+    SparseTable_prefetch(lca_suffix_tree->block_sparse_table, block_index_1 + 1,
+                         block_index_2);
+  }
+}
+
+int LCASuffixTree_get_lca_batch(LCASuffixTree_T lca_suffix_tree,
+                                const Node_T* pairs, size_t num_pairs,
+                                Node_T* lcas)
+{
+  EulerTour_T euler_tour = lca_suffix_tree->euler_tour;
+  size_t start_tour_pos[LCA_BATCH_SIZE];
+  size_t end_tour_pos[LCA_BATCH_SIZE];
+  size_t batch_start = 0, k = 0;
+
+  check(pairs || num_pairs == 0, "Cannot look up LCAs without query pairs.");
+  check(lcas || num_pairs == 0, "Cannot look up LCAs without an output array.");
+
+  for(batch_start = 0; batch_start < num_pairs; batch_start += LCA_BATCH_SIZE) {
+    size_t batch_size = MIN(LCA_BATCH_SIZE, num_pairs - batch_start);
+    const Node_T* batch_pairs = pairs + 2 * batch_start;
+
+    /* Each stage issues the loads for the whole batch before the next stage
+     * uses any of them, so the misses of a batch overlap. */
+    for(k = 0; k < 2 * batch_size; k++) {
+      __builtin_prefetch(batch_pairs[k]);
+    }
+    for(k = 0; k < 2 * batch_size; k++) {
+      __builtin_prefetch(&euler_tour->first_instances[Node_get_index(batch_pairs[k])]);
+    }
+    for(k = 0; k < batch_size; k++) {
+      size_t tour_pos_1 = euler_tour->first_instances[Node_get_index(batch_pairs[2 * k])];
+      size_t tour_pos_2 = euler_tour->first_instances[Node_get_index(batch_pairs[2 * k + 1])];
+      start_tour_pos[k] = MIN(tour_pos_1, tour_pos_2);
+      end_tour_pos[k] = MAX(tour_pos_1, tour_pos_2);
+      prefetch_tour_range(lca_suffix_tree, start_tour_pos[k], end_tour_pos[k]);
+    }
+    for(k = 0; k < batch_size; k++) {
+      start_tour_pos[k] = min_depth_tour_pos(lca_suffix_tree, start_tour_pos[k],
+                                             end_tour_pos[k]);
+      __builtin_prefetch(&euler_tour->nodes[start_tour_pos[k]]);
+    }
+    for(k = 0; k < batch_size; k++) {
+      lcas[batch_start + k] = euler_tour->nodes[start_tour_pos[k]];
+    }
+  }
+
+  return 0;
 
 error:
-  if(block_1) free(block_1);
-  if(block_2) free(block_2);
-  return NULL;
+  return 1;
 }
 
 /*
@@ -13,6 +13,10 @@
  * common ancestor queries. All the SuffixTree_T methods will work on an
  * LCASuffixTree_T cast to SuffixTree_T, though some functions like
  * SuffixTree_delete will do something unhelpful.
+ *
+ * All the lookup tables are filled in when the tree is created, and
+ * LCASuffixTree_get_lca doesn't modify the tree, so one instance can be
+ * queried from several threads at once.
  */
 typedef struct LCASuffixTree_T* LCASuffixTree_T;
 
@@ -53,6 +57,31 @@ void            LCASuffixTree_delete(LCASuffixTree_T* tree);
 Node_T          LCASuffixTree_get_lca(LCASuffixTree_T tree,
                                       Node_T node1, Node_T node2);
 
+/*
+ * Find the lowest common ancestors of many pairs of nodes. The answers are
+ * the same as from calling LCASuffixTree_get_lca on each pair, but the
+ * lookups of a batch of pairs are done in stages, with the memory for each
+ * stage requested for the whole batch before any of it is used. When queries
+ * are many and the tree is larger than the cache, most of the time of
+ * LCASuffixTree_get_lca is spent waiting on memory, and this overlaps the
+ * waits.
+ *
+ * Params:
+ *  LCASuffixTree_T tree    :   Tree containing the query nodes.
+ *  const Node_T* pairs     :   2 * num_pairs nodes. The pair i is pairs[2*i]
+ *                              and pairs[2*i+1].
+ *  size_t num_pairs        :   The number of pairs.
+ *  Node_T* lcas            :   Filled with the lowest common ancestor of each
+ *                              pair. Must have room for num_pairs nodes.
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+int             LCASuffixTree_get_lca_batch(LCASuffixTree_T tree,
+                                            const Node_T* pairs,
+                                            size_t num_pairs,
+                                            Node_T* lcas);
+
 /*
  * Run some slow tests on the tree to verify that 1) the tree is a correct
  * SuffixTree_T and that 2) LCA queries are working correctly.
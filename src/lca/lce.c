@@ -0,0 +1,385 @@
+/*
+ * Longest common extension queries by range minimum over an LCP array.
+ *
+ * The LCP array is cut into blocks of LCE_BLOCK_LENGTH values. A sparse table
+ * over the block minima answers the part of a query that covers whole blocks,
+ * and the partial blocks at either end are scanned. The scans touch at most
+ * two short runs of contiguous memory, which in practice is cheaper than
+ * looking up more tables.
+ */
+
+#include "lce.h"
+
+#include "lca/sparse_table.h"
+
+#include "utils/dbg.h"
+
+#define MIN(a,b) ((a) < (b) ? a : b)
+#define MAX(a,b) ((a) > (b) ? a : b)
+
+/* The number of LCP values in each block of the range minimum structure */
+#define LCE_BLOCK_LENGTH 32
+
+/* The number of queries whose loads are in flight together in a batch */
+#define LCE_BATCH_SIZE 32
+
+/* Strings at least this long need 64-bit ranks and LCPs */
+#define LCE_WIDE_LENGTH ((size_t)UINT32_MAX)
+
+struct LCE_T {
+  /* The length of the string */
+  size_t        length;
+  /* The number of ranked suffixes */
+  size_t        num_ranks;
+  /* The rank of the suffix at each position */
+  uint32_t*     ranks;
+  /* lcp[r] is the longest common prefix of the suffixes with rank r - 1 and r */
+  uint32_t*     lcp;
+  /* ranks and lcp for strings too long for 32 bits. Only one pair is set. */
+  uint64_t*     wide_ranks;
+  uint64_t*     wide_lcp;
+  /* The minimum of each block of lcp, and a sparse table over those minima */
+  size_t*       block_minima;
+  size_t        num_blocks;
+  SparseTable_T block_table;
+};
+
+static inline size_t rank_at(LCE_T lce, size_t pos)
+{
+  return lce->ranks ? lce->ranks[pos] : lce->wide_ranks[pos];
+}
+
+static inline size_t lcp_at(LCE_T lce, size_t rank)
+{
+  return lce->lcp ? lce->lcp[rank] : lce->wide_lcp[rank];
+}
+
+/* Fill in the block minima of an LCE_T whose ranks and LCPs are set. */
+static int create_blocks(LCE_T lce)
+{
+  size_t num_ranks = lce->num_ranks;
+  size_t i = 0;
+
+  lce->num_blocks = (num_ranks + LCE_BLOCK_LENGTH - 1) / LCE_BLOCK_LENGTH;
+  if(lce->num_blocks > 0) {
+    lce->block_minima = malloc(lce->num_blocks * sizeof(size_t));
+    check_mem(lce->block_minima);
+    for(i = 0; i < num_ranks; i++) {
+      size_t block = i / LCE_BLOCK_LENGTH;
+      size_t value = lcp_at(lce, i);
+      if(i % LCE_BLOCK_LENGTH == 0 || value < lce->block_minima[block]) {
+        lce->block_minima[block] = value;
+      }
+    }
+    lce->block_table = SparseTable_create(lce->block_minima, lce->num_blocks);
+    check(lce->block_table, "Failed to create sparse table of LCP blocks.");
+  }
+
+  return 0;
+
+error:
+  return 1;
+}
+
+LCE_T LCE_create(uint32_t* ranks, uint32_t* lcp, size_t length, size_t num_ranks)
+{
+  LCE_T lce = NULL;
+
+  check(ranks && lcp, "Cannot create an LCE_T without ranks and LCPs.");
+
+  lce = calloc(1, sizeof(struct LCE_T));
+  check_mem(lce);
+  lce->length = length;
+  lce->num_ranks = num_ranks;
+  lce->ranks = ranks;
+  lce->lcp = lcp;
+  ranks = NULL;
+  lcp = NULL;
+
+  check(create_blocks(lce) == 0, "Failed to create LCP blocks.");
+  return lce;
+
+error:
+  if(ranks) free(ranks);
+  if(lcp) free(lcp);
+  LCE_delete(&lce);
+  return NULL;
+}
+
+LCE_T LCE_create_wide(uint64_t* ranks, uint64_t* lcp, size_t length,
+                      size_t num_ranks)
+{
+  LCE_T lce = NULL;
+
+  check(ranks && lcp, "Cannot create an LCE_T without ranks and LCPs.");
+
+  lce = calloc(1, sizeof(struct LCE_T));
+  check_mem(lce);
+  lce->length = length;
+  lce->num_ranks = num_ranks;
+  lce->wide_ranks = ranks;
+  lce->wide_lcp = lcp;
+  ranks = NULL;
+  lcp = NULL;
+
+  check(create_blocks(lce) == 0, "Failed to create LCP blocks.");
+  return lce;
+
+error:
+  if(ranks) free(ranks);
+  if(lcp) free(lcp);
+  LCE_delete(&lce);
+  return NULL;
+}
+
+/* A little helper struct for ranking the leaves of a suffix tree. */
+struct LCEWalkData {
+  /* Either the 32-bit or the 64-bit arrays are set */
+  uint32_t* ranks;
+  uint32_t* lcp;
+  uint64_t* wide_ranks;
+  uint64_t* wide_lcp;
+  size_t    string_length;
+  size_t    num_ranked;
+  /* The smallest string depth seen since the last leaf */
+  size_t    min_depth;
+};
+
+/*
+ * The NodeFunc_T for the Euler walk that ranks leaves. Between two leaves,
+ * the walk passes through their lowest common ancestor and no shallower
+ * node, so the LCP of a leaf with the leaf before it is the smallest string
+ * depth seen in between.
+ */
+SuffixTreeIndex_T lce_node_func(SuffixTree_T tree, Node_T node, void* vwalk_data,
+                                SuffixTreeIndex_T counter)
+{
+  struct LCEWalkData* walk_data = vwalk_data;
+  size_t depth = Node_get_edge_depth(node);
+
+  if(!Node_is_leaf(node, tree)) {
+    walk_data->min_depth = MIN(walk_data->min_depth, depth);
+    return counter;
+  }
+
+  size_t rank = walk_data->num_ranked++;
+  size_t lcp = rank == 0 ? 0 : walk_data->min_depth;
+  walk_data->min_depth = (size_t)-1;
+
+  /* The suffix that is just the terminator is ranked but never queried. */
+  size_t suffix_start = walk_data->string_length - depth;
+  int queried = suffix_start + 1 < walk_data->string_length;
+
+  if(walk_data->lcp) {
+    walk_data->lcp[rank] = lcp;
+    if(queried) walk_data->ranks[suffix_start] = rank;
+  } else {
+    walk_data->wide_lcp[rank] = lcp;
+    if(queried) walk_data->wide_ranks[suffix_start] = rank;
+  }
+
+  return counter;
+}
+
+LCE_T LCE_create_from_suffix_tree(SuffixTree_T tree)
+{
+  struct LCEWalkData walk_data = {NULL, NULL, NULL, NULL, 0, 0, (size_t)-1};
+
+  check(tree, "Cannot create an LCE_T without a suffix tree.");
+
+  /* The tree's string includes its terminator, which has a leaf of its own. */
+  size_t num_ranks = SuffixTree_get_string_length(tree);
+  size_t length = num_ranks - 1;
+  walk_data.string_length = num_ranks;
+
+  /* Ranks and LCPs are at most num_ranks, and take half the memory as 32-bit
+   * values when they fit. */
+  if(num_ranks < LCE_WIDE_LENGTH) {
+    walk_data.ranks = malloc(MAX(length, 1) * sizeof(uint32_t));
+    check_mem(walk_data.ranks);
+    walk_data.lcp = malloc(num_ranks * sizeof(uint32_t));
+    check_mem(walk_data.lcp);
+  } else {
+    walk_data.wide_ranks = malloc(length * sizeof(uint64_t));
+    check_mem(walk_data.wide_ranks);
+    walk_data.wide_lcp = malloc(num_ranks * sizeof(uint64_t));
+    check_mem(walk_data.wide_lcp);
+  }
+
+  int rc = SuffixTree_euler_walk(tree, SuffixTree_get_root(tree), lce_node_func,
+                                 &walk_data, 0);
+  check(rc == 0, "Euler walk of the suffix tree failed.");
+  check(walk_data.num_ranked == num_ranks, "Found %zu leaves, but expected %zu.",
+        walk_data.num_ranked, num_ranks);
+
+  if(walk_data.lcp) {
+    return LCE_create(walk_data.ranks, walk_data.lcp, length, num_ranks);
+  }
+  return LCE_create_wide(walk_data.wide_ranks, walk_data.wide_lcp, length,
+                         num_ranks);
+
+error:
+  if(walk_data.ranks) free(walk_data.ranks);
+  if(walk_data.lcp) free(walk_data.lcp);
+  if(walk_data.wide_ranks) free(walk_data.wide_ranks);
+  if(walk_data.wide_lcp) free(walk_data.wide_lcp);
+  return NULL;
+}
+
+void LCE_delete(LCE_T* lce)
+{
+  if(!lce) return;
+
+  if(*lce) {
+    if((*lce)->ranks) free((*lce)->ranks);
+    if((*lce)->lcp) free((*lce)->lcp);
+    if((*lce)->wide_ranks) free((*lce)->wide_ranks);
+    if((*lce)->wide_lcp) free((*lce)->wide_lcp);
+    if((*lce)->block_minima) free((*lce)->block_minima);
+    SparseTable_delete(&(*lce)->block_table);
+    free(*lce);
+    *lce = NULL;
+  }
+}
+
+/* The minimum of min_val and lcp[start:end], using Python slice syntax. */
+static inline size_t scan_min(LCE_T lce, size_t start, size_t end, size_t min_val)
+{
+  size_t i = 0;
+
+  if(lce->lcp) {
+    for(i = start; i < end; i++) min_val = MIN(min_val, lce->lcp[i]);
+  } else {
+    for(i = start; i < end; i++) min_val = MIN(min_val, lce->wide_lcp[i]);
+  }
+  return min_val;
+}
+
+/* The minimum of lcp[start:end], using Python slice syntax. */
+size_t lcp_range_min(LCE_T lce, size_t start, size_t end)
+{
+  size_t start_block = start / LCE_BLOCK_LENGTH;
+  size_t end_block = (end - 1) / LCE_BLOCK_LENGTH;
+
+  if(end_block - start_block < 2) {
+    return scan_min(lce, start, end, (size_t)-1);
+  }
+
+  /* Scan the ends of the range, and look up the whole blocks between them. */
+  size_t min_val = scan_min(lce, start, (start_block + 1) * LCE_BLOCK_LENGTH,
+                            (size_t)-1);
+  min_val = scan_min(lce, end_block * LCE_BLOCK_LENGTH, end, min_val);
+  size_t min_block = SparseTable_lookup(lce->block_table, lce->block_minima,
+                                        start_block + 1, end_block);
+  return MIN(min_val, lce->block_minima[min_block]);
+}
+
+size_t LCE_lookup(LCE_T lce, size_t pos1, size_t pos2)
+{
+  if(pos1 == pos2) return lce->length - pos1;
+
+  size_t rank1 = rank_at(lce, pos1);
+  size_t rank2 = rank_at(lce, pos2);
+
+  /* The LCP of two suffixes is the smallest LCP of neighbors between them. */
+  return lcp_range_min(lce, MIN(rank1, rank2) + 1, MAX(rank1, rank2) + 1);
+}
+
+int LCE_lookup_batch(LCE_T lce, const size_t* pairs, size_t num_pairs,
+                     size_t* lengths)
+{
+  size_t start_rank[LCE_BATCH_SIZE];
+  size_t end_rank[LCE_BATCH_SIZE];
+  size_t batch_start = 0, k = 0;
+
+  check(pairs || num_pairs == 0, "Cannot look up LCEs without query pairs.");
+  check(lengths || num_pairs == 0, "Cannot look up LCEs without an output array.");
+
+  for(batch_start = 0; batch_start < num_pairs; batch_start += LCE_BATCH_SIZE) {
+    size_t batch_size = MIN(LCE_BATCH_SIZE, num_pairs - batch_start);
+    const size_t* batch_pairs = pairs + 2 * batch_start;
+
+    /* Request the ranks of the whole batch, then the LCPs and block minima
+     * the range minima will read, and only then compute anything. */
+    for(k = 0; k < 2 * batch_size; k++) {
+      if(lce->ranks) __builtin_prefetch(&lce->ranks[batch_pairs[k]]);
+      else __builtin_prefetch(&lce->wide_ranks[batch_pairs[k]]);
+    }
+    for(k = 0; k < batch_size; k++) {
+      size_t pos1 = batch_pairs[2 * k], pos2 = batch_pairs[2 * k + 1];
+      if(pos1 == pos2) {
+        start_rank[k] = end_rank[k] = 0;
+        continue;
+      }
+      size_t rank1 = rank_at(lce, pos1), rank2 = rank_at(lce, pos2);
+      start_rank[k] = MIN(rank1, rank2) + 1;
+      end_rank[k] = MAX(rank1, rank2) + 1;
+
+      size_t start_block = start_rank[k] / LCE_BLOCK_LENGTH;
+      size_t end_block = (end_rank[k] - 1) / LCE_BLOCK_LENGTH;
+      if(lce->lcp) {
+        __builtin_prefetch(&lce->lcp[start_rank[k]]);
+        __builtin_prefetch(&lce->lcp[end_rank[k] - 1]);
+      } else {
+        __builtin_prefetch(&lce->wide_lcp[start_rank[k]]);
+        __builtin_prefetch(&lce->wide_lcp[end_rank[k] - 1]);
+      }
+      if(end_block - start_block >= 2) {
+        SparseTable_prefetch(lce->block_table, start_block + 1, end_block);
+      }
+    }
+    for(k = 0; k < batch_size; k++) {
+      size_t pos1 = batch_pairs[2 * k];
+      if(start_rank[k] == end_rank[k]) {
+        lengths[batch_start + k] = lce->length - pos1;
+      } else {
+        lengths[batch_start + k] = lcp_range_min(lce, start_rank[k], end_rank[k]);
+      }
+    }
+  }
+
+  return 0;
+
+error:
+  return 1;
+}
+
+size_t LCE_get_length(LCE_T lce)
+{
+  return lce->length;
+}
+
+size_t LCE_get_rank(LCE_T lce, size_t pos)
+{
+  return rank_at(lce, pos);
+}
+
+size_t LCE_get_lcp(LCE_T lce, size_t rank)
+{
+  return lcp_at(lce, rank);
+}
+
+int LCE_verify(LCE_T lce, const char* str)
+{
+  size_t length = lce->length;
+  size_t i = 0, j = 0;
+
+  size_t step = length > 300 ? length / 300 : 1;
+  for(i = 0; i < length; i += step) {
+    for(j = 0; j < length; j += step) {
+      size_t common = 0;
+      while(i + common < length && j + common < length &&
+            str[i + common] == str[j + common]) {
+        common++;
+      }
+      size_t observed = LCE_lookup(lce, i, j);
+      if(observed != common) {
+        log_warn("LCE of %zu and %zu should be %zu, but it is %zu.", i, j,
+                 common, observed);
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
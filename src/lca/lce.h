@@ -0,0 +1,125 @@
+#ifndef _lce_H_
+#define _lce_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "suffix_tree/suffix_tree.h"
+
+/* LCE means longest common extension. */
+
+/* TYPES */
+
+/*
+ * An LCE_T answers, for two positions of a string, how many characters the
+ * suffixes starting there have in common. It is keyed directly by position:
+ * a query reads the rank of each suffix from a flat array and takes a range
+ * minimum over the LCPs of suffixes adjacent in rank, so no tree nodes are
+ * touched.
+ *
+ * The suffixes can be ranked in lexicographic order, as in a suffix array, or
+ * in the order a depth-first walk of a suffix tree reaches their leaves. Any
+ * such order works, because the suffixes ranked between two suffixes all
+ * share at least as long a prefix with both as they share with each other.
+ *
+ * Lookups don't modify the LCE_T, so one can be queried from many threads at
+ * once.
+ */
+typedef struct LCE_T* LCE_T;
+
+/* FUNCTIONS */
+
+/*
+ * Create an LCE_T from ranks and LCPs that have already been computed. The
+ * LCE_T takes ownership of both arrays and frees them when it is deleted, or
+ * right away if creation fails.
+ *
+ * Params:
+ *  uint32_t* ranks       :   The rank of the suffix at each position of the
+ *                            string, length entries
+ *  uint32_t* lcp         :   For each rank r > 0, the length of the longest
+ *                            common prefix of the suffixes with ranks r - 1
+ *                            and r. num_ranks entries.
+ *  size_t length         :   The length of the string
+ *  size_t num_ranks      :   The number of ranked suffixes. This is at least
+ *                            length, and more if the string was terminated by
+ *                            characters that shouldn't be queried.
+ *
+ * Returns:
+ *  The LCE_T, or NULL on failure.
+ */
+LCE_T  LCE_create(uint32_t* ranks, uint32_t* lcp, size_t length, size_t num_ranks);
+
+/*
+ * LCE_create with 64-bit ranks and LCPs, for strings with UINT32_MAX or more
+ * ranked suffixes.
+ */
+LCE_T  LCE_create_wide(uint64_t* ranks, uint64_t* lcp, size_t length,
+                       size_t num_ranks);
+
+/*
+ * Create an LCE_T for the string of a suffix tree by ranking the leaves in
+ * the order of a depth-first walk. The tree isn't needed afterwards. Ranks
+ * and LCPs are stored in 32 bits when the tree's string is shorter than
+ * UINT32_MAX, and in 64 bits otherwise, so there is no limit on its length.
+ *
+ * Returns:
+ *  The LCE_T, or NULL on failure.
+ */
+LCE_T  LCE_create_from_suffix_tree(SuffixTree_T tree);
+
+/*
+ * Delete the LCE_T, freeing all allocated memory.
+ */
+void   LCE_delete(LCE_T* lce);
+
+/*
+ * Get the length of the longest common prefix of the suffixes starting at
+ * pos1 and pos2. If pos1 == pos2, this is the length of the suffix.
+ */
+size_t LCE_lookup(LCE_T lce, size_t pos1, size_t pos2);
+
+/*
+ * Do LCE_lookup for many pairs of positions, overlapping the memory accesses
+ * of batches of pairs.
+ *
+ * Params:
+ *  LCE_T lce             :   The LCE_T to query.
+ *  const size_t* pairs   :   2 * num_pairs positions. The pair i is pairs[2*i]
+ *                            and pairs[2*i+1].
+ *  size_t num_pairs      :   The number of pairs.
+ *  size_t* lengths       :   Filled with the LCE of each pair. Must have room
+ *                            for num_pairs values.
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+int    LCE_lookup_batch(LCE_T lce, const size_t* pairs, size_t num_pairs,
+                        size_t* lengths);
+
+/*
+ * Get the length of the string the LCE_T was created for.
+ */
+size_t LCE_get_length(LCE_T lce);
+
+/*
+ * Get the rank of the suffix that starts at a position of the string.
+ */
+size_t LCE_get_rank(LCE_T lce, size_t pos);
+
+/*
+ * Get the length of the longest common prefix of the suffix with a rank and
+ * the suffix with the rank before it. The LCP of rank 0 is 0.
+ */
+size_t LCE_get_lcp(LCE_T lce, size_t rank);
+
+/*
+ * Compare every lookup, or a sample of them for long strings, against a
+ * character-by-character comparison of str.
+ *
+ * Returns:
+ *  0 if tests pass, else 1.
+ */
+int    LCE_verify(LCE_T lce, const char* str);
+
+#endif
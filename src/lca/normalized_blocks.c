@@ -1,3 +1,4 @@
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "normalized_blocks_private.h"
@@ -7,192 +8,26 @@
 #define MAX(a,b) ((a) > (b) ? a : b)
 #define MIN(a,b) ((a) < (b) ? a : b)
 
-struct BlockRMQTable_T {
-  size_t** table;
-  size_t   block_size;
-};
-
+/*
+ * The database answers queries on a block from bitmasks, in the style of
+ * Fischer and Heun. Scanning a block left to right while keeping a stack of
+ * the positions whose values are smaller than everything after them, the
+ * minimum of block[i:j] is the lowest stack position at or after i once
+ * position j - 1 has been pushed. Each stack fits in one word, so a lookup is
+ * a shift and a count of trailing zeros.
+ *
+ * The stacks depend only on the +-1 pattern of the block, so they are
+ * computed once for every pattern when the database is created.
+ */
 struct BlockRMQDatabase_T {
   size_t            block_size;
-  int               num_blocks;
-  int*              is_initialized;
-  BlockRMQTable_T*  block_tables;
-
-  BlockRMQTable_T   remainder_block_table;
-  size_t            remainder_block_id;
-  int               remainder_is_initialized;
+  size_t            num_block_ids;
+  /* block_size masks for each block id. Bit k of the mask for position j is
+   * set if position k is on the stack after position j is pushed. */
+  uint32_t*         stack_masks;
 };
 
 
-/* 
- * Create a BlockRMQTable_T that can perform a range minimum query on a block in
- * nlogn time.
- * 
- * Input:
- *  size_t* block       :     Block for which RMQ table will be created
- *  size_t block_size   :     Size of block
- * 
- * Output:
- *  BlockRMQTable_T, the created lookup table.
- */
-BlockRMQTable_T BlockRMQTable_create(const size_t* block, size_t block_size)
-{
-  BlockRMQTable_T block_rmq_table = calloc(1, sizeof(struct BlockRMQTable_T));
-  check_mem(block_rmq_table);
-
-  block_rmq_table->block_size = block_size;
-  
-  /* Allocate the lookup table */
-  block_rmq_table->table = calloc(block_size, sizeof(size_t*));
-  check_mem(block_rmq_table->table);
-
-  size_t i = 0;
-  for(i = 0; i < block_size; i++) {
-    block_rmq_table->table[i] = calloc(block_size - i, sizeof(size_t));
-    check_mem(block_rmq_table->table[i]);
-  }
-  
-  /* Populate the table using dynamic programming */ 
-  size_t j = 0;
-  for(i = 0; i < block_size; i++) {
-    for(j = 0; j < block_size - i; j++) {
-      size_t j_pos_in_block = j + i + 1;
-      
-      /* The min pos in [i:i+1] is just i */
-      if(j_pos_in_block - i == 1) {
-        block_rmq_table->table[i][j] = i;
-        continue;
-      }
-      
-      /* Otherwise we just compare [i:j-i] and j */
-      size_t prev_min_val = block[block_rmq_table->table[i][j-1]];
-      size_t curr_min_val = block[j_pos_in_block - 1];
-      if(prev_min_val <= curr_min_val) {
-        block_rmq_table->table[i][j] = block_rmq_table->table[i][j-1];
-      } else {
-        block_rmq_table->table[i][j] = j_pos_in_block - 1;
-      }
-    }
-  }
-  return block_rmq_table;
-
-error:
-  BlockRMQTable_delete(&block_rmq_table);
-  return NULL;
-}
-
-void BlockRMQTable_delete(BlockRMQTable_T* block_rmq_table)
-{
-  if(!block_rmq_table) return;
-
-  if(*block_rmq_table) {
-    if((*block_rmq_table)->table) {
-      size_t i = 0;
-      for(i = 0; i < (*block_rmq_table)->block_size; i++) {
-        if((*block_rmq_table)->table[i]) free((*block_rmq_table)->table[i]);
-      }
-      free((*block_rmq_table)->table);
-    }
-    free(*block_rmq_table);
-  }
-}
-
-
-/* 
- * Find the position of the minimum element in a block. The block itself isn't
- * needed because we've already created the lookup table for the block.
- *
- * Input:
- *  BlockRMQTable_T block_rmq_table   :  Table for the block
- *  size_t i                          :  Start pos for RMQ
- *  size_t j                          :  End pos for RMQ
- *  
- * Output:
- *  size_t, position of minimum element in [i:j] in the block.
- */ 
-size_t BlockRMQTable_lookup(BlockRMQTable_T block_rmq_table, size_t i, size_t j)
-{
-  check(j != i, "Cannot find maximum in empty range [%zu:%zu]", i, j);
-  
-  size_t start = MIN(i, j);
-  size_t end = MAX(i, j);
-  
-  check(end <= block_rmq_table->block_size,
-        "Cannot look past end of block for BlockRMQTable lookup. Block size "
-        "is %zu, but j is %zu", block_rmq_table->block_size, j);
-  
-  size_t end_pos_in_table = end - start - 1;
-  return block_rmq_table->table[start][end_pos_in_table];
-
-error:
-  return (size_t)-1;
-}
-
-/* Print a BlockRMQTable. */
-void BlockRMQTable_print(BlockRMQTable_T block_rmq_table)
-{
-  printf("BlockRMQTable for block of size %zu:\n", block_rmq_table->block_size);
-
-  size_t i = 0;
-  size_t j = 0;
-  for(i = 0; i < block_rmq_table->block_size; i++) {
-    for(j = 0; j < i; j++) {
-      printf("    ");
-    }
-    for(j = 0; j < block_rmq_table->block_size -  i - 1; j++) {
-      size_t t_val = block_rmq_table->table[i][j];
-      if(t_val < 10) {
-        printf("   %zu", t_val);
-      } else if(t_val < 100) {
-        printf("  %zu", t_val);
-      } else {
-        printf(" %zu", t_val);
-      }
-    }
-    printf("\n");
-  }
-}
-
-/* 
- * Test a BlockRMQTable_T by checking its returned minimum elements against the
- * minimum elements calculated by checking all values in the interval.
- */
-int BlockRMQTable_verify(BlockRMQTable_T block_rmq_table, const size_t* block)
-{
-  size_t i = 0;
-  size_t j = 0;
-  
-  for(i = 0; i <= block_rmq_table->block_size; i++) {
-    for(j = 0; j <= block_rmq_table->block_size; j++) {
-      /* j == i won't work */
-      if(j == i) continue;
-
-      /* Find the minimum by iterating over the whole range. */
-      size_t min_val = (size_t)-1;
-      size_t min_pos = 0;
-
-      size_t start = MIN(i, j);
-      size_t end = MAX(i, j);
-      size_t pos = 0;
-      for(pos = start; pos < end; pos++) {
-        if(block[pos] <= min_val) {
-          min_val = block[pos];
-          min_pos = pos;
-        }
-      }
-      
-      size_t test_pos = BlockRMQTable_lookup(block_rmq_table, i, j);
-      if(test_pos != min_pos) {
-        log_warn("Min element position in [%zu:%zu] should be %zu, but "
-                 "BlockRMQTable_lookup returned %zu.", i, j, min_pos, test_pos);
-        return 1;
-      }
-    }
-  }
-
-  return 0;
-}
-
 /* 
  * Get an index for a block. Every block has the +-1 property, meaning that
  * each abs(B[j+i] - B[j]) = 1 for each j. Get an index by assigning a 1 for
@@ -221,9 +56,46 @@ unsigned int get_block_id(const size_t* block, size_t block_size)
   return block_id;
 }
 
+unsigned int get_padded_block_id(const size_t* block, size_t block_size,
+                                 size_t full_block_size)
+{
+  return get_block_id(block, block_size) << (full_block_size - block_size);
+}
+
+/*
+ * Fill in the stack masks for one block id, following the +-1 steps its bits
+ * describe.
+ */
+void fill_stack_masks(uint32_t* masks, unsigned int block_id, size_t block_size)
+{
+  size_t values[32];
+  uint32_t stack = 0;
+  size_t k = 0;
+
+  values[0] = block_size;
+  for(k = 0; k + 1 < block_size; k++) {
+    if(block_id & (1u << (block_size - k - 2))) {
+      values[k + 1] = values[k] + 1;
+    } else {
+      values[k + 1] = values[k] - 1;
+    }
+  }
+
+  for(k = 0; k < block_size; k++) {
+    /* Pop the positions with larger values. Equal values stay, so the
+     * leftmost of several minima wins. */
+    while(stack && values[31 - __builtin_clz(stack)] > values[k]) {
+      stack &= ~(1u << (31 - __builtin_clz(stack)));
+    }
+    stack |= 1u << k;
+    masks[k] = stack;
+  }
+}
+
 /*
  * Create a BlockRMQDatabase struct that can be used to perform RMQs on +-1
- * blocks of a given block_size.
+ * blocks of a given block_size. Blocks can be at most 32 long, which is
+ * enough for Euler tours of any tree that fits in memory.
  */
 BlockRMQDatabase_T BlockRMQDatabase_create(size_t block_size)
 {
@@ -233,17 +105,20 @@ BlockRMQDatabase_T BlockRMQDatabase_create(size_t block_size)
 
   block_rmq_db->block_size = block_size;
   check(block_size > 0, "Cannot create BlockRMQDatabase for empty blocks.");
-  block_rmq_db->num_blocks = 1 << (block_size - 1);
-  
-  block_rmq_db->is_initialized = calloc(block_rmq_db->num_blocks, sizeof(int));
-  check_mem(block_rmq_db->is_initialized);
+  check(block_size <= 32, "Cannot create BlockRMQDatabase for blocks of length "
+        "%zu.", block_size);
+  block_rmq_db->num_block_ids = (size_t)1 << (block_size - 1);
+
+  block_rmq_db->stack_masks = malloc(block_rmq_db->num_block_ids * block_size *
+                                     sizeof(uint32_t));
+  check_mem(block_rmq_db->stack_masks);
+
+  size_t block_id = 0;
+  for(block_id = 0; block_id < block_rmq_db->num_block_ids; block_id++) {
+    fill_stack_masks(block_rmq_db->stack_masks + block_id * block_size,
+                     block_id, block_size);
+  }
 
-  block_rmq_db->block_tables = calloc(block_rmq_db->num_blocks, sizeof(BlockRMQTable_T));
-  check_mem(block_rmq_db->block_tables);
-  
-  block_rmq_db->remainder_block_table = NULL;
-  block_rmq_db->remainder_block_id  = 0;
-  block_rmq_db->remainder_is_initialized = 0; 
   return block_rmq_db;
 
 error:
@@ -251,6 +126,13 @@ error:
   return NULL;
 }
 
+size_t BlockRMQDatabase_lookup_by_id(BlockRMQDatabase_T block_rmq_db,
+                                     unsigned int block_id, size_t i, size_t j)
+{
+  uint32_t stack = block_rmq_db->stack_masks[block_id * block_rmq_db->block_size + j - 1];
+  return __builtin_ctz(stack >> i) + i;
+}
+
 /* 
  * Perform a range minimum query using the BlockRMQDatabase.
  *
@@ -270,44 +152,19 @@ size_t BlockRMQDatabase_lookup(BlockRMQDatabase_T block_rmq_db, const size_t* bl
   check(block_size <= block_rmq_db->block_size,
         "Block size %zu is greater than the DB block size %zu.",
         block_size,  block_rmq_db->block_size);
+  check(j != i, "Cannot find minimum in empty range [%zu:%zu]", i, j);
 
-  unsigned int block_id = get_block_id(block, block_size);
-  
-  if(block_size < block_rmq_db->block_size) {
-    /* We may be dealing with the remainder block. If we haven't see the
-     * remainder yet, then just initialize it.*/
-    if(!block_rmq_db->remainder_is_initialized) {
-
-      check(!block_rmq_db->remainder_block_table,
-            "Attempting to initialize remainder block table twice.");
-      block_rmq_db->remainder_block_table = BlockRMQTable_create(block, block_size);
-      block_rmq_db->remainder_is_initialized = 1;
-      block_rmq_db->remainder_block_id = get_block_id(block, block_size);
-    }
-
-    /* If we have seen the remainder, we need to make sure that this block is
-     * the same. The remainder block is always the same block. */
-    check(get_block_id(block, block_size) == block_rmq_db->remainder_block_id,
-          "Remainder block with different id than the first.");
-    return BlockRMQTable_lookup(block_rmq_db->remainder_block_table, i, j);
-  }
-
-  /* Create the block table if it doesn't exist yet. */
-  if(!block_rmq_db->is_initialized[block_id]) {
-    check(!block_rmq_db->block_tables[block_id],
-          "Attempting to initialize block %u twice.",
-          block_id);
-
-    block_rmq_db->block_tables[block_id] = BlockRMQTable_create(block, block_size);
-    check(block_rmq_db->block_tables[block_id], "Block table creation failed.");
-
-    block_rmq_db->is_initialized[block_id] = 1;
-  }
-  
-  BlockRMQTable_T block_rmq_table = block_rmq_db->block_tables[block_id];
-  check(block_rmq_table, "BlockRMQTable not initialized.");
+  size_t start = MIN(i, j);
+  size_t end = MAX(i, j);
+  check(end <= block_size,
+        "Cannot look past end of block for BlockRMQDatabase lookup. Block size "
+        "is %zu, but j is %zu", block_size, end);
 
-  return BlockRMQTable_lookup(block_rmq_table, i, j);
+  /* A short block, like the last block of a tour, has the same stacks as any
+   * full block that starts with the same steps. */
+  unsigned int block_id = get_padded_block_id(block, block_size,
+                                              block_rmq_db->block_size);
+  return BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, start, end);
 
 error:
   return (size_t)-1;
@@ -316,66 +173,58 @@ error:
 /* Free a BlockRMQDatabase. */
 void BlockRMQDatabase_delete(BlockRMQDatabase_T* block_rmq_db)
 {
-  if(*block_rmq_db) {
-    if((*block_rmq_db)->is_initialized) {
-      if((*block_rmq_db)->block_tables) {
-        int i;
-        for(i = 0; i < (*block_rmq_db)->num_blocks; i++) {
-          if((*block_rmq_db)->is_initialized[i] &&
-             (*block_rmq_db)->block_tables[i]) {
+  if(!block_rmq_db) return;
 
-            BlockRMQTable_delete(&((*block_rmq_db)->block_tables[i]));
-          }
-        }
-        free((*block_rmq_db)->block_tables);
-      }
-      free((*block_rmq_db)->is_initialized);
-    }
-    if((*block_rmq_db)->remainder_block_table)
-      BlockRMQTable_delete(&((*block_rmq_db)->remainder_block_table));
+  if(*block_rmq_db) {
+    if((*block_rmq_db)->stack_masks) free((*block_rmq_db)->stack_masks);
     free(*block_rmq_db);
+    *block_rmq_db = NULL;
   }
 }
-      
-/* Test BlockRMQDatabase lookups in a given DB. */
+
+/*
+ * Test BlockRMQDatabase lookups in a given DB by building a block for every
+ * block id and comparing every range against a scan of the block.
+ */
 int BlockRMQDatabase_verify(BlockRMQDatabase_T block_rmq_db)
 {
-
-  int i = 0;
-  for(i = 0; i < block_rmq_db->num_blocks; i++) {
-
-    size_t block[block_rmq_db->block_size];
-
-    /* Initialize the block values so we're sure we won't end up <0. */
-    size_t j = 0;
-    for(j = 0; j < block_rmq_db->block_size; j++) {
-      block[j] = block_rmq_db->block_size + 2;
-    }
-    
-    /* Create a block that corresponds to the block_id given by j. */
-    for(j = 0; j < block_rmq_db->block_size - 1; j++) {
-      if(j | (i << (block_rmq_db->block_size - 2 - j))) {
-        block[j+1] = block[j] + 1;
+  size_t block_size = block_rmq_db->block_size;
+  size_t block[32];
+  size_t block_id = 0;
+
+  for(block_id = 0; block_id < block_rmq_db->num_block_ids; block_id++) {
+
+    /* Start high enough that the block can't go below zero. */
+    size_t k = 0;
+    block[0] = block_size;
+    for(k = 0; k + 1 < block_size; k++) {
+      if(block_id & (1u << (block_size - k - 2))) {
+        block[k + 1] = block[k] + 1;
       } else {
-        block[j+1] = block[j] - 1;
+        block[k + 1] = block[k] - 1;
       }
     }
-    
-    /* Do the lookup twice. The first might initialize, the second is
-     * guaranteed not to. Want to check both. */
-    size_t ret = BlockRMQDatabase_lookup(block_rmq_db, block, block_rmq_db->block_size,
-                                         0, block_rmq_db->block_size);
-    if(ret == (size_t)-1) {
-      log_warn("BlockRMQDatabase_lookup failed.");
+
+    if(get_padded_block_id(block, block_size, block_size) != block_id) {
+      log_warn("Block built for id %zu has a different id.", block_id);
       return 1;
     }
-    ret = BlockRMQDatabase_lookup(block_rmq_db, block, block_rmq_db->block_size,
-                                  0, block_rmq_db->block_size);
-    if(ret == (size_t)-1) {
-      log_warn("BlockRMQDatabase_lookup failed.");
-      return 1;
+
+    size_t i = 0, j = 0;
+    for(i = 0; i < block_size; i++) {
+      size_t min_pos = i;
+      for(j = i + 1; j <= block_size; j++) {
+        if(block[j - 1] < block[min_pos]) min_pos = j - 1;
+
+        size_t ret = BlockRMQDatabase_lookup(block_rmq_db, block, block_size, i, j);
+        if(ret != min_pos) {
+          log_warn("Min element position in [%zu:%zu] of block %zu should be "
+                   "%zu, but BlockRMQDatabase_lookup returned %zu.", i, j,
+                   block_id, min_pos, ret);
+          return 1;
+        }
+      }
     }
   }
   return 0;
 }
-
@@ -13,6 +13,23 @@ size_t             BlockRMQDatabase_lookup(BlockRMQDatabase_T block_rmq_db,
                                            const size_t* block,
                                            size_t block_size,
                                            size_t i, size_t j);
+
+/*
+ * Find the position of the minimum of block[i:j] for a block whose id has
+ * already been found with get_padded_block_id. Requires i < j <= the length
+ * of the block. Nothing is checked, so this is the one to call when queries
+ * are many.
+ */
+size_t             BlockRMQDatabase_lookup_by_id(BlockRMQDatabase_T block_rmq_db,
+                                                 unsigned int block_id,
+                                                 size_t i, size_t j);
 int                BlockRMQDatabase_verify(BlockRMQDatabase_T block_rmq_db);
 
+/*
+ * Get the id of a +-1 block in a database for blocks of full_block_size. A
+ * block can be shorter than that, like the last block of a partition.
+ */
+unsigned int       get_padded_block_id(const size_t* block, size_t block_size,
+                                       size_t full_block_size);
+
 #endif
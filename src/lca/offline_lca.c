@@ -0,0 +1,170 @@
+/*
+ * Tarjan's offline lowest common ancestor algorithm, from "Applications of
+ * Path Compression on Balanced Trees" by Robert E. Tarjan.
+ *
+ * The walk is SuffixTree_euler_walk, which calls the node function when it
+ * enters a node and again each time it comes back to the node from a child.
+ * The node visited just before such a return is the child whose subtree was
+ * just finished, so that is when the child's set is merged into the parent's.
+ */
+
+#include <stdint.h>
+
+#include "offline_lca.h"
+
+#include "utils/dbg.h"
+
+struct OfflineLCAWalkData {
+  /* Union-find parent of each node, by node index */
+  uint32_t*      set_parents;
+  /* Union-find rank of each set root */
+  unsigned char* set_ranks;
+  /* The shallowest node of each set, for set roots */
+  Node_T*        ancestors;
+  /* Whether each node has been entered */
+  unsigned char* visited;
+
+  /* The pairs that mention each node, as the index of the other node in the
+   * pairs array, in the style of a compressed sparse row matrix. The pairs of
+   * node n are pair_lists[pair_list_starts[n]:pair_list_starts[n+1]]. */
+  size_t*        pair_list_starts;
+  size_t*        pair_lists;
+
+  const Node_T*  pairs;
+  Node_T*        lcas;
+  Node_T         previous_node;
+};
+
+/* Find the root of the set of a node, halving the path on the way. */
+static inline uint32_t find_set(uint32_t* set_parents, uint32_t node_index)
+{
+  while(set_parents[node_index] != node_index) {
+    set_parents[node_index] = set_parents[set_parents[node_index]];
+    node_index = set_parents[node_index];
+  }
+  return node_index;
+}
+
+/* Merge two sets by rank, returning the root of the merged set. */
+static inline uint32_t union_sets(struct OfflineLCAWalkData* data,
+                                  uint32_t root1, uint32_t root2)
+{
+  if(root1 == root2) return root1;
+  if(data->set_ranks[root1] < data->set_ranks[root2]) {
+    data->set_parents[root1] = root2;
+    return root2;
+  }
+  data->set_parents[root2] = root1;
+  if(data->set_ranks[root1] == data->set_ranks[root2]) data->set_ranks[root1]++;
+  return root1;
+}
+
+/* The NodeFunc_T for the walk. */
+SuffixTreeIndex_T offline_lca_node_func(SuffixTree_T tree, Node_T node,
+                                        void* vdata, SuffixTreeIndex_T counter)
+{
+  (void)tree;
+  struct OfflineLCAWalkData* data = vdata;
+  uint32_t node_index = Node_get_index(node);
+
+  if(data->visited[node_index]) {
+    /* Back from a child. Its subtree is done, so fold it into this one. */
+    uint32_t child_index = Node_get_index(data->previous_node);
+    uint32_t root = union_sets(data, find_set(data->set_parents, node_index),
+                               find_set(data->set_parents, child_index));
+    data->ancestors[root] = node;
+    data->previous_node = node;
+    return counter;
+  }
+
+  data->visited[node_index] = 1;
+  data->ancestors[node_index] = node;
+
+  /* Answer each pair whose other node has been entered already. If it is
+   * still on the path to this node, its set is its own; if not, its set was
+   * merged up to the deepest node on the path above it. */
+  size_t k = 0;
+  for(k = data->pair_list_starts[node_index];
+      k < data->pair_list_starts[node_index + 1]; k++) {
+    size_t other = data->pair_lists[k];
+    uint32_t other_index = Node_get_index(data->pairs[other]);
+    if(data->visited[other_index]) {
+      data->lcas[other / 2] = data->ancestors[find_set(data->set_parents, other_index)];
+    }
+  }
+
+  data->previous_node = node;
+  return counter;
+}
+
+int OfflineLCA_find(SuffixTree_T tree, const Node_T* pairs, size_t num_pairs,
+                    Node_T* lcas)
+{
+  struct OfflineLCAWalkData data = {0};
+  size_t i = 0;
+
+  check(tree, "Cannot find LCAs without a tree.");
+  check(pairs || num_pairs == 0, "Cannot find LCAs without query pairs.");
+  check(lcas || num_pairs == 0, "Cannot find LCAs without an output array.");
+
+  size_t num_nodes = SuffixTree_get_num_nodes(tree);
+  check(num_nodes < UINT32_MAX, "Tree with %zu nodes is too large.", num_nodes);
+
+  data.set_parents = malloc(num_nodes * sizeof(uint32_t));
+  check_mem(data.set_parents);
+  data.set_ranks = calloc(num_nodes, sizeof(unsigned char));
+  check_mem(data.set_ranks);
+  data.ancestors = malloc(num_nodes * sizeof(Node_T));
+  check_mem(data.ancestors);
+  data.visited = calloc(num_nodes, sizeof(unsigned char));
+  check_mem(data.visited);
+  data.pair_list_starts = calloc(num_nodes + 1, sizeof(size_t));
+  check_mem(data.pair_list_starts);
+  data.pair_lists = malloc((2 * num_pairs + 1) * sizeof(size_t));
+  check_mem(data.pair_lists);
+
+  for(i = 0; i < num_nodes; i++) {
+    data.set_parents[i] = i;
+  }
+
+  /* Each pair goes in the list of both of its nodes, pointing at the other.
+   * Count the pairs of each node, turn the counts into starts, then fill. */
+  for(i = 0; i < 2 * num_pairs; i++) {
+    data.pair_list_starts[Node_get_index(pairs[i]) + 1]++;
+  }
+  for(i = 0; i < num_nodes; i++) {
+    data.pair_list_starts[i + 1] += data.pair_list_starts[i];
+  }
+  for(i = 0; i < 2 * num_pairs; i++) {
+    size_t node_index = Node_get_index(pairs[i]);
+    data.pair_lists[data.pair_list_starts[node_index]++] = i ^ 1;
+  }
+  for(i = num_nodes; i > 0; i--) {
+    data.pair_list_starts[i] = data.pair_list_starts[i - 1];
+  }
+  data.pair_list_starts[0] = 0;
+
+  data.pairs = pairs;
+  data.lcas = lcas;
+
+  int rc = SuffixTree_euler_walk(tree, SuffixTree_get_root(tree),
+                                 offline_lca_node_func, &data, 0);
+  check(rc == 0, "Euler walk of the suffix tree failed.");
+
+  free(data.set_parents);
+  free(data.set_ranks);
+  free(data.ancestors);
+  free(data.visited);
+  free(data.pair_list_starts);
+  free(data.pair_lists);
+  return 0;
+
+error:
+  if(data.set_parents) free(data.set_parents);
+  if(data.set_ranks) free(data.set_ranks);
+  if(data.ancestors) free(data.ancestors);
+  if(data.visited) free(data.visited);
+  if(data.pair_list_starts) free(data.pair_list_starts);
+  if(data.pair_lists) free(data.pair_lists);
+  return 1;
+}
@@ -0,0 +1,39 @@
+#ifndef _offline_lca_H_
+#define _offline_lca_H_
+
+#include <stdlib.h>
+#include "suffix_tree/suffix_tree.h"
+
+/* LCA means lowest common ancestor. */
+
+/* FUNCTIONS */
+
+/*
+ * Find the lowest common ancestors of a set of node pairs that is known in
+ * advance, with Tarjan's offline algorithm. One depth-first walk of the tree
+ * merges each finished subtree into its parent in a union-find structure, and
+ * a pair is answered when the walk reaches its second node: the answer is the
+ * ancestor recorded for the set of the first.
+ *
+ * This works on a plain SuffixTree_T, so none of the tables of an
+ * LCASuffixTree_T are built. It needs about 22 bytes per node of the tree and
+ * 16 bytes per pair, on top of the pairs and answers. It is the better choice
+ * when all queries are known up front and the tree won't be queried again;
+ * an LCASuffixTree_T is better when queries arrive one at a time or the same
+ * tree is queried many times over.
+ *
+ * Params:
+ *  SuffixTree_T tree       :   Tree containing the query nodes.
+ *  const Node_T* pairs     :   2 * num_pairs nodes. The pair i is pairs[2*i]
+ *                              and pairs[2*i+1].
+ *  size_t num_pairs        :   The number of pairs.
+ *  Node_T* lcas            :   Filled with the lowest common ancestor of each
+ *                              pair. Must have room for num_pairs nodes.
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+int OfflineLCA_find(SuffixTree_T tree, const Node_T* pairs, size_t num_pairs,
+                    Node_T* lcas);
+
+#endif
@@ -1,4 +1,5 @@
-#include <math.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -9,12 +10,58 @@
 #define MAX(a,b) ((a) > (b) ? a : b)
 #define MIN(a,b) ((a) < (b) ? a : b)
 
+/*
+ * Level k of the table holds, for each start position i with a full window
+ * array[i:i+2^k], the offset from i of the minimum of that window. An offset
+ * at level k is less than 2^k, so levels up to 8 store one byte per entry,
+ * levels up to 16 two bytes, and the rest four. Level 0 would hold only
+ * zeros, so it isn't stored. All levels live one after another in a single
+ * allocation, so a lookup reads one entry from one level twice over.
+ */
 struct SparseTable_T {
-  size_t**  table;
-  size_t    nrows;
-  size_t    ncols;
+  /* The levels, one after another */
+  unsigned char*  table;
+  /* The byte offset of each level in table. Index 0 is unused. */
+  size_t*         level_starts;
+  size_t          num_levels;
+  size_t          array_size;
 };
 
+/* The floor of log2(x), for x > 0 */
+static inline size_t floor_log2(size_t x)
+{
+  return sizeof(size_t) * CHAR_BIT - 1 - __builtin_clzl(x);
+}
+
+/* The number of bytes in each entry of a level */
+static inline size_t level_width(size_t level)
+{
+  return level <= 8 ? 1 : (level <= 16 ? 2 : 4);
+}
+
+/* Read the offset of the minimum of array[i:i+2^level] from i. */
+static inline size_t get_offset(const struct SparseTable_T* sparse_table,
+                                size_t level, size_t i)
+{
+  const unsigned char* row = sparse_table->table + sparse_table->level_starts[level];
+  if(level <= 8) return row[i];
+  if(level <= 16) return ((const uint16_t*)row)[i];
+  return ((const uint32_t*)row)[i];
+}
+
+static inline void set_offset(struct SparseTable_T* sparse_table, size_t level,
+                              size_t i, size_t offset)
+{
+  unsigned char* row = sparse_table->table + sparse_table->level_starts[level];
+  if(level <= 8) {
+    row[i] = offset;
+  } else if(level <= 16) {
+    ((uint16_t*)row)[i] = offset;
+  } else {
+    ((uint32_t*)row)[i] = offset;
+  }
+}
+
 /* Create a SparseTable struct from an array.
  *
  * Inputs:
@@ -26,58 +73,49 @@ struct SparseTable_T {
  */
 SparseTable_T SparseTable_create(const size_t* array, size_t array_size)
 {
-  check(array_size > 0, "Cannot create a sparse table from an empty array.");
   SparseTable_T sparse_table = NULL;
+  check(array_size > 0, "Cannot create a sparse table from an empty array.");
+  check(array_size <= UINT32_MAX, "Cannot create a sparse table for an array "
+        "of %zu elements.", array_size);
 
-  sparse_table = malloc(sizeof(struct SparseTable_T));
+  sparse_table = calloc(1, sizeof(struct SparseTable_T));
   check_mem(sparse_table);
 
-  /* Get the size of the table. */
-  sparse_table->nrows = array_size;
-  sparse_table->ncols = (size_t)ceil(log2(array_size));
-  
-  /* Allocate the table */
-  sparse_table->table = calloc(sparse_table->nrows, sizeof(size_t*));
-  check_mem(sparse_table->table);
-
-  size_t i = 0;
-  size_t j = 0;
-  for(i = 0; i < sparse_table->nrows; i++) {
-    sparse_table->table[i] = calloc(sparse_table->ncols, sizeof(size_t));
-    check_mem(sparse_table->table[i]);
+  /* Level k exists if there is a window of length 2^k. */
+  sparse_table->array_size = array_size;
+  sparse_table->num_levels = floor_log2(array_size) + 1;
+
+  sparse_table->level_starts = calloc(sparse_table->num_levels, sizeof(size_t));
+  check_mem(sparse_table->level_starts);
+
+  /* Lay out the levels, keeping each one aligned for its entry width. */
+  size_t level = 0;
+  size_t table_size = 0;
+  for(level = 1; level < sparse_table->num_levels; level++) {
+    size_t width = level_width(level);
+    table_size = (table_size + width - 1) / width * width;
+    sparse_table->level_starts[level] = table_size;
+    table_size += (array_size - ((size_t)1 << level) + 1) * width;
   }
 
-  /* Fill the table using dynamic programming. We can calculate [i, j] if we
-   * have the j - 1 column, so proceed by column. */
-  for(j = 0; j < sparse_table->ncols; j++) {
-    for(i = 0; i < sparse_table->nrows; i++) {
-
-      /* Simple case is the first column, that is, j == 0. That's the minimum
-       * element starting in [i:i+2^0], which is just i */
-      if(j == 0) {
-        sparse_table->table[i][j] = i;
-        continue;
-      }
+  sparse_table->table = malloc(MAX(table_size, 1));
+  check_mem(sparse_table->table);
 
-      /* This is the dynamic programming relation. Compare the minima of the
-       * two intervals of length 2^(j-1) that span this interval. */
+  /* Fill the table using dynamic programming. The window of length 2^k at i
+   * is the two windows of length 2^(k-1) at i and i + 2^(k-1). */
+  size_t i = 0;
+  for(level = 1; level < sparse_table->num_levels; level++) {
+    size_t half = (size_t)1 << (level - 1);
+    size_t num_windows = array_size - ((size_t)1 << level) + 1;
+    for(i = 0; i < num_windows; i++) {
+      size_t first_min_pos = i + (level == 1 ? 0 : get_offset(sparse_table, level - 1, i));
+      size_t second_min_pos = i + half +
+          (level == 1 ? 0 : get_offset(sparse_table, level - 1, i + half));
 
-      /* The first interval starts at i and has length 2^(j-1) */
-      size_t first_min_pos = sparse_table->table[i][j-1];
-      
-      /* The second interval needs to end at i + 2^j and have length 2(j-1), so
-       * it starts at 1 + 2^(j-1). This might run off the end of the array. If
-       * so, then we know the first_min_pos is the pos we're looking for. */
-      size_t second_start = i + (1  << (j - 1));
-      if(second_start >= sparse_table->nrows) {
-        sparse_table->table[i][j] = first_min_pos;
-        continue;
-      }
-      size_t second_min_pos = sparse_table->table[second_start][j - 1];
       if(array[first_min_pos] < array[second_min_pos]) {
-        sparse_table->table[i][j] = first_min_pos;
+        set_offset(sparse_table, level, i, first_min_pos - i);
       } else {
-        sparse_table->table[i][j] = second_min_pos;
+        set_offset(sparse_table, level, i, second_min_pos - i);
       }
     }
   }
@@ -94,19 +132,16 @@ void SparseTable_delete(SparseTable_T* sparse_table)
   if(sparse_table == NULL) return;
 
   if(*sparse_table) {
-    if((*sparse_table)->table) {
-      size_t i = 0;
-      for(i = 0; i < (*sparse_table)->nrows; i++) {
-        if((*sparse_table)->table[i]) free((*sparse_table)->table[i]);
-      }
-      free((*sparse_table)->table);
-    }
+    if((*sparse_table)->table) free((*sparse_table)->table);
+    if((*sparse_table)->level_starts) free((*sparse_table)->level_starts);
     free(*sparse_table);
+    *sparse_table = NULL;
   }
 }
 
 /*
- * Lookup a minimum value using a SparseTable.
+ * Lookup a minimum value using a SparseTable. If there are several minima,
+ * this finds the last one.
  * 
  * Inputs:
  *  SparseTable* sparse_table   :   The SparseTable create for the array
@@ -128,14 +163,11 @@ size_t SparseTable_lookup(SparseTable_T sparse_table,
 
   if(end - start == 1) return start;
 
-  size_t block_size = (size_t)floor(log2(end - start));
-  size_t first_min_pos = sparse_table->table[start][block_size];
-  
-  /* Handle the case where the second interval is off the end of the array. */
-  size_t second_start_pos = end - (1 << (block_size));
-  if(second_start_pos >= sparse_table->nrows) return first_min_pos;
-
-  size_t second_min_pos = sparse_table->table[second_start_pos][block_size];
+  /* Two windows of the largest power of two that fits cover the interval. */
+  size_t level = floor_log2(end - start);
+  size_t second_start = end - ((size_t)1 << level);
+  size_t first_min_pos = start + get_offset(sparse_table, level, start);
+  size_t second_min_pos = second_start + get_offset(sparse_table, level, second_start);
 
   if(array[first_min_pos] < array[second_min_pos]) {
     return first_min_pos;
@@ -147,6 +179,23 @@ error:
   return (size_t)-1;
 }
 
+/*
+ * Start loading the table entries that SparseTable_lookup(sparse_table, array,
+ * i, j) will read, without waiting for them.
+ */
+void SparseTable_prefetch(SparseTable_T sparse_table, size_t i, size_t j)
+{
+  size_t start = MIN(i, j);
+  size_t end = MAX(i, j);
+  if(end - start < 2) return;
+
+  size_t level = floor_log2(end - start);
+  size_t width = level_width(level);
+  const unsigned char* row = sparse_table->table + sparse_table->level_starts[level];
+  __builtin_prefetch(row + start * width);
+  __builtin_prefetch(row + (end - ((size_t)1 << level)) * width);
+}
+
 /*
  * Test that SparseTable_lookup is working, but finding minimum elements in all
  * subintervals using SparseTable_lookup and by just checking all the elements.
@@ -12,6 +12,9 @@ size_t        SparseTable_lookup(SparseTable_T sparse_table,
                                  const size_t* array,
                                  size_t i, size_t j);
 
+/* Start loading what a lookup of array[i:j] will read, without waiting. */
+void          SparseTable_prefetch(SparseTable_T sparse_table, size_t i, size_t j);
+
 int           SparseTable_verify(SparseTable_T sparse_table,
                                  const size_t* array,
                                  size_t array_size);
@@ -0,0 +1,467 @@
+/*
+ * Lowest common ancestors from the balanced parentheses of the Euler tour.
+ *
+ * Bit i of the tour is 1 if the tour enters a node at step i and 0 if it
+ * leaves one. The excess E(i) is the number of 1s minus the number of 0s in
+ * bits [0, i], so a node of depth d has E = d + 1 at the bit that opens it.
+ *
+ * For nodes opened at x <= y, the minimum excess m over [x, y] is one more
+ * than the depth of their lowest common ancestor, and because the ancestor's
+ * subtree never dips below m, the ancestor is opened one past the rightmost
+ * bit before x whose excess is below m. That covers a node being an ancestor
+ * of the other too, since then m = E(x) and the search stops at x - 1.
+ *
+ * The bits are grouped in blocks of SUCCINCT_LCA_BLOCK_BITS. Each block has
+ * the number of 1s before it, and a complete binary tree over the blocks has
+ * the minimum excess within each run of blocks. Partial blocks are scanned a
+ * byte at a time with tables of the excess of every possible byte.
+ */
+
+#include <stdint.h>
+
+#include "succinct_lca.h"
+
+#include "utils/dbg.h"
+
+#define MIN(a,b) ((a) < (b) ? a : b)
+
+/* The number of bits of the tour in each block, a multiple of 64 */
+#define SUCCINCT_LCA_BLOCK_BITS 256
+#define WORDS_PER_BLOCK (SUCCINCT_LCA_BLOCK_BITS / 64)
+
+#define NOT_FOUND ((size_t)-1)
+
+struct SuccinctLCA_T {
+  /* The tour as balanced parentheses. Bit i is bit i % 64 of word i / 64. */
+  uint64_t*     bits;
+  size_t        num_bits;
+  /* The number of 1s before each block, and before the end */
+  size_t*       block_ranks;
+  size_t        num_blocks;
+  /* A complete binary tree over the blocks. Node k has sons 2k and 2k + 1,
+   * block b is node num_leaves + b, and each node holds the minimum excess in
+   * its blocks. Leaves past the last block hold INT64_MAX. */
+  int64_t*      block_minima;
+  size_t        num_leaves;
+  /* The position of the bit that opens each node, by node index, packed
+   * position_width bits apiece */
+  uint64_t*     open_positions;
+  unsigned int  position_width;
+  /* The nodes in the order the tour enters them, so the node opened by the
+   * k-th 1 */
+  Node_T*       preorder_nodes;
+  size_t        num_nodes;
+  /* For each byte, the excess of its 8 bits and the lowest excess after any
+   * of its bits, both relative to the excess before it */
+  signed char   byte_excess[256];
+  signed char   byte_min_excess[256];
+};
+
+struct SuccinctLCAWalkData {
+  SuccinctLCA_T lca;
+  size_t        position;
+  size_t        num_entered;
+  Node_T        previous_node;
+};
+
+static inline size_t get_open_position(const SuccinctLCA_T lca, size_t node_index)
+{
+  size_t bit = node_index * lca->position_width;
+  unsigned int offset = bit % 64;
+  uint64_t value = lca->open_positions[bit / 64] >> offset;
+  if(offset + lca->position_width > 64) {
+    value |= lca->open_positions[bit / 64 + 1] << (64 - offset);
+  }
+  return value & (((uint64_t)1 << lca->position_width) - 1);
+}
+
+static inline void set_open_position(SuccinctLCA_T lca, size_t node_index,
+                                     size_t position)
+{
+  size_t bit = node_index * lca->position_width;
+  unsigned int offset = bit % 64;
+  lca->open_positions[bit / 64] |= (uint64_t)position << offset;
+  if(offset + lca->position_width > 64) {
+    lca->open_positions[bit / 64 + 1] |= (uint64_t)position >> (64 - offset);
+  }
+}
+
+static inline int get_bit(const SuccinctLCA_T lca, size_t position)
+{
+  return (lca->bits[position / 64] >> (position % 64)) & 1;
+}
+
+/* The number of 1s in bits [0, position). */
+static inline size_t rank1(const SuccinctLCA_T lca, size_t position)
+{
+  size_t block = position / SUCCINCT_LCA_BLOCK_BITS;
+  size_t rank = lca->block_ranks[block];
+  size_t word = 0;
+  for(word = block * WORDS_PER_BLOCK; word < position / 64; word++) {
+    rank += __builtin_popcountll(lca->bits[word]);
+  }
+  if(position % 64) {
+    uint64_t mask = ((uint64_t)1 << (position % 64)) - 1;
+    rank += __builtin_popcountll(lca->bits[position / 64] & mask);
+  }
+  return rank;
+}
+
+/* The excess before bit position, so E(position - 1), with E(-1) = 0. */
+static inline int64_t excess_before(const SuccinctLCA_T lca, size_t position)
+{
+  return 2 * (int64_t)rank1(lca, position) - (int64_t)position;
+}
+
+/*
+ * The minimum of E over bits [start, end), where excess is the excess before
+ * start.
+ */
+static int64_t scan_min_excess(const SuccinctLCA_T lca, size_t start,
+                               size_t end, int64_t excess)
+{
+  int64_t min = INT64_MAX;
+  size_t i = start;
+  while(i < end) {
+    if(i % 8 == 0 && end - i >= 8) {
+      unsigned char byte = lca->bits[i / 64] >> (i % 64);
+      min = MIN(min, excess + lca->byte_min_excess[byte]);
+      excess += lca->byte_excess[byte];
+      i += 8;
+    } else {
+      excess += get_bit(lca, i) ? 1 : -1;
+      min = MIN(min, excess);
+      i++;
+    }
+  }
+  return min;
+}
+
+/*
+ * The rightmost bit in [start, end) whose excess is less than limit, or
+ * NOT_FOUND, where excess is E(end - 1).
+ */
+static size_t scan_back(const SuccinctLCA_T lca, size_t start, size_t end,
+                        int64_t excess, int64_t limit)
+{
+  size_t i = end;
+  while(i > start) {
+    if(i % 8 == 0 && i - start >= 8) {
+      unsigned char byte = lca->bits[(i - 8) / 64] >> ((i - 8) % 64);
+      int64_t excess_before_byte = excess - lca->byte_excess[byte];
+      if(excess_before_byte + lca->byte_min_excess[byte] >= limit) {
+        excess = excess_before_byte;
+        i -= 8;
+        continue;
+      }
+    }
+    if(excess < limit) return i - 1;
+    excess -= get_bit(lca, i - 1) ? 1 : -1;
+    i--;
+  }
+  return NOT_FOUND;
+}
+
+/* The minimum excess within blocks [start, end). */
+static int64_t tree_min_excess(const SuccinctLCA_T lca, size_t start, size_t end)
+{
+  int64_t min = INT64_MAX;
+  for(start += lca->num_leaves, end += lca->num_leaves; start < end;
+      start /= 2, end /= 2) {
+    if(start & 1) {
+      min = MIN(min, lca->block_minima[start]);
+      start++;
+    }
+    if(end & 1) {
+      end--;
+      min = MIN(min, lca->block_minima[end]);
+    }
+  }
+  return min;
+}
+
+/* The rightmost block before block whose minimum excess is below limit. */
+static size_t tree_find_back(const SuccinctLCA_T lca, size_t block, int64_t limit)
+{
+  size_t k = lca->num_leaves + block;
+  while(k > 1) {
+    if((k & 1) && lca->block_minima[k - 1] < limit) {
+      k--;
+      while(k < lca->num_leaves) {
+        k = lca->block_minima[2 * k + 1] < limit ? 2 * k + 1 : 2 * k;
+      }
+      return k - lca->num_leaves;
+    }
+    k /= 2;
+  }
+  return NOT_FOUND;
+}
+
+/* The minimum of E over bits [start, end]. */
+static int64_t min_excess(const SuccinctLCA_T lca, size_t start, size_t end)
+{
+  size_t start_block = start / SUCCINCT_LCA_BLOCK_BITS;
+  size_t end_block = end / SUCCINCT_LCA_BLOCK_BITS;
+  int64_t excess = excess_before(lca, start);
+
+  if(start_block == end_block) {
+    return scan_min_excess(lca, start, end + 1, excess);
+  }
+
+  int64_t min = scan_min_excess(lca, start,
+                                (start_block + 1) * SUCCINCT_LCA_BLOCK_BITS,
+                                excess);
+  int64_t blocks_min = tree_min_excess(lca, start_block + 1, end_block);
+  size_t end_block_start = end_block * SUCCINCT_LCA_BLOCK_BITS;
+  excess = 2 * (int64_t)lca->block_ranks[end_block] - (int64_t)end_block_start;
+  int64_t end_min = scan_min_excess(lca, end_block_start, end + 1, excess);
+  min = MIN(min, blocks_min);
+  return MIN(min, end_min);
+}
+
+/* The rightmost bit before position whose excess is below limit. */
+static size_t backward_search(const SuccinctLCA_T lca, size_t position,
+                              int64_t limit)
+{
+  size_t block = position / SUCCINCT_LCA_BLOCK_BITS;
+  size_t block_start = block * SUCCINCT_LCA_BLOCK_BITS;
+
+  if(position > block_start) {
+    size_t found = scan_back(lca, block_start, position,
+                             excess_before(lca, position), limit);
+    if(found != NOT_FOUND) return found;
+  }
+
+  block = tree_find_back(lca, block, limit);
+  if(block == NOT_FOUND) return NOT_FOUND;
+  size_t block_end = (block + 1) * SUCCINCT_LCA_BLOCK_BITS;
+  int64_t excess = 2 * (int64_t)lca->block_ranks[block + 1] - (int64_t)block_end;
+  return scan_back(lca, block * SUCCINCT_LCA_BLOCK_BITS, block_end, excess, limit);
+}
+
+/*
+ * The NodeFunc_T for building the parentheses. The walk calls it on entering
+ * a node and on coming back to it from each child, which is when the child
+ * is left.
+ */
+SuffixTreeIndex_T succinct_lca_node_func(SuffixTree_T tree, Node_T node,
+                                         void* vdata, SuffixTreeIndex_T counter)
+{
+  (void)tree;
+  struct SuccinctLCAWalkData* data = vdata;
+  SuccinctLCA_T lca = data->lca;
+
+  if(data->previous_node && Node_get_parent(data->previous_node) == node) {
+    /* The bits start out 0, so leaving a node is just a step. */
+    data->position++;
+  } else {
+    lca->bits[data->position / 64] |= (uint64_t)1 << (data->position % 64);
+    set_open_position(lca, Node_get_index(node), data->position);
+    lca->preorder_nodes[data->num_entered++] = node;
+    data->position++;
+  }
+
+  data->previous_node = node;
+  return counter;
+}
+
+static void fill_byte_tables(SuccinctLCA_T lca)
+{
+  unsigned int byte = 0;
+  for(byte = 0; byte < 256; byte++) {
+    int excess = 0;
+    int min = 8;
+    unsigned int bit = 0;
+    for(bit = 0; bit < 8; bit++) {
+      excess += (byte >> bit) & 1 ? 1 : -1;
+      min = MIN(min, excess);
+    }
+    lca->byte_excess[byte] = excess;
+    lca->byte_min_excess[byte] = min;
+  }
+}
+
+static int fill_blocks(SuccinctLCA_T lca)
+{
+  size_t block = 0;
+  size_t word = 0;
+
+  lca->block_ranks = malloc((lca->num_blocks + 1) * sizeof(size_t));
+  check_mem(lca->block_ranks);
+
+  for(block = 0; block <= lca->num_blocks; block++) {
+    lca->block_ranks[block] = block == 0 ? 0 : lca->block_ranks[block - 1];
+    if(block == 0) continue;
+    for(word = (block - 1) * WORDS_PER_BLOCK;
+        word < block * WORDS_PER_BLOCK && word * 64 < lca->num_bits; word++) {
+      lca->block_ranks[block] += __builtin_popcountll(lca->bits[word]);
+    }
+  }
+
+  lca->num_leaves = 1;
+  while(lca->num_leaves < lca->num_blocks) lca->num_leaves *= 2;
+  lca->block_minima = malloc(2 * lca->num_leaves * sizeof(int64_t));
+  check_mem(lca->block_minima);
+
+  for(block = 0; block < lca->num_leaves; block++) {
+    int64_t min = INT64_MAX;
+    if(block < lca->num_blocks) {
+      size_t start = block * SUCCINCT_LCA_BLOCK_BITS;
+      size_t end = MIN(start + SUCCINCT_LCA_BLOCK_BITS, lca->num_bits);
+      min = scan_min_excess(lca, start, end,
+                            2 * (int64_t)lca->block_ranks[block] - (int64_t)start);
+    }
+    lca->block_minima[lca->num_leaves + block] = min;
+  }
+  for(block = lca->num_leaves - 1; block > 0; block--) {
+    lca->block_minima[block] = MIN(lca->block_minima[2 * block],
+                                   lca->block_minima[2 * block + 1]);
+  }
+
+  return 0;
+error:
+  return 1;
+}
+
+SuccinctLCA_T SuccinctLCA_create(SuffixTree_T tree)
+{
+  SuccinctLCA_T lca = NULL;
+
+  check(tree, "Cannot create a SuccinctLCA_T without a tree.");
+
+  lca = calloc(1, sizeof(struct SuccinctLCA_T));
+  check_mem(lca);
+
+  lca->num_nodes = SuffixTree_get_num_nodes(tree);
+  lca->num_bits = 2 * lca->num_nodes;
+  lca->num_blocks = (lca->num_bits + SUCCINCT_LCA_BLOCK_BITS - 1) /
+                    SUCCINCT_LCA_BLOCK_BITS;
+  lca->position_width = sizeof(unsigned long long) * 8 -
+                        __builtin_clzll(lca->num_bits);
+
+  /* One spare word, so the last block can be read a word at a time. */
+  lca->bits = calloc(lca->num_blocks * WORDS_PER_BLOCK + 1, sizeof(uint64_t));
+  check_mem(lca->bits);
+  lca->open_positions = calloc(lca->num_nodes * lca->position_width / 64 + 2,
+                               sizeof(uint64_t));
+  check_mem(lca->open_positions);
+  lca->preorder_nodes = malloc(lca->num_nodes * sizeof(Node_T));
+  check_mem(lca->preorder_nodes);
+
+  fill_byte_tables(lca);
+
+  struct SuccinctLCAWalkData data = {lca, 0, 0, NULL};
+  int rc = SuffixTree_euler_walk(tree, SuffixTree_get_root(tree),
+                                 succinct_lca_node_func, &data, 0);
+  check(rc == 0, "Euler walk of the suffix tree failed.");
+  /* The walk doesn't come back to anything after the root. */
+  data.position++;
+  check(data.position == lca->num_bits && data.num_entered == lca->num_nodes,
+        "Walk visited %zu nodes in %zu steps, but the tree has %zu nodes.",
+        data.num_entered, data.position, lca->num_nodes);
+
+  rc = fill_blocks(lca);
+  check(rc == 0, "Failed to fill the blocks of the SuccinctLCA_T.");
+
+  return lca;
+
+error:
+  SuccinctLCA_delete(&lca);
+  return NULL;
+}
+
+void SuccinctLCA_delete(SuccinctLCA_T* lca)
+{
+  if(!lca || !*lca) return;
+  if((*lca)->bits) free((*lca)->bits);
+  if((*lca)->block_ranks) free((*lca)->block_ranks);
+  if((*lca)->block_minima) free((*lca)->block_minima);
+  if((*lca)->open_positions) free((*lca)->open_positions);
+  if((*lca)->preorder_nodes) free((*lca)->preorder_nodes);
+  free(*lca);
+  *lca = NULL;
+}
+
+Node_T SuccinctLCA_get_lca(SuccinctLCA_T lca, Node_T node1, Node_T node2)
+{
+  size_t start = get_open_position(lca, Node_get_index(node1));
+  size_t end = get_open_position(lca, Node_get_index(node2));
+  if(start > end) {
+    size_t tmp = start;
+    start = end;
+    end = tmp;
+  }
+
+  int64_t min = min_excess(lca, start, end);
+  size_t before = backward_search(lca, start, min);
+  size_t lca_position = before == NOT_FOUND ? 0 : before + 1;
+
+  return lca->preorder_nodes[rank1(lca, lca_position)];
+}
+
+size_t SuccinctLCA_get_size(SuccinctLCA_T lca)
+{
+  return sizeof(struct SuccinctLCA_T) +
+         (lca->num_blocks * WORDS_PER_BLOCK + 1) * sizeof(uint64_t) +
+         (lca->num_blocks + 1) * sizeof(size_t) +
+         2 * lca->num_leaves * sizeof(int64_t) +
+         (lca->num_nodes * lca->position_width / 64 + 2) * sizeof(uint64_t) +
+         lca->num_nodes * sizeof(Node_T);
+}
+
+int SuccinctLCA_verify(SuccinctLCA_T lca, SuffixTree_T tree)
+{
+  Node_T* nodes = NULL;
+  size_t i = 0;
+
+  check(lca->num_nodes == SuffixTree_get_num_nodes(tree),
+        "SuccinctLCA_T has %zu nodes, but the tree has %zu.", lca->num_nodes,
+        (size_t)SuffixTree_get_num_nodes(tree));
+
+  /* Every node opens at a 1 whose excess is its depth plus one, and is the
+   * node recorded for that 1. */
+  nodes = SuffixTree_create_node_array(tree);
+  check(nodes, "Failed to create node array.");
+  for(i = 0; i < lca->num_nodes; i++) {
+    size_t position = get_open_position(lca, i);
+    check(position < lca->num_bits && get_bit(lca, position),
+          "Node %zu does not open at a 1.", i);
+    check(lca->preorder_nodes[rank1(lca, position)] == nodes[i],
+          "Node %zu is not the node recorded for its 1.", i);
+
+    int64_t depth = 0;
+    Node_T ancestor = Node_get_parent(nodes[i]);
+    while(ancestor) {
+      depth++;
+      ancestor = Node_get_parent(ancestor);
+    }
+    check(excess_before(lca, position + 1) == depth + 1,
+          "Excess of node %zu is %lld, but its depth is %lld.", i,
+          (long long)excess_before(lca, position + 1), (long long)depth);
+  }
+
+  /* The parentheses are balanced. */
+  check(excess_before(lca, lca->num_bits) == 0, "Parentheses are unbalanced.");
+
+  /* The block minima match a scan of each block. */
+  for(i = 0; i < lca->num_blocks; i++) {
+    size_t start = i * SUCCINCT_LCA_BLOCK_BITS;
+    size_t end = MIN(start + SUCCINCT_LCA_BLOCK_BITS, lca->num_bits);
+    int64_t excess = excess_before(lca, start);
+    int64_t min = INT64_MAX;
+    size_t j = 0;
+    for(j = start; j < end; j++) {
+      excess += get_bit(lca, j) ? 1 : -1;
+      min = MIN(min, excess);
+    }
+    check(lca->block_minima[lca->num_leaves + i] == min,
+          "Minimum of block %zu is %lld, but should be %lld.", i,
+          (long long)lca->block_minima[lca->num_leaves + i], (long long)min);
+  }
+
+  free(nodes);
+  return 0;
+error:
+  if(nodes) free(nodes);
+  return 1;
+}
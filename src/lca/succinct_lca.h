@@ -0,0 +1,69 @@
+#ifndef _succinct_lca_H_
+#define _succinct_lca_H_
+
+#include <stdlib.h>
+#include "suffix_tree/suffix_tree.h"
+
+/* LCA means lowest common ancestor. */
+
+/* TYPES */
+
+/*
+ * A SuccinctLCA_T answers lowest common ancestor queries on a SuffixTree_T
+ * like an LCASuffixTree_T does, but keeps much less. An LCASuffixTree_T holds
+ * the nodes, depths and first instances of its Euler tour, which is around 48
+ * bytes per node before its block and sparse tables. Because consecutive
+ * depths of the tour differ by exactly one, a SuccinctLCA_T keeps the tour as
+ * a sequence of balanced parentheses instead, one bit for entering each node
+ * and one for leaving it. The depth at any point of the tour is the number of
+ * entries minus the number of exits so far, which a rank directory answers,
+ * and a tree of the minimum depth in each block of bits finds range minima.
+ *
+ * All told it needs about one Node_T, one tour position packed into as few
+ * bits as it takes, and a third of a byte per node of the tree. Queries take
+ * logarithmic rather than constant time.
+ *
+ * The SuffixTree_T is not copied and must outlive the SuccinctLCA_T.
+ */
+typedef struct SuccinctLCA_T* SuccinctLCA_T;
+
+/* FUNCTIONS */
+
+/*
+ * Create a SuccinctLCA_T for the nodes of a SuffixTree_T.
+ *
+ * Returns:
+ *  SuccinctLCA_T lca, or NULL on failure.
+ */
+SuccinctLCA_T SuccinctLCA_create(SuffixTree_T tree);
+
+/* Delete a SuccinctLCA_T, freeing all its memory. */
+void          SuccinctLCA_delete(SuccinctLCA_T* lca);
+
+/*
+ * Given two nodes of the tree the SuccinctLCA_T was created from, return
+ * their lowest common ancestor.
+ *
+ * Params:
+ *  SuccinctLCA_T lca       :   Created from the tree containing the nodes.
+ *  Node_T node1            :   First node in the LCA query pair.
+ *  Node_T node2            :   Second node in the LCA query pair.
+ *
+ * Returns:
+ *  Node_T lca_node, the node that is the lowest common ancestor of node1 and
+ *  node2.
+ */
+Node_T        SuccinctLCA_get_lca(SuccinctLCA_T lca, Node_T node1, Node_T node2);
+
+/* The number of bytes of memory held by a SuccinctLCA_T. */
+size_t        SuccinctLCA_get_size(SuccinctLCA_T lca);
+
+/*
+ * Check a SuccinctLCA_T against the SuffixTree_T it was created from.
+ *
+ * Returns:
+ *  0 if tests pass, else 1.
+ */
+int           SuccinctLCA_verify(SuccinctLCA_T lca, SuffixTree_T tree);
+
+#endif
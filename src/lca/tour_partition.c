@@ -1,5 +1,6 @@
 #include "tour_partition.h"
 
+#include "lca/normalized_blocks.h"
 #include "utils/dbg.h"
 
 #include <math.h>
@@ -95,7 +96,18 @@ TourPartition_T TourPartition_create(const size_t* values, size_t values_length)
   }
   tour_partition->block_minima[block] = current_minimum;
   tour_partition->minima_positions[block] = minimum_pos_in_current_block;
-  
+
+  tour_partition->block_ids = calloc(tour_partition->num_blocks,
+                                     sizeof(unsigned int));
+  check_mem(tour_partition->block_ids);
+
+  for(block = 0; block < tour_partition->num_blocks; block++) {
+    size_t block_start = block * tour_partition->block_length;
+    size_t block_end = MIN(values_length, block_start + tour_partition->block_length);
+    tour_partition->block_ids[block] = get_padded_block_id(
+        values + block_start, block_end - block_start, tour_partition->block_length);
+  }
+
   return tour_partition;
 
 error:
@@ -108,6 +120,7 @@ void TourPartition_delete(TourPartition_T* tour_partition)
   if(*tour_partition) {
     if((*tour_partition)->block_minima) free((*tour_partition)->block_minima);
     if((*tour_partition)->minima_positions) free((*tour_partition)->minima_positions);
+    if((*tour_partition)->block_ids) free((*tour_partition)->block_ids);
     free(*tour_partition);
   }
 }
@@ -13,6 +13,10 @@ struct TourPartition_T {
 
   size_t* block_minima;
   size_t* minima_positions;
+
+  /* The id of each block for a BlockRMQDatabase_T, found once here so that
+   * queries don't have to scan the blocks. */
+  unsigned int* block_ids;
 };
 
 /* FUNCTIONS */
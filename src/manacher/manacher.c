@@ -2,16 +2,66 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "manacher_private.h"
+#include "utils/mapped_file.h"
+#include "utils/relation.h"
+
 #include "utils/dbg.h"
 
-#define MIN(A, B) ((A) < (B) ? A : B)
-#define MAX(A, B) ((A) > (B) ? A : B)
+static size_t get_array_radius(const void* radii, size_t center)
+{
+  return ((const size_t*)radii)[center];
+}
 
-/* Macros for converting a palidrome center (C) and radius (R) to
- * positions it the query string.
+/*
+ * The loop of Manacher's algorithm, filling in pal_radii, which has
+ * 2 * query_length + 1 zeroed elements. The left arm of each palindrome is read
+ * from left_string and the right arm from right_string.
  */
-#define QUERY_START(C, R) ((C) / 2 - (R))
-#define QUERY_END(C, R) ((C) % 2 == 0 ? ((C) / 2 + (R) - 1) : ((C) / 2 + (R)))
+static inline void fill_radii(const char* left_string, const char* right_string,
+                              size_t query_length, size_t* pal_radii)
+{
+  size_t pal_radii_length = 2 * query_length + 1;
+
+  /* This is an index to pal_radii, it tracks which element we're calculating
+   */
+  size_t pal_radii_pos = 0;
+  
+  /* This is the index in pal_radii of the palindrome that may span over
+   * pal_radii_pos */
+  size_t current_pal_center = 0;
+  
+  /* How far the current palindrome extends in the pal_radii array */
+  size_t right_boundary = 0;
+  
+  /* Don't check the first and last elements of P, those are always zero, and
+   * they screw up our indexing */
+  for(pal_radii_pos = 1; pal_radii_pos < pal_radii_length - 1; pal_radii_pos++) {
+
+    size_t radius = 0;
+    
+    /* If our center falls within the extent, we know a floor for its radius */
+    if(right_boundary > pal_radii_pos) {
+      size_t mirror_pos = 2 * current_pal_center - pal_radii_pos;
+      size_t max_radius = (right_boundary - pal_radii_pos) / 2;
+      radius = MIN(max_radius, pal_radii[mirror_pos]);
+    }
+    
+    /* Extend it as far as it will go, or to the end of the string. The
+     * palindrome is query_string[first:last+1], and last is QUERY_END without
+     * the branch on the parity of the center. */
+    size_t first = pal_radii_pos / 2 - radius;
+    size_t last = (pal_radii_pos - 1) / 2 + radius;
+    radius += extend_related_arms(left_string, right_string, query_length,
+                                  first, last);
+    pal_radii[pal_radii_pos] = radius;
+       
+    if(2 * radius + pal_radii_pos > right_boundary) {
+      current_pal_center = pal_radii_pos;
+      right_boundary = 2 * radius + pal_radii_pos;
+    }
+  }
+}
 
 /*
  * Run Manacher's algorithm on a string, returning the longest palindrome
@@ -37,63 +87,81 @@
  */
 size_t* manacher(char* query_string, size_t query_length)
 {
-  
-  size_t pal_radii_length = 2 * query_length + 1;
-  size_t* pal_radii = calloc(pal_radii_length, sizeof(size_t));
+  size_t* pal_radii = calloc(2 * query_length + 1, sizeof(size_t));
   check_mem(pal_radii);
-  
-  /* This is an index to pal_radii, it tracks which element we're calculating
-   */
-  size_t pal_radii_pos = 0;
-  
-  /* This is the index in pal_radii of the palindrome that may span over
-   * pal_radii_pos */
-  size_t current_pal_center = 0;
-  
-  
-  /* Don't check the first and last elements of P, those are always zero, and
-   * they screw up our indexing */
-  for(pal_radii_pos = 1; pal_radii_pos < pal_radii_length - 1; pal_radii_pos++) {
-    
-    /* Get the radius of the current spanning palindrome, but in terms of the
-     * pal_radii array. So, multiply by two */
-    size_t current_pal_radius = 2 * pal_radii[current_pal_center];
-    
-    /* How far the current palindrome extends in the pal_radii array */
-    size_t right_boundary = current_pal_center + current_pal_radius;
-    
-    /* If our center falls within the extent, we know a floor for its radius */
-    if(right_boundary > pal_radii_pos) {
-      size_t mirror_pos = 2 * current_pal_center - pal_radii_pos;
-      size_t max_radius = (right_boundary - pal_radii_pos) / 2;
-      pal_radii[pal_radii_pos] = MIN(max_radius, pal_radii[mirror_pos]);
-    }
-    
-    while(1) {
-      /* Check if the palindrome has reached the end of the string. */
-      if((QUERY_START(pal_radii_pos, pal_radii[pal_radii_pos])) == 0) break;
-      if((QUERY_END(pal_radii_pos, pal_radii[pal_radii_pos])) == query_length - 1) break;
-      
-      if(query_string[QUERY_START(pal_radii_pos, pal_radii[pal_radii_pos] + 1)] ==
-         query_string[QUERY_END(pal_radii_pos, pal_radii[pal_radii_pos] + 1)]) {
-        pal_radii[pal_radii_pos]++;
-      } else {
-        break;
-      }
-    }
-       
-    if(2 * pal_radii[pal_radii_pos] + pal_radii_pos > right_boundary) {
-      current_pal_center = pal_radii_pos;
-    }
+
+  fill_radii(query_string, query_string, query_length, pal_radii);
+  return pal_radii;
+
+error:
+  return NULL;
+}
+
+/*
+ * Run Manacher's algorithm with characters paired under relation, returning
+ * radii at the same 2 * query_length + 1 centers as manacher.
+ *
+ * RELATION_REVERSE_COMPLEMENT runs the loop of manacher_complement, which
+ * complements bases as it compares them and maps nothing. No base pairs with
+ * itself, so the odd centers are zero, and the radius at center 2 * i is the
+ * one manacher_complement gives at i. Those are the same palindromes in the
+ * layout of manacher, for callers that take radii from either.
+ *
+ * Other relations map the string, as by Relation_map_string, and the mapped
+ * string goes through the same loop as manacher.
+ */
+size_t* manacher_with_relation(char* query_string, size_t query_length,
+                               enum PalindromeRelation relation)
+{
+  size_t* pal_radii = NULL;
+  char* left_string = NULL;
+  char* right_string = NULL;
+
+  check(relation == RELATION_EXACT || relation == RELATION_CASE_INSENSITIVE ||
+        relation == RELATION_REVERSE_COMPLEMENT, "Unknown relation %d.", relation);
+
+  pal_radii = calloc(2 * query_length + 1, sizeof(size_t));
+  check_mem(pal_radii);
+
+  if(relation == RELATION_REVERSE_COMPLEMENT) {
+    fill_complement_radii(query_string, query_length, pal_radii, 2);
+    return pal_radii;
   }
 
+  int rc = Relation_map_string(relation, query_string, query_length,
+                               &left_string, &right_string);
+  check(rc == 0, "Failed to map string for relation.");
+
+  fill_radii(left_string, right_string, query_length, pal_radii);
+
+  Relation_free_strings(query_string, &left_string, &right_string);
   return pal_radii;
 
 error:
+  Relation_free_strings(query_string, &left_string, &right_string);
   if(pal_radii) free(pal_radii);
   return NULL;
 }
 
+/*
+ * Run manacher on the contents of a file, which is mapped rather than read, so
+ * the only memory it takes is the palindrome radii.
+ */
+size_t* manacher_file(const char* path, size_t* query_length)
+{
+  size_t* pal_radii = NULL;
+  MappedFile_T file = MappedFile_open(path);
+  check(file, "Could not map %s.", path);
+
+  *query_length = MappedFile_get_length(file);
+  pal_radii = manacher(MappedFile_get_data(file), *query_length);
+  MappedFile_close(&file);
+  return pal_radii;
+
+error:
+  return NULL;
+}
+
 /*
  * Check that the calculated palindrome radii are correct. Each palindrome is
  * checked to see that it is the same as its reverse and that it cannot be
@@ -110,16 +178,26 @@ error:
  *    int ret_code          :   0 if all palindromes are correct, otherwise 1
  */
 int verify_palindrome_radii(char* query_string, size_t query_length, size_t* pal_radii)
+{
+  return verify_radii(query_string, query_length, get_array_radius, pal_radii);
+}
+
+/*
+ * verify_palindrome_radii for radii stored any way, read through get_radius.
+ */
+int verify_radii(char* query_string, size_t query_length,
+                 RadiusFunc_T get_radius, const void* radii)
 {
   size_t i = 0;
   
   /* First check that the first and last radii are zero */
-  if (pal_radii[0] != 0) {
-    log_warn("First element should be zero, but it is %zd", pal_radii[0]);
+  if (get_radius(radii, 0) != 0) {
+    log_warn("First element should be zero, but it is %zd", get_radius(radii, 0));
     return 1;
   }
-  if (pal_radii[2 * query_length] != 0) {
-    log_warn("Last element should be zero, but it is %zd", pal_radii[2 * query_length]);
+  if (get_radius(radii, 2 * query_length) != 0) {
+    log_warn("Last element should be zero, but it is %zd",
+             get_radius(radii, 2 * query_length));
     return 1;
   }
   
@@ -127,10 +205,10 @@ int verify_palindrome_radii(char* query_string, size_t query_length, size_t* pal
    * its reverse and that the palindrome cannot be extended */
   for(i = 1; i < 2 * query_length; i++) {
     
-    size_t pal_radius = pal_radii[i];
+    size_t pal_radius = get_radius(radii, i);
     
-    size_t query_start = QUERY_START(i, pal_radii[i]);
-    size_t query_end = QUERY_END(i, pal_radii[i]);
+    size_t query_start = QUERY_START(i, pal_radius);
+    size_t query_end = QUERY_END(i, pal_radius);
     
     /* Try to extend the palindrome, but only if it won't run off the end of
      * the query */
@@ -176,13 +254,23 @@ int verify_palindrome_radii(char* query_string, size_t query_length, size_t* pal
  *                            query_string
  */
 char* longest_palindrome(char* query_string, size_t query_length, size_t* pal_radii)
+{
+  return longest_radius(query_string, query_length, get_array_radius, pal_radii);
+}
+
+/*
+ * longest_palindrome for radii stored any way, read through get_radius.
+ */
+char* longest_radius(char* query_string, size_t query_length,
+                     RadiusFunc_T get_radius, const void* radii)
 {
   size_t max_val = 0;
   size_t max_index = 0;
   size_t i = 0;
   for(i = 0; i < 2 * query_length + 1; i++) {
-    if(pal_radii[i] > max_val) {
-      max_val = pal_radii[i];
+    size_t radius = get_radius(radii, i);
+    if(radius > max_val) {
+      max_val = radius;
       max_index = i;
     }
   }
@@ -1,8 +1,17 @@
 #ifndef _manacher_H_
 #define _manacher_H_
 
+#include <stdlib.h>
+
+#include "utils/relation.h"
+
 size_t* manacher(char* query_string, size_t query_length);
 
+size_t* manacher_with_relation(char* query_string, size_t query_length,
+                               enum PalindromeRelation relation);
+
+size_t* manacher_file(const char* path, size_t* query_length);
+
 int verify_palindrome_radii(char* query_string, size_t query_length, size_t* pal_radii);
 
 char* longest_palindrome(char* query_string, size_t query_length, size_t* pal_radii);
@@ -0,0 +1,166 @@
+#include <stdlib.h>
+
+#include "manacher_complement.h"
+#include "manacher_private.h"
+
+#include "utils/dbg.h"
+
+/*
+ * The complement of each base, and 0 for anything that pairs with nothing.
+ * A '\0' on the right arm can occur too, in a mapped file say, so pairs are
+ * checked with COMPLEMENT_PAIRS, which rules it out.
+ */
+static const char COMPLEMENT[256] = {
+  ['A'] = 'T', ['C'] = 'G', ['G'] = 'C', ['T'] = 'A',
+  ['a'] = 't', ['c'] = 'g', ['g'] = 'c', ['t'] = 'a'
+};
+
+#define COMPLEMENT_OF(C) (COMPLEMENT[(unsigned char)(C)])
+#define COMPLEMENT_PAIRS(L, R) (COMPLEMENT_OF(L) == (R) && (R) != 0)
+
+#if defined(__SSE2__)
+/*
+ * Complement 16 bytes at once, by picking out each base with a comparison.
+ * Anything else comes out as 0, like in COMPLEMENT.
+ */
+static inline __m128i complement128(__m128i v)
+{
+  static const char bases[] = "ACGTacgt";
+  __m128i complement = _mm_setzero_si128();
+  int i = 0;
+  for(i = 0; i < 8; i++) {
+    __m128i is_base = _mm_cmpeq_epi8(v, _mm_set1_epi8(bases[i]));
+    complement = _mm_or_si128(complement, _mm_and_si128(
+        is_base, _mm_set1_epi8(COMPLEMENT_OF(bases[i]))));
+  }
+  return complement;
+}
+#endif
+
+/*
+ * Count how many more pairs the palindrome query_string[left:right] can be
+ * extended by, like extend_arms, but pairing each base with its complement.
+ */
+static inline size_t extend_complement_arms(const char* query_string,
+                                            size_t query_length,
+                                            size_t left, size_t right)
+{
+  size_t max_steps = MIN(left, query_length - right);
+  if(max_steps == 0 ||
+     !COMPLEMENT_PAIRS(query_string[left - 1], query_string[right])) return 0;
+  size_t steps = 1;
+
+#if defined(__SSE2__)
+  while(steps + 16 <= max_steps) {
+    __m128i right_arm = _mm_loadu_si128(
+        (const __m128i*)(query_string + right + steps));
+    __m128i left_arm = complement128(reverse_bytes128(_mm_loadu_si128(
+        (const __m128i*)(query_string + left - steps - 16))));
+    unsigned int equal = _mm_movemask_epi8(_mm_andnot_si128(
+        _mm_cmpeq_epi8(right_arm, _mm_setzero_si128()),
+        _mm_cmpeq_epi8(left_arm, right_arm)));
+    if(equal != 0xFFFF) return steps + __builtin_ctz(~equal);
+    steps += 16;
+  }
+#endif
+
+  while(steps < max_steps &&
+        COMPLEMENT_PAIRS(query_string[left - 1 - steps], query_string[right + steps])) {
+    steps++;
+  }
+  return steps;
+}
+
+/*
+ * The loop of manacher_complement, writing the radius of center i to
+ * pal_radii[stride * i], which is zeroed.
+ */
+static inline void fill_radii_strided(const char* query_string, size_t query_length,
+                                      size_t* pal_radii, size_t stride)
+{
+  /* The center of the palindrome that reaches furthest right, and where it
+   * ends. */
+  size_t current_pal_center = 0;
+  size_t right_boundary = 0;
+
+  size_t pos = 0;
+  for(pos = 1; pos < query_length; pos++) {
+    size_t radius = 0;
+
+    if(right_boundary > pos) {
+      size_t mirror_pos = 2 * current_pal_center - pos;
+      radius = MIN(right_boundary - pos, pal_radii[stride * mirror_pos]);
+    }
+
+    radius += extend_complement_arms(query_string, query_length,
+                                     pos - radius, pos + radius);
+    pal_radii[stride * pos] = radius;
+
+    if(pos + radius > right_boundary) {
+      current_pal_center = pos;
+      right_boundary = pos + radius;
+    }
+  }
+}
+
+void fill_complement_radii(const char* query_string, size_t query_length,
+                           size_t* pal_radii, size_t stride)
+{
+  /* Each stride gets its own copy of the loop. */
+  if(stride == 1) {
+    fill_radii_strided(query_string, query_length, pal_radii, 1);
+  } else {
+    fill_radii_strided(query_string, query_length, pal_radii, 2);
+  }
+}
+
+size_t* manacher_complement(char* query_string, size_t query_length)
+{
+  size_t* pal_radii = calloc(query_length + 1, sizeof(size_t));
+  check_mem(pal_radii);
+
+  fill_complement_radii(query_string, query_length, pal_radii, 1);
+  return pal_radii;
+
+error:
+  return NULL;
+}
+
+int verify_complement_radii(char* query_string, size_t query_length,
+                            size_t* pal_radii)
+{
+  size_t pos = 0;
+
+  if(pal_radii[0] != 0 || pal_radii[query_length] != 0) {
+    log_warn("First and last elements should be zero.");
+    return 1;
+  }
+
+  for(pos = 1; pos < query_length; pos++) {
+    size_t radius = pal_radii[pos];
+    size_t i = 0;
+
+    if(radius > pos || pos + radius > query_length) {
+      log_warn("Palindrome centered at %zu with radius %zu runs off the string.",
+               pos, radius);
+      return 1;
+    }
+
+    for(i = 0; i < radius; i++) {
+      if(!COMPLEMENT_PAIRS(query_string[pos - 1 - i], query_string[pos + i])) {
+        log_warn("Palindrome centered at %zu with radius %zu fails at %zu and %zu.",
+                 pos, radius, pos - 1 - i, pos + i);
+        return 1;
+      }
+    }
+
+    if(pos > radius && pos + radius < query_length &&
+       COMPLEMENT_PAIRS(query_string[pos - radius - 1], query_string[pos + radius])) {
+      log_warn("Palindrome centered at %zu with radius %zu is not maximal.",
+               pos, radius);
+      return 1;
+    }
+  }
+
+  return 0;
+}
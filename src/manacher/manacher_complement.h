@@ -0,0 +1,44 @@
+#ifndef _manacher_complement_H_
+#define _manacher_complement_H_
+
+#include <stdlib.h>
+
+/*
+ * Run Manacher's algorithm on a DNA string under reverse-complement equality,
+ * so that a palindrome is a string that equals its own reverse complement,
+ * like ACCTAGGT. No base is its own complement, so these palindromes always
+ * have even length, and only the query_length + 1 centers between characters
+ * are looked at:
+ *
+ *        A C C T A G G T
+ *        0 1 2 3 4 5 6 7 8
+ *
+ *        0 0 0 0 4 0 0 0 0
+ *
+ * Center i is between query_string[i-1] and query_string[i], and the
+ * palindrome of radius r there is query_string[i-r:i+r]. A and T are
+ * complements, as are C and G, in either case, and any other character
+ * pairs with nothing, so a run of N ends a palindrome.
+ *
+ * Input:
+ *    char* query_string    :   String to be search for palindromes
+ *    size_t query_length   :   Length of query_string, not including null
+ *                              terminator
+ *
+ * Output:
+ *    size_t* pal_radii     :   Radius of maximal palindrome at each of the
+ *                              query_length + 1 centers, or NULL on failure
+ */
+size_t* manacher_complement(char* query_string, size_t query_length);
+
+/*
+ * Check that each radius from manacher_complement is that of a reverse
+ * complement palindrome that can't be extended.
+ *
+ * Output:
+ *    int ret_code          :   0 if all palindromes are correct, otherwise 1
+ */
+int     verify_complement_radii(char* query_string, size_t query_length,
+                                size_t* pal_radii);
+
+#endif
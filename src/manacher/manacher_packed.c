@@ -0,0 +1,55 @@
+#include <stdlib.h>
+
+#include "manacher_packed.h"
+#include "manacher_private.h"
+#include "packed/packed_sequence_private.h"
+
+#include "utils/dbg.h"
+
+/*
+ * The loop of manacher, over a packed sequence. It is inlined once with and
+ * once without N checks.
+ */
+static inline void fill_radii(PackedSequence_T sequence, size_t* pal_radii,
+                              size_t pal_radii_length, int has_n)
+{
+  size_t current_pal_center = 0;
+  size_t right_boundary = 0;
+
+  size_t pos = 0;
+  for(pos = 1; pos < pal_radii_length - 1; pos++) {
+    size_t radius = 0;
+
+    if(right_boundary > pos) {
+      size_t mirror_pos = 2 * current_pal_center - pos;
+      radius = MIN((right_boundary - pos) / 2, pal_radii[mirror_pos]);
+    }
+
+    size_t first = pos / 2 - radius;
+    size_t last = (pos - 1) / 2 + radius;
+    radius += extend_packed_arms(sequence, first, last, has_n);
+    pal_radii[pos] = radius;
+
+    if(2 * radius + pos > right_boundary) {
+      current_pal_center = pos;
+      right_boundary = 2 * radius + pos;
+    }
+  }
+}
+
+size_t* manacher_packed(PackedSequence_T sequence)
+{
+  check(sequence, "Cannot search a NULL PackedSequence_T.");
+
+  size_t pal_radii_length = 2 * sequence->length + 1;
+  size_t* pal_radii = calloc(pal_radii_length, sizeof(size_t));
+  check_mem(pal_radii);
+
+  if(sequence->num_n == 0) fill_radii(sequence, pal_radii, pal_radii_length, 0);
+  else fill_radii(sequence, pal_radii, pal_radii_length, 1);
+
+  return pal_radii;
+
+error:
+  return NULL;
+}
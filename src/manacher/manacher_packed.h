@@ -0,0 +1,23 @@
+#ifndef _manacher_packed_H_
+#define _manacher_packed_H_
+
+#include <stdlib.h>
+
+#include "packed/packed_sequence.h"
+
+/*
+ * Run Manacher's algorithm on a packed DNA sequence, returning the same
+ * 2 * length + 1 palindrome radii that manacher does on its unpacked string.
+ * Arms are extended 32 bases at a time by comparing whole words, so the
+ * string itself is never needed.
+ *
+ * Input:
+ *    PackedSequence_T sequence   :   Sequence to be searched for palindromes
+ *
+ * Output:
+ *    size_t* pal_radii           :   Radius of maximal palindrome at each
+ *                                    possible center, or NULL on failure
+ */
+size_t* manacher_packed(PackedSequence_T sequence);
+
+#endif
@@ -0,0 +1,170 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "manacher_parallel.h"
+#include "manacher_private.h"
+
+#include "utils/dbg.h"
+
+/* Marks a center whose radius is left for the second pass. */
+#define UNFINISHED ((size_t)-1)
+
+/*
+ * The centers [first, end) handled by one thread, and what the thread leaves
+ * for the second pass: its last unfinished center, and its rightmost
+ * finished palindrome.
+ */
+struct ManacherSegment {
+  const char* query_string;
+  size_t      query_length;
+  size_t*     pal_radii;
+  size_t      first;
+  size_t      end;
+  int         has_unfinished;
+  size_t      last_unfinished;
+  size_t      current_pal_center;
+  size_t      right_boundary;
+};
+
+/* Extend the palindrome centered at pal_radii_pos out from radius. */
+static inline size_t extend_arm(const char* query_string, size_t query_length,
+                                size_t pal_radii_pos, size_t radius)
+{
+  return radius + extend_arms(query_string, query_length,
+                              pal_radii_pos / 2 - radius,
+                              (pal_radii_pos - 1) / 2 + radius);
+}
+
+/*
+ * The first pass over a segment. This only reads radii inside the segment,
+ * so the threads never touch each other's centers.
+ */
+static void* manacher_segment(void* vsegment)
+{
+  struct ManacherSegment* segment = vsegment;
+  size_t* pal_radii = segment->pal_radii;
+  size_t pal_radii_pos = 0;
+
+  for(pal_radii_pos = segment->first; pal_radii_pos < segment->end; pal_radii_pos++) {
+    size_t radius = 0;
+
+    if(segment->right_boundary > pal_radii_pos) {
+      size_t mirror_pos = 2 * segment->current_pal_center - pal_radii_pos;
+      if(mirror_pos < segment->first || pal_radii[mirror_pos] == UNFINISHED) {
+        pal_radii[pal_radii_pos] = UNFINISHED;
+        segment->has_unfinished = 1;
+        segment->last_unfinished = pal_radii_pos;
+        continue;
+      }
+      size_t max_radius = (segment->right_boundary - pal_radii_pos) / 2;
+      radius = MIN(max_radius, pal_radii[mirror_pos]);
+    }
+
+    radius = extend_arm(segment->query_string, segment->query_length,
+                        pal_radii_pos, radius);
+    pal_radii[pal_radii_pos] = radius;
+
+    if(pal_radii_pos + 2 * radius > segment->right_boundary) {
+      segment->current_pal_center = pal_radii_pos;
+      segment->right_boundary = pal_radii_pos + 2 * radius;
+    }
+  }
+
+  return NULL;
+}
+
+size_t* manacher_parallel(char* query_string, size_t query_length,
+                          unsigned int num_threads)
+{
+  size_t pal_radii_length = 2 * query_length + 1;
+  size_t* pal_radii = NULL;
+  struct ManacherSegment* segments = NULL;
+  pthread_t* threads = NULL;
+  int* started = NULL;
+  unsigned int i = 0;
+
+  if(num_threads == 0) num_threads = 1;
+
+  pal_radii = calloc(pal_radii_length, sizeof(size_t));
+  check_mem(pal_radii);
+  if(query_length == 0) return pal_radii;
+
+  segments = calloc(num_threads, sizeof(struct ManacherSegment));
+  check_mem(segments);
+  threads = calloc(num_threads, sizeof(pthread_t));
+  check_mem(threads);
+  started = calloc(num_threads, sizeof(int));
+  check_mem(started);
+
+  /* The first and last elements of pal_radii are always zero. */
+  size_t num_centers = pal_radii_length - 2;
+  size_t segment_length = (num_centers + num_threads - 1) / num_threads;
+  for(i = 0; i < num_threads; i++) {
+    segments[i].query_string = query_string;
+    segments[i].query_length = query_length;
+    segments[i].pal_radii = pal_radii;
+    segments[i].first = MIN(1 + i * segment_length, 1 + num_centers);
+    segments[i].end = MIN(segments[i].first + segment_length, 1 + num_centers);
+  }
+
+  /* If a thread can't be started, its segment is run here instead. */
+  for(i = 1; i < num_threads; i++) {
+    started[i] = pthread_create(&threads[i], NULL, manacher_segment,
+                                &segments[i]) == 0;
+  }
+  manacher_segment(&segments[0]);
+  for(i = 1; i < num_threads; i++) {
+    if(started[i]) {
+      pthread_join(threads[i], NULL);
+    } else {
+      manacher_segment(&segments[i]);
+    }
+  }
+
+  /* Finish the unfinished centers in order, carrying the rightmost palindrome
+   * found so far from one segment to the next. Every mirror is before the
+   * center, so it is already done. */
+  size_t current_pal_center = 0;
+  size_t right_boundary = 0;
+  for(i = 0; i < num_threads; i++) {
+    struct ManacherSegment* segment = &segments[i];
+    size_t pal_radii_pos = 0;
+
+    for(pal_radii_pos = segment->first;
+        segment->has_unfinished && pal_radii_pos <= segment->last_unfinished;
+        pal_radii_pos++) {
+      size_t radius = pal_radii[pal_radii_pos];
+      if(radius == UNFINISHED) {
+        radius = 0;
+        if(right_boundary > pal_radii_pos) {
+          size_t mirror_pos = 2 * current_pal_center - pal_radii_pos;
+          size_t max_radius = (right_boundary - pal_radii_pos) / 2;
+          radius = MIN(max_radius, pal_radii[mirror_pos]);
+        }
+        radius = extend_arm(query_string, query_length, pal_radii_pos, radius);
+        pal_radii[pal_radii_pos] = radius;
+      }
+      if(pal_radii_pos + 2 * radius > right_boundary) {
+        current_pal_center = pal_radii_pos;
+        right_boundary = pal_radii_pos + 2 * radius;
+      }
+    }
+
+    if(segment->right_boundary > right_boundary) {
+      current_pal_center = segment->current_pal_center;
+      right_boundary = segment->right_boundary;
+    }
+  }
+
+  free(started);
+  free(threads);
+  free(segments);
+  return pal_radii;
+
+error:
+  if(started) free(started);
+  if(threads) free(threads);
+  if(segments) free(segments);
+  if(pal_radii) free(pal_radii);
+  return NULL;
+}
@@ -0,0 +1,33 @@
+#ifndef _manacher_parallel_H_
+#define _manacher_parallel_H_
+
+#include <stdlib.h>
+
+/*
+ * Run Manacher's algorithm on a string with num_threads threads, returning the
+ * same 2 * query_length + 1 palindrome radii that manacher does.
+ *
+ * The centers are split into one segment per thread, and each thread runs
+ * Manacher's algorithm over its own segment, extending arms across the ends
+ * of the segment by comparing characters directly. A center whose mirror lies
+ * in an earlier segment can't be finished without that segment's radii, so
+ * it is left for a second pass. The second pass goes through the segments in
+ * order, and only from the start of each segment to its last unfinished
+ * center, carrying the rightmost palindrome across from the segments before.
+ * On sequences without very long palindromes, that is only a few centers per
+ * segment.
+ *
+ * Input:
+ *    char* query_string        :   String to be search for palindromes
+ *    size_t query_length       :   Length of query_string, not including null
+ *                                  terminator
+ *    unsigned int num_threads  :   Number of threads to run. 0 is taken as 1.
+ *
+ * Output:
+ *    size_t* pal_radii         :   Radius of maximal palindrome at each
+ *                                  possible center, or NULL on failure
+ */
+size_t* manacher_parallel(char* query_string, size_t query_length,
+                          unsigned int num_threads);
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef _manacher_private_H_
+#define _manacher_private_H_
+
+#include <stdlib.h>
+
+#define MIN(A, B) ((A) < (B) ? A : B)
+#define MAX(A, B) ((A) > (B) ? A : B)
+
+/* Macros for converting a palidrome center (C) and radius (R) to
+ * positions it the query string.
+ */
+#define QUERY_START(C, R) ((C) / 2 - (R))
+#define QUERY_END(C, R) ((C) % 2 == 0 ? ((C) / 2 + (R) - 1) : ((C) / 2 + (R)))
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+static inline __m256i reverse_bytes256(__m256i v)
+{
+  const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                           7, 6, 5, 4, 3, 2, 1, 0,
+                                           15, 14, 13, 12, 11, 10, 9, 8,
+                                           7, 6, 5, 4, 3, 2, 1, 0);
+  v = _mm256_shuffle_epi8(v, reverse);
+  return _mm256_permute2x128_si256(v, v, 1);
+}
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+static inline __m128i reverse_bytes128(__m128i v)
+{
+  /* SSE2 can't shuffle bytes, so swap the bytes of each 16-bit word and then
+   * reverse the words. */
+  v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+  v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+  v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+  return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+}
+#endif
+
+/*
+ * Count how many more characters each arm of the palindrome
+ * [left:right+1] can be extended by, stopping at either end of the string,
+ * with the left arm read from left_string and the right arm from
+ * right_string. An empty palindrome between two characters has
+ * right = left - 1. The two strings are the same for exact palindromes, and
+ * mapped for each arm of a relation otherwise.
+ *
+ * Most arms in real sequence stop at once, so one pair is checked before
+ * comparing 32 bytes at a time with AVX2 or 16 with SSE2. The left arm is
+ * loaded forward and its bytes reversed, so that byte i of each vector is i
+ * steps out from the palindrome. What's left over is compared one byte at a
+ * time, which is all a build without SSE2 does.
+ */
+static inline size_t extend_related_arms(const char* left_string,
+                                         const char* right_string,
+                                         size_t query_length,
+                                         size_t left, size_t right)
+{
+  size_t max_steps = MIN(left, query_length - 1 - right);
+  if(max_steps == 0 || left_string[left - 1] != right_string[right + 1]) return 0;
+  size_t steps = 1;
+
+#if defined(__AVX2__)
+  while(steps + 32 <= max_steps) {
+    __m256i right_arm = _mm256_loadu_si256(
+        (const __m256i*)(right_string + right + 1 + steps));
+    __m256i left_arm = reverse_bytes256(_mm256_loadu_si256(
+        (const __m256i*)(left_string + left - steps - 32)));
+    unsigned int equal = _mm256_movemask_epi8(_mm256_cmpeq_epi8(left_arm, right_arm));
+    if(equal != 0xFFFFFFFF) return steps + __builtin_ctz(~equal);
+    steps += 32;
+  }
+#endif
+
+#if defined(__SSE2__)
+  while(steps + 16 <= max_steps) {
+    __m128i right_arm = _mm_loadu_si128(
+        (const __m128i*)(right_string + right + 1 + steps));
+    __m128i left_arm = reverse_bytes128(_mm_loadu_si128(
+        (const __m128i*)(left_string + left - steps - 16)));
+    unsigned int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(left_arm, right_arm));
+    if(equal != 0xFFFF) return steps + __builtin_ctz(~equal);
+    steps += 16;
+  }
+#endif
+
+  while(steps < max_steps &&
+        left_string[left - 1 - steps] == right_string[right + 1 + steps]) {
+    steps++;
+  }
+  return steps;
+}
+
+/* extend_arms for exact palindromes of query_string. */
+static inline size_t extend_arms(const char* query_string, size_t query_length,
+                                 size_t left, size_t right)
+{
+  return extend_related_arms(query_string, query_string, query_length, left, right);
+}
+
+/*
+ * The loop of manacher_complement, writing the radius of the center between
+ * query_string[i-1] and query_string[i] to pal_radii[stride * i]. stride is 1
+ * for the query_length + 1 radii of manacher_complement, or 2 to fill the even
+ * centers of the 2 * query_length + 1 that manacher returns. pal_radii must be
+ * zeroed.
+ */
+void  fill_complement_radii(const char* query_string, size_t query_length,
+                            size_t* pal_radii, size_t stride);
+
+/*
+ * The function pointer type for reading the radius at a center out of radii
+ * stored in some way other than an array of size_t.
+ */
+typedef size_t (*RadiusFunc_T)(const void* radii, size_t center);
+
+int   verify_radii(char* query_string, size_t query_length,
+                   RadiusFunc_T get_radius, const void* radii);
+
+char* longest_radius(char* query_string, size_t query_length,
+                     RadiusFunc_T get_radius, const void* radii);
+
+#endif
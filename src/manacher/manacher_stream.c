@@ -0,0 +1,151 @@
+/*
+ * Manacher's algorithm over a window that slides along a sequence.
+ *
+ * The window holds characters [start, end) of the sequence and the radii of
+ * centers [2 * start, 2 * end]. The radius of center pos needs the characters
+ * within max_arm_length + 1 of it and the radius of its mirror, which is
+ * inside the palindrome spanning pos, so no more than 2 * max_arm_length + 1
+ * characters back. Everything before that can go whenever room is needed for
+ * the next chunk.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "manacher_stream.h"
+#include "manacher_private.h"
+
+#include "utils/dbg.h"
+
+struct StreamWindow {
+  char*              chars;
+  size_t*            radii;
+  size_t             start;
+  size_t             end;
+  size_t             capacity;
+  int                at_end;
+  SequenceReadFunc_T read_func;
+  void*              read_data;
+  size_t             chunk_length;
+};
+
+/* The first character that must stay in the window while working on pos. */
+static inline size_t keep_from(size_t pos, size_t max_arm_length)
+{
+  size_t reach = 2 * max_arm_length + 1;
+  return pos / 2 > reach ? pos / 2 - reach : 0;
+}
+
+/* Drop the characters and radii before first. */
+static void slide_window(struct StreamWindow* window, size_t first)
+{
+  if(first <= window->start) return;
+  size_t shift = first - window->start;
+  memmove(window->chars, window->chars + shift, window->end - first);
+  memmove(window->radii, window->radii + 2 * shift,
+          (2 * (window->end - first) + 1) * sizeof(size_t));
+  window->start = first;
+}
+
+/*
+ * Read until the window holds the character at position, sliding it along
+ * when there is less than a chunk of room left.
+ *
+ * Returns:
+ *  1 if the character is in the window, 0 if the sequence ends before it.
+ */
+static int window_has(struct StreamWindow* window, size_t position, size_t first)
+{
+  while(position >= window->end && !window->at_end) {
+    if(window->capacity - (window->end - window->start) < window->chunk_length) {
+      slide_window(window, first);
+    }
+    size_t room = MIN(window->capacity - (window->end - window->start),
+                      window->chunk_length);
+    size_t num_read = window->read_func(window->chars + (window->end - window->start),
+                                        room, window->read_data);
+    if(num_read == 0) window->at_end = 1;
+    window->end += num_read;
+  }
+  return position < window->end;
+}
+
+int manacher_stream(SequenceReadFunc_T read_func, void* read_data,
+                    size_t chunk_length, size_t max_arm_length,
+                    size_t min_length, MaximalPalindromeFunc_T palindrome_func,
+                    void* data)
+{
+  struct StreamWindow window = {NULL, NULL, 0, 0, 0, 0, read_func, read_data,
+                                chunk_length};
+
+  check(read_func && palindrome_func,
+        "manacher_stream needs a read function and a palindrome function.");
+  check(chunk_length > 0, "Chunk length must be positive.");
+
+  /* At most 3 * max_arm_length + 2 characters are kept when the window
+   * slides, so there is always room for a whole chunk after. The window and
+   * its 2 * capacity + 1 radii have to be addressable. */
+  size_t max_capacity = (SIZE_MAX / sizeof(size_t) - 1) / 2;
+  check(max_arm_length <= (max_capacity - 4) / 3 &&
+        chunk_length <= max_capacity - 4 - 3 * max_arm_length,
+        "Chunk length %zu and maximum arm length %zu are too large.",
+        chunk_length, max_arm_length);
+  window.capacity = chunk_length + 3 * max_arm_length + 4;
+  window.chars = malloc(window.capacity * sizeof(char));
+  check_mem(window.chars);
+  window.radii = malloc((2 * window.capacity + 1) * sizeof(size_t));
+  check_mem(window.radii);
+  window.radii[0] = 0;
+
+  size_t pos = 0;
+  size_t current_pal_center = 0;
+  size_t right_boundary = 0;
+
+  /* Center pos is inside the sequence as long as character pos / 2 is. */
+  for(pos = 1; window_has(&window, pos / 2, keep_from(pos, max_arm_length)); pos++) {
+    size_t first = keep_from(pos, max_arm_length);
+    size_t radius = 0;
+    int truncated = 0;
+
+    if(right_boundary > pos) {
+      size_t mirror_pos = 2 * current_pal_center - pos;
+      size_t max_radius = (right_boundary - pos) / 2;
+      radius = MIN(max_radius, window.radii[mirror_pos - 2 * window.start]);
+    }
+
+    while(QUERY_START(pos, radius) > 0) {
+      if(radius == max_arm_length) {
+        truncated = 1;
+        break;
+      }
+      size_t right = QUERY_END(pos, radius + 1);
+      if(!window_has(&window, right, first)) break;
+      if(window.chars[QUERY_START(pos, radius + 1) - window.start] !=
+         window.chars[right - window.start]) break;
+      radius++;
+    }
+
+    window.radii[pos - 2 * window.start] = radius;
+    if(pos + 2 * radius > right_boundary) {
+      current_pal_center = pos;
+      right_boundary = pos + 2 * radius;
+    }
+
+    size_t length = pos % 2 == 1 ? 2 * radius + 1 : 2 * radius;
+    if(length > 0 && length >= min_length) {
+      struct MaximalPalindrome palindrome = {QUERY_START(pos, radius), length,
+                                             truncated};
+      if(palindrome_func(&palindrome, data) != 0) break;
+    }
+  }
+
+  free(window.chars);
+  free(window.radii);
+  return 0;
+
+error:
+  if(window.chars) free(window.chars);
+  if(window.radii) free(window.radii);
+  return 1;
+}
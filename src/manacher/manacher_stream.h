@@ -0,0 +1,94 @@
+#ifndef _manacher_stream_H_
+#define _manacher_stream_H_
+
+#include <stdlib.h>
+
+/* TYPES */
+
+/*
+ * A maximal palindrome found by manacher_stream. It is
+ * sequence[start:start+length], using Python slice syntax, where positions
+ * count from the first character read.
+ *
+ * Members:
+ *  size_t start            :   Position of the first character
+ *  size_t length           :   Number of characters
+ *  int truncated           :   Nonzero if the arm reached max_arm_length, so
+ *                              the palindrome may be longer than reported
+ */
+struct MaximalPalindrome {
+  size_t start;
+  size_t length;
+  int    truncated;
+};
+
+/*
+ * The function pointer type manacher_stream calls to read the sequence.
+ *
+ * Params:
+ *  char* buffer            :   Where to write the next characters
+ *  size_t length           :   Room in buffer
+ *  void* data              :   Pointer to caller data
+ *
+ * Returns:
+ *  The number of characters written, at most length, and 0 only at the end of
+ *  the sequence.
+ */
+typedef size_t (*SequenceReadFunc_T)(char* buffer, size_t length, void* data);
+
+/*
+ * The function pointer type called for each palindrome found by
+ * manacher_stream.
+ *
+ * Params:
+ *  const struct MaximalPalindrome* palindrome  :   The palindrome found. Only
+ *                                                  valid during the call.
+ *  void* data                                  :   Pointer to caller data.
+ *
+ * Returns:
+ *  0 to continue the search, anything else to stop it.
+ */
+typedef int (*MaximalPalindromeFunc_T)(const struct MaximalPalindrome* palindrome,
+                                       void* data);
+
+/* FUNCTIONS */
+
+/*
+ * Run Manacher's algorithm on a sequence read a chunk at a time, calling
+ * palindrome_func on the maximal palindrome at each center that is at least
+ * min_length long, in order of center, as soon as its radius is known.
+ *
+ * Only a window of the sequence is held: the chunk being read, and enough of
+ * the characters and radii before the current center to extend an arm of
+ * max_arm_length and to look up its mirror. Memory is O(chunk_length +
+ * max_arm_length) however long the sequence is. A single pass can't know
+ * how far back a later palindrome will reach, so arms stop growing at
+ * max_arm_length and those palindromes are reported as truncated. Every
+ * radius is otherwise the same as manacher would give, capped at
+ * max_arm_length.
+ *
+ * Params:
+ *  SequenceReadFunc_T read_func            :   Reads the sequence
+ *  void* read_data                         :   Passed to read_func
+ *  size_t chunk_length                     :   Most characters to read at
+ *                                              once. Must be positive.
+ *  size_t max_arm_length                   :   Longest arm, not counting a
+ *                                              center character, to extend.
+ *                                              It sizes the window, so it
+ *                                              can't be SIZE_MAX to mean
+ *                                              unbounded.
+ *  size_t min_length                       :   Shortest palindrome to report.
+ *                                              Empty palindromes are never
+ *                                              reported.
+ *  MaximalPalindromeFunc_T palindrome_func :   Called on every palindrome
+ *  void* data                              :   Passed to palindrome_func
+ *
+ * Returns:
+ *  0 if the search completed or was stopped by palindrome_func, else 1.
+ */
+int manacher_stream(SequenceReadFunc_T read_func, void* read_data,
+                    size_t chunk_length, size_t max_arm_length,
+                    size_t min_length, MaximalPalindromeFunc_T palindrome_func,
+                    void* data);
+
+#endif
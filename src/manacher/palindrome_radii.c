@@ -0,0 +1,192 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "palindrome_radii.h"
+#include "manacher_private.h"
+
+#include "utils/dbg.h"
+
+struct PalindromeRadii_T {
+  enum RadiusWidth width;
+  uint16_t*        radii16;
+  uint32_t*        radii32;
+  size_t           length;
+  /* The stored value meaning "look in the overflow table" */
+  size_t           escape;
+  /* Radii that don't fit, in order of center */
+  size_t*          overflow_centers;
+  size_t*          overflow_radii;
+  size_t           num_overflows;
+  size_t           num_overflows_allocated;
+};
+
+/* Binary search the overflow table for the radius at center. */
+static size_t get_overflow(const struct PalindromeRadii_T* radii, size_t center)
+{
+  size_t low = 0;
+  size_t high = radii->num_overflows;
+  while(low < high) {
+    size_t mid = low + (high - low) / 2;
+    if(radii->overflow_centers[mid] < center) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return radii->overflow_radii[low];
+}
+
+static inline size_t get_radius(const struct PalindromeRadii_T* radii, size_t center)
+{
+  size_t value = radii->width == RADIUS_WIDTH_16 ? radii->radii16[center] :
+                                                   radii->radii32[center];
+  if(value != radii->escape) return value;
+  return get_overflow(radii, center);
+}
+
+/*
+ * Set the radius at center. Centers must be set in increasing order, so that
+ * the overflow table stays sorted.
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+static inline int set_radius(struct PalindromeRadii_T* radii, size_t center,
+                             size_t radius)
+{
+  if(radius >= radii->escape) {
+    if(radii->num_overflows == radii->num_overflows_allocated) {
+      size_t new_num_allocated = radii->num_overflows_allocated ?
+                                 2 * radii->num_overflows_allocated : 16;
+      size_t* tmp_centers = realloc(radii->overflow_centers,
+                                    new_num_allocated * sizeof(size_t));
+      check_mem(tmp_centers);
+      radii->overflow_centers = tmp_centers;
+      size_t* tmp_radii = realloc(radii->overflow_radii,
+                                  new_num_allocated * sizeof(size_t));
+      check_mem(tmp_radii);
+      radii->overflow_radii = tmp_radii;
+      radii->num_overflows_allocated = new_num_allocated;
+    }
+    radii->overflow_centers[radii->num_overflows] = center;
+    radii->overflow_radii[radii->num_overflows] = radius;
+    radii->num_overflows++;
+    radius = radii->escape;
+  }
+
+  if(radii->width == RADIUS_WIDTH_16) {
+    radii->radii16[center] = radius;
+  } else {
+    radii->radii32[center] = radius;
+  }
+  return 0;
+
+error:
+  return 1;
+}
+
+static size_t get_radius_func(const void* radii, size_t center)
+{
+  return get_radius(radii, center);
+}
+
+PalindromeRadii_T manacher_narrow(char* query_string, size_t query_length,
+                                  enum RadiusWidth width)
+{
+  PalindromeRadii_T radii = NULL;
+
+  check(width == RADIUS_WIDTH_16 || width == RADIUS_WIDTH_32,
+        "Radius width must be 16 or 32 bits, not %d.", width);
+
+  radii = calloc(1, sizeof(struct PalindromeRadii_T));
+  check_mem(radii);
+  radii->width = width;
+  radii->length = 2 * query_length + 1;
+  if(width == RADIUS_WIDTH_16) {
+    radii->escape = UINT16_MAX;
+    radii->radii16 = calloc(radii->length, sizeof(uint16_t));
+    check_mem(radii->radii16);
+  } else {
+    radii->escape = UINT32_MAX;
+    radii->radii32 = calloc(radii->length, sizeof(uint32_t));
+    check_mem(radii->radii32);
+  }
+
+  /* The same loop as manacher, but keeping the radius being extended and the
+   * right boundary of the current palindrome in locals. */
+  size_t pal_radii_pos = 0;
+  size_t current_pal_center = 0;
+  size_t right_boundary = 0;
+
+  for(pal_radii_pos = 1; pal_radii_pos < radii->length - 1; pal_radii_pos++) {
+    size_t radius = 0;
+
+    if(right_boundary > pal_radii_pos) {
+      size_t mirror_pos = 2 * current_pal_center - pal_radii_pos;
+      size_t max_radius = (right_boundary - pal_radii_pos) / 2;
+      radius = MIN(max_radius, get_radius(radii, mirror_pos));
+    }
+
+    radius += extend_arms(query_string, query_length, pal_radii_pos / 2 - radius,
+                          (pal_radii_pos - 1) / 2 + radius);
+
+    int rc = set_radius(radii, pal_radii_pos, radius);
+    check(rc == 0, "Failed to store radius at %zu.", pal_radii_pos);
+
+    if(pal_radii_pos + 2 * radius > right_boundary) {
+      current_pal_center = pal_radii_pos;
+      right_boundary = pal_radii_pos + 2 * radius;
+    }
+  }
+
+  return radii;
+
+error:
+  PalindromeRadii_delete(&radii);
+  return NULL;
+}
+
+void PalindromeRadii_delete(PalindromeRadii_T* radii)
+{
+  if(!radii || !*radii) return;
+  if((*radii)->radii16) free((*radii)->radii16);
+  if((*radii)->radii32) free((*radii)->radii32);
+  if((*radii)->overflow_centers) free((*radii)->overflow_centers);
+  if((*radii)->overflow_radii) free((*radii)->overflow_radii);
+  free(*radii);
+  *radii = NULL;
+}
+
+size_t PalindromeRadii_get(PalindromeRadii_T radii, size_t center)
+{
+  return get_radius(radii, center);
+}
+
+size_t PalindromeRadii_get_length(PalindromeRadii_T radii)
+{
+  return radii->length;
+}
+
+size_t PalindromeRadii_get_num_overflows(PalindromeRadii_T radii)
+{
+  return radii->num_overflows;
+}
+
+size_t PalindromeRadii_get_size(PalindromeRadii_T radii)
+{
+  return sizeof(struct PalindromeRadii_T) +
+         radii->length * (radii->width / 8) +
+         2 * radii->num_overflows_allocated * sizeof(size_t);
+}
+
+int verify_palindrome_radii_narrow(char* query_string, size_t query_length,
+                                   PalindromeRadii_T radii)
+{
+  return verify_radii(query_string, query_length, get_radius_func, radii);
+}
+
+char* longest_palindrome_narrow(char* query_string, size_t query_length,
+                                PalindromeRadii_T radii)
+{
+  return longest_radius(query_string, query_length, get_radius_func, radii);
+}
@@ -0,0 +1,65 @@
+#ifndef _palindrome_radii_H_
+#define _palindrome_radii_H_
+
+#include <stdlib.h>
+
+/* TYPES */
+
+/* The number of bits used for each radius in a PalindromeRadii_T. */
+enum RadiusWidth {
+  RADIUS_WIDTH_16 = 16,
+  RADIUS_WIDTH_32 = 32
+};
+
+/*
+ * The radii that manacher finds, kept in 16 or 32 bits apiece instead of a
+ * size_t. Radii too big for the width are stored as the largest value of the
+ * width, and the real radius is kept in an overflow table sorted by center.
+ * Nearly every radius in real sequence is small, so the table stays short and
+ * the radii take a quarter or an eighth of the memory.
+ */
+typedef struct PalindromeRadii_T* PalindromeRadii_T;
+
+/* FUNCTIONS */
+
+/*
+ * Run Manacher's algorithm on a string like manacher, but keep the radii in
+ * width bits apiece.
+ *
+ * Input:
+ *    char* query_string      :   String to be search for palindromes
+ *    size_t query_length     :   Length of query_string, not including null
+ *                                terminator
+ *    enum RadiusWidth width  :   Bits per radius
+ *
+ * Output:
+ *    PalindromeRadii_T radii :   Radius of maximal palindrome at each possible
+ *                                center, or NULL on failure
+ */
+PalindromeRadii_T manacher_narrow(char* query_string, size_t query_length,
+                                  enum RadiusWidth width);
+
+/* Delete a PalindromeRadii_T, freeing all its memory. */
+void   PalindromeRadii_delete(PalindromeRadii_T* radii);
+
+/* The radius of the maximal palindrome at center, from 0 to 2 * length. */
+size_t PalindromeRadii_get(PalindromeRadii_T radii, size_t center);
+
+/* The number of centers, which is 2 * query_length + 1. */
+size_t PalindromeRadii_get_length(PalindromeRadii_T radii);
+
+/* The number of radii that didn't fit in the width. */
+size_t PalindromeRadii_get_num_overflows(PalindromeRadii_T radii);
+
+/* The number of bytes of memory held by a PalindromeRadii_T. */
+size_t PalindromeRadii_get_size(PalindromeRadii_T radii);
+
+/* verify_palindrome_radii for a PalindromeRadii_T. */
+int    verify_palindrome_radii_narrow(char* query_string, size_t query_length,
+                                      PalindromeRadii_T radii);
+
+/* longest_palindrome for a PalindromeRadii_T. */
+char*  longest_palindrome_narrow(char* query_string, size_t query_length,
+                                 PalindromeRadii_T radii);
+
+#endif
@@ -0,0 +1,97 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "packed_sequence.h"
+#include "packed_sequence_private.h"
+
+#include "utils/dbg.h"
+
+#define MAX(A, B) ((A) > (B) ? A : B)
+
+/* One more than the code of each base, and 0 for an N. */
+static const unsigned char CODES[256] = {
+  ['A'] = 1, ['C'] = 2, ['G'] = 3, ['T'] = 4,
+  ['a'] = 1, ['c'] = 2, ['g'] = 3, ['t'] = 4
+};
+
+PackedSequence_T PackedSequence_create(const char* str, size_t length)
+{
+  PackedSequence_T sequence = calloc(1, sizeof(struct PackedSequence_T));
+  check_mem(sequence);
+
+  sequence->length = length;
+  sequence->num_base_words = length / BASES_PER_WORD + 1;
+  sequence->num_mask_words = length / FLAGS_PER_WORD + 1;
+  sequence->bases = calloc(sequence->num_base_words + 1, sizeof(uint64_t));
+  check_mem(sequence->bases);
+  sequence->n_mask = calloc(sequence->num_mask_words + 1, sizeof(uint64_t));
+  check_mem(sequence->n_mask);
+
+  size_t i = 0;
+  for(i = 0; i < length; i++) {
+    unsigned int code = CODES[(unsigned char)str[i]];
+    sequence->bases[i / BASES_PER_WORD] |=
+        (uint64_t)((code - 1) & 3 & -(code != 0)) << (2 * (i % BASES_PER_WORD));
+    sequence->n_mask[i / FLAGS_PER_WORD] |= (uint64_t)(code == 0) << (i % FLAGS_PER_WORD);
+    sequence->num_n += code == 0;
+  }
+
+  return sequence;
+
+error:
+  PackedSequence_delete(&sequence);
+  return NULL;
+}
+
+void PackedSequence_delete(PackedSequence_T* sequence)
+{
+  if(!sequence || !*sequence) return;
+  if((*sequence)->bases) free((*sequence)->bases);
+  if((*sequence)->n_mask) free((*sequence)->n_mask);
+  free(*sequence);
+  *sequence = NULL;
+}
+
+size_t PackedSequence_get_length(PackedSequence_T sequence)
+{
+  return sequence->length;
+}
+
+char PackedSequence_get(PackedSequence_T sequence, size_t position)
+{
+  if(n_at(sequence, position)) return 'N';
+  return "ACGT"[code_at(sequence, position)];
+}
+
+size_t PackedSequence_get_size(PackedSequence_T sequence)
+{
+  return sizeof(struct PackedSequence_T) +
+         (sequence->num_base_words + sequence->num_mask_words + 2) * sizeof(uint64_t);
+}
+
+size_t PackedSequence_lce(PackedSequence_T sequence, size_t position1,
+                          size_t position2)
+{
+  size_t max_length = sequence->length - MAX(position1, position2);
+  size_t length = 0;
+
+  /* Past the end of the sequence are zero words, so the last step can read
+   * over it and be cut back afterwards. */
+  while(length < max_length) {
+    uint64_t base_diff = bases_from(sequence, position1 + length) ^
+                         bases_from(sequence, position2 + length);
+    uint32_t n_diff = n_from(sequence, position1 + length) ^
+                      n_from(sequence, position2 + length);
+    size_t first = first_difference(base_diff, n_diff);
+    if(first < BASES_PER_WORD) return MIN(length + first, max_length);
+    length += BASES_PER_WORD;
+  }
+  return max_length;
+}
+
+size_t PackedSequence_extend_arms(PackedSequence_T sequence, size_t left,
+                                  size_t right)
+{
+  if(sequence->num_n == 0) return extend_packed_arms(sequence, left, right, 0);
+  return extend_packed_arms(sequence, left, right, 1);
+}
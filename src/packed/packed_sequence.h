@@ -0,0 +1,60 @@
+#ifndef _packed_sequence_H_
+#define _packed_sequence_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/* TYPES */
+
+/*
+ * A PackedSequence_T holds a DNA sequence in two bits per base, 32 bases to a
+ * 64-bit word, with A, C, G and T as 0 to 3 so that a base's complement is
+ * its code with both bits flipped. Anything other than A, C, G or T, in
+ * either case, is an N, which is marked in a side bitmap of one bit per base.
+ * N is equal to N and to nothing else. All told that is 3 bits a base, and
+ * the sequence doesn't need the string it came from.
+ *
+ * Comparisons are made a word at a time: 32 bases from each side are lined up
+ * with shifts, XORed together, and the first set bit is the first mismatch.
+ */
+typedef struct PackedSequence_T* PackedSequence_T;
+
+/* FUNCTIONS */
+
+/*
+ * Pack the first length characters of str.
+ *
+ * Returns:
+ *  PackedSequence_T sequence, or NULL on failure.
+ */
+PackedSequence_T PackedSequence_create(const char* str, size_t length);
+
+/* Delete a PackedSequence_T, freeing all its memory. */
+void             PackedSequence_delete(PackedSequence_T* sequence);
+
+/* The number of bases in the sequence. */
+size_t           PackedSequence_get_length(PackedSequence_T sequence);
+
+/* The base at position, as one of 'A', 'C', 'G', 'T' or 'N'. */
+char             PackedSequence_get(PackedSequence_T sequence, size_t position);
+
+/* The number of bytes of memory the sequence takes. */
+size_t           PackedSequence_get_size(PackedSequence_T sequence);
+
+/*
+ * The longest common extension of two positions: the number of bases the
+ * sequence has in common starting at each of them.
+ */
+size_t           PackedSequence_lce(PackedSequence_T sequence, size_t position1,
+                                    size_t position2);
+
+/*
+ * Count how many more bases each arm of the palindrome sequence[left:right+1]
+ * can be extended by, stopping at either end of the sequence. An empty
+ * palindrome between two bases has right = left - 1. This is extend_arms from
+ * manacher for a packed sequence.
+ */
+size_t           PackedSequence_extend_arms(PackedSequence_T sequence, size_t left,
+                                            size_t right);
+
+#endif
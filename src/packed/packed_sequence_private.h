@@ -0,0 +1,127 @@
+#ifndef _packed_sequence_private_H_
+#define _packed_sequence_private_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "packed_sequence.h"
+
+#define MIN(A, B) ((A) < (B) ? A : B)
+
+/* Bases and N flags per word */
+#define BASES_PER_WORD 32
+#define FLAGS_PER_WORD 64
+
+struct PackedSequence_T {
+  /* Both arrays have a spare zero word at the end, so that BASES_PER_WORD
+   * bases can be read from any position in the sequence. */
+  uint64_t* bases;
+  uint64_t* n_mask;
+  size_t    length;
+  size_t    num_base_words;
+  size_t    num_mask_words;
+  size_t    num_n;
+};
+
+static inline unsigned int code_at(const PackedSequence_T sequence, size_t position)
+{
+  return (sequence->bases[position / BASES_PER_WORD] >>
+          (2 * (position % BASES_PER_WORD))) & 3;
+}
+
+static inline unsigned int n_at(const PackedSequence_T sequence, size_t position)
+{
+  return (sequence->n_mask[position / FLAGS_PER_WORD] >>
+          (position % FLAGS_PER_WORD)) & 1;
+}
+
+/* The 32 bases starting at position, the first in the lowest two bits. */
+static inline uint64_t bases_from(const PackedSequence_T sequence, size_t position)
+{
+  size_t word = position / BASES_PER_WORD;
+  unsigned int shift = 2 * (position % BASES_PER_WORD);
+  uint64_t bases = sequence->bases[word] >> shift;
+  if(shift) bases |= sequence->bases[word + 1] << (64 - shift);
+  return bases;
+}
+
+/* The N flags of the 32 bases starting at position. */
+static inline uint32_t n_from(const PackedSequence_T sequence, size_t position)
+{
+  size_t word = position / FLAGS_PER_WORD;
+  unsigned int shift = position % FLAGS_PER_WORD;
+  uint64_t flags = sequence->n_mask[word] >> shift;
+  if(shift) flags |= sequence->n_mask[word + 1] << (64 - shift);
+  return (uint32_t)flags;
+}
+
+static inline uint64_t reverse_bases(uint64_t bases)
+{
+  bases = __builtin_bswap64(bases);
+  bases = ((bases >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((bases & 0x0F0F0F0F0F0F0F0FULL) << 4);
+  return ((bases >> 2) & 0x3333333333333333ULL) | ((bases & 0x3333333333333333ULL) << 2);
+}
+
+static inline uint32_t reverse_flags(uint32_t flags)
+{
+  flags = __builtin_bswap32(flags);
+  flags = ((flags >> 4) & 0x0F0F0F0F) | ((flags & 0x0F0F0F0F) << 4);
+  flags = ((flags >> 2) & 0x33333333) | ((flags & 0x33333333) << 2);
+  return ((flags >> 1) & 0x55555555) | ((flags & 0x55555555) << 1);
+}
+
+/*
+ * The first of 32 lined up bases that differ, given the XOR of their codes
+ * and of their N flags, or 32 if they are all the same.
+ */
+static inline size_t first_difference(uint64_t base_diff, uint32_t n_diff)
+{
+  size_t first_base = base_diff ? __builtin_ctzll(base_diff) / 2 : BASES_PER_WORD;
+  size_t first_n = n_diff ? __builtin_ctz(n_diff) : BASES_PER_WORD;
+  return MIN(first_base, first_n);
+}
+
+/* Without any Ns, only the codes need comparing. */
+static inline int same_base(const PackedSequence_T sequence, size_t position1,
+                            size_t position2, int has_n)
+{
+  unsigned int diff = code_at(sequence, position1) ^ code_at(sequence, position2);
+  if(has_n) diff |= n_at(sequence, position1) ^ n_at(sequence, position2);
+  return diff == 0;
+}
+
+/*
+ * PackedSequence_extend_arms, inline for manacher_packed, where most arms stop
+ * at the first pair. has_n is whether the sequence has any Ns, and is meant to
+ * be a constant, so that a sequence without them needn't look at the N flags.
+ */
+static inline size_t extend_packed_arms(const PackedSequence_T sequence, size_t left,
+                                        size_t right, int has_n)
+{
+  size_t max_steps = MIN(left, sequence->length - 1 - right);
+  if(max_steps == 0 || !same_base(sequence, left - 1, right + 1, has_n)) return 0;
+  size_t steps = 1;
+
+  /* The left arm is read forward and reversed, so it can't start before the
+   * sequence, but the right arm can run over its end. */
+  while(steps < max_steps && steps + BASES_PER_WORD <= left) {
+    size_t left_start = left - steps - BASES_PER_WORD;
+    uint64_t base_diff = bases_from(sequence, right + 1 + steps) ^
+                         reverse_bases(bases_from(sequence, left_start));
+    uint32_t n_diff = 0;
+    if(has_n) n_diff = n_from(sequence, right + 1 + steps) ^
+                       reverse_flags(n_from(sequence, left_start));
+    size_t first = first_difference(base_diff, n_diff);
+    if(first < BASES_PER_WORD) return MIN(steps + first, max_steps);
+    steps += BASES_PER_WORD;
+  }
+  if(steps >= max_steps) return max_steps;
+
+  while(steps < max_steps &&
+        same_base(sequence, left - 1 - steps, right + 1 + steps, has_n)) {
+    steps++;
+  }
+  return steps;
+}
+
+#endif
@@ -0,0 +1,393 @@
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "suffix_array.h"
+
+#include "lca/lce.h"
+#include "utils/dbg.h"
+
+#define MIN(a,b) ((a) < (b) ? a : b)
+#define MAX(a,b) ((a) > (b) ? a : b)
+
+/* Marks a slot of the suffix array that hasn't been filled yet */
+#define EMPTY UINT32_MAX
+
+struct SuffixArray_T {
+  size_t        length;
+  /* Start positions of the suffixes, in sorted order */
+  uint32_t*     suffixes;
+  /* The ranks of the suffixes, their LCP array, and range minima over it */
+  LCE_T         lce;
+};
+
+/*
+ * SA-IS, as described by Nong, Zhang and Chan in "Two Efficient Algorithms
+ * for Linear Time Suffix Array Construction". Suffixes are classified as
+ * S-type if they are smaller than the suffix after them and L-type if
+ * larger. The leftmost S-type suffixes of each run (LMS suffixes) are sorted
+ * first, by recursing on a string of names for the substrings between them,
+ * and the order of every other suffix is then induced from them.
+ */
+
+/* Whether the suffix at i is an LMS suffix */
+#define IS_LMS(types, i) ((i) > 0 && (types)[i] && !(types)[(i) - 1])
+
+/*
+ * Find the start, or one past the end, of the bucket of each character in
+ * str, where a bucket is the range of the suffix array holding the suffixes
+ * that start with that character.
+ */
+void get_buckets(const uint32_t* str, size_t length, size_t alphabet_size,
+                 uint32_t* buckets, int ends)
+{
+  size_t i = 0;
+  uint32_t sum = 0;
+
+  memset(buckets, 0, alphabet_size * sizeof(uint32_t));
+  for(i = 0; i < length; i++) {
+    buckets[str[i]]++;
+  }
+  for(i = 0; i < alphabet_size; i++) {
+    sum += buckets[i];
+    buckets[i] = ends ? sum : sum - buckets[i];
+  }
+}
+
+/* Place each L-type suffix after the suffix that follows it. */
+void induce_l_suffixes(const uint32_t* str, uint32_t* suffixes, size_t length,
+                       size_t alphabet_size, const unsigned char* types,
+                       uint32_t* buckets)
+{
+  size_t i = 0;
+  get_buckets(str, length, alphabet_size, buckets, 0);
+  for(i = 0; i < length; i++) {
+    if(suffixes[i] == EMPTY || suffixes[i] == 0) continue;
+    uint32_t j = suffixes[i] - 1;
+    if(!types[j]) {
+      suffixes[buckets[str[j]]++] = j;
+    }
+  }
+}
+
+/* Place each S-type suffix before the suffix that follows it. */
+void induce_s_suffixes(const uint32_t* str, uint32_t* suffixes, size_t length,
+                       size_t alphabet_size, const unsigned char* types,
+                       uint32_t* buckets)
+{
+  size_t i = 0;
+  get_buckets(str, length, alphabet_size, buckets, 1);
+  for(i = length; i > 0; i--) {
+    if(suffixes[i - 1] == EMPTY || suffixes[i - 1] == 0) continue;
+    uint32_t j = suffixes[i - 1] - 1;
+    if(types[j]) {
+      suffixes[--buckets[str[j]]] = j;
+    }
+  }
+}
+
+/*
+ * Sort the suffixes of str, whose characters are less than alphabet_size and
+ * whose last character is a 0 that appears nowhere else.
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+int sais(const uint32_t* str, uint32_t* suffixes, size_t length,
+         size_t alphabet_size)
+{
+  unsigned char* types = NULL;
+  uint32_t* buckets = NULL;
+  size_t i = 0, j = 0;
+
+  if(length == 1) {
+    suffixes[0] = 0;
+    return 0;
+  }
+
+  /* Classify the suffixes. 1 is S-type, 0 is L-type. */
+  types = malloc(length * sizeof(unsigned char));
+  check_mem(types);
+  types[length - 1] = 1;
+  types[length - 2] = 0;
+  for(i = length - 2; i > 0; i--) {
+    types[i - 1] = str[i - 1] < str[i] ||
+                   (str[i - 1] == str[i] && types[i]);
+  }
+
+  buckets = malloc(alphabet_size * sizeof(uint32_t));
+  check_mem(buckets);
+
+  /* Sort the LMS substrings by inducing from the LMS suffixes placed at the
+   * ends of their buckets in any order. */
+  get_buckets(str, length, alphabet_size, buckets, 1);
+  for(i = 0; i < length; i++) {
+    suffixes[i] = EMPTY;
+  }
+  for(i = 1; i < length; i++) {
+    if(IS_LMS(types, i)) {
+      suffixes[--buckets[str[i]]] = i;
+    }
+  }
+  induce_l_suffixes(str, suffixes, length, alphabet_size, types, buckets);
+  induce_s_suffixes(str, suffixes, length, alphabet_size, types, buckets);
+
+  /* Move the sorted LMS substrings to the front. */
+  size_t num_lms = 0;
+  for(i = 0; i < length; i++) {
+    if(IS_LMS(types, suffixes[i])) {
+      suffixes[num_lms++] = suffixes[i];
+    }
+  }
+
+  /* Name the LMS substrings so that equal substrings get equal names and the
+   * names are in sorted order. No two LMS positions are adjacent, so the name
+   * of position p can be kept at num_lms + p/2. */
+  for(i = num_lms; i < length; i++) {
+    suffixes[i] = EMPTY;
+  }
+  uint32_t num_names = 0;
+  uint32_t prev = EMPTY;
+  for(i = 0; i < num_lms; i++) {
+    uint32_t pos = suffixes[i];
+    int differs = 0;
+    size_t d = 0;
+    for(d = 0; d < length; d++) {
+      if(prev == EMPTY || str[pos + d] != str[prev + d] ||
+         types[pos + d] != types[prev + d]) {
+        differs = 1;
+        break;
+      } else if(d > 0 && (IS_LMS(types, pos + d) || IS_LMS(types, prev + d))) {
+        break;
+      }
+    }
+    if(differs) {
+      num_names++;
+      prev = pos;
+    }
+    suffixes[num_lms + pos / 2] = num_names - 1;
+  }
+  for(i = length, j = length; i > num_lms; i--) {
+    if(suffixes[i - 1] != EMPTY) {
+      suffixes[--j] = suffixes[i - 1];
+    }
+  }
+
+  /* Sort the LMS suffixes. If every name is different, their order is the
+   * order of the names; otherwise, recurse on the string of names. */
+  uint32_t* reduced = suffixes + length - num_lms;
+  if(num_names < num_lms) {
+    int rc = sais(reduced, suffixes, num_lms, num_names);
+    check(rc == 0, "Failed to sort reduced string.");
+  } else {
+    for(i = 0; i < num_lms; i++) {
+      suffixes[reduced[i]] = i;
+    }
+  }
+
+  /* Turn ranks in the reduced string back into positions, put the LMS
+   * suffixes at the ends of their buckets in sorted order, and induce the
+   * rest. */
+  for(i = 1, j = 0; i < length; i++) {
+    if(IS_LMS(types, i)) {
+      reduced[j++] = i;
+    }
+  }
+  for(i = 0; i < num_lms; i++) {
+    suffixes[i] = reduced[suffixes[i]];
+  }
+  for(i = num_lms; i < length; i++) {
+    suffixes[i] = EMPTY;
+  }
+  get_buckets(str, length, alphabet_size, buckets, 1);
+  for(i = num_lms; i > 0; i--) {
+    uint32_t pos = suffixes[i - 1];
+    suffixes[i - 1] = EMPTY;
+    suffixes[--buckets[str[pos]]] = pos;
+  }
+  induce_l_suffixes(str, suffixes, length, alphabet_size, types, buckets);
+  induce_s_suffixes(str, suffixes, length, alphabet_size, types, buckets);
+
+  free(types);
+  free(buckets);
+  return 0;
+
+error:
+  if(types) free(types);
+  if(buckets) free(buckets);
+  return 1;
+}
+
+/*
+ * Kasai's algorithm. The LCP of the suffix at i + 1 with the suffix before it
+ * is at least one less than that of the suffix at i, so the number of
+ * character comparisons is linear.
+ */
+void compute_lcp(const char* str, size_t length, const uint32_t* suffixes,
+                 const uint32_t* ranks, uint32_t* lcp)
+{
+  size_t i = 0, h = 0;
+
+  for(i = 0; i < length; i++) {
+    if(ranks[i] == 0) {
+      lcp[0] = 0;
+      h = 0;
+      continue;
+    }
+    size_t j = suffixes[ranks[i] - 1];
+    while(i + h < length && j + h < length && str[i + h] == str[j + h]) {
+      h++;
+    }
+    lcp[ranks[i]] = h;
+    if(h > 0) h--;
+  }
+}
+
+SuffixArray_T SuffixArray_create(const char* str, size_t length)
+{
+  SuffixArray_T suffix_array = NULL;
+  uint32_t* text = NULL;
+  uint32_t* all_suffixes = NULL;
+  uint32_t* ranks = NULL;
+  uint32_t* lcp = NULL;
+  size_t i = 0;
+
+  check(str, "Cannot create a suffix array without a string.");
+  check(length < UINT32_MAX - 1, "String of length %zu is too long for a "
+        "suffix array.", length);
+
+  suffix_array = calloc(1, sizeof(struct SuffixArray_T));
+  check_mem(suffix_array);
+  suffix_array->length = length;
+
+  /* SA-IS wants a terminating character smaller than all others, so shift
+   * the characters up by one and end with 0. */
+  text = malloc((length + 1) * sizeof(uint32_t));
+  check_mem(text);
+  for(i = 0; i < length; i++) {
+    text[i] = (unsigned char)str[i] + 1;
+  }
+  text[length] = 0;
+
+  all_suffixes = malloc((length + 1) * sizeof(uint32_t));
+  check_mem(all_suffixes);
+  int rc = sais(text, all_suffixes, length + 1, UCHAR_MAX + 2);
+  check(rc == 0, "Failed to sort suffixes.");
+  free(text);
+  text = NULL;
+
+  /* The terminator's suffix always comes first. Drop it. */
+  memmove(all_suffixes, all_suffixes + 1, length * sizeof(uint32_t));
+  suffix_array->suffixes = all_suffixes;
+  all_suffixes = NULL;
+
+  ranks = malloc(MAX(length, 1) * sizeof(uint32_t));
+  check_mem(ranks);
+  for(i = 0; i < length; i++) {
+    ranks[suffix_array->suffixes[i]] = i;
+  }
+
+  lcp = malloc(MAX(length, 1) * sizeof(uint32_t));
+  check_mem(lcp);
+  compute_lcp(str, length, suffix_array->suffixes, ranks, lcp);
+
+  /* The LCE_T owns ranks and lcp from here on, even if it fails. */
+  suffix_array->lce = LCE_create(ranks, lcp, length, length);
+  ranks = NULL;
+  lcp = NULL;
+  check(suffix_array->lce, "Failed to create LCE structure.");
+
+  return suffix_array;
+
+error:
+  if(text) free(text);
+  if(all_suffixes) free(all_suffixes);
+  if(ranks) free(ranks);
+  if(lcp) free(lcp);
+  SuffixArray_delete(&suffix_array);
+  return NULL;
+}
+
+void SuffixArray_delete(SuffixArray_T* suffix_array)
+{
+  if(!suffix_array) return;
+
+  if(*suffix_array) {
+    if((*suffix_array)->suffixes) free((*suffix_array)->suffixes);
+    LCE_delete(&(*suffix_array)->lce);
+    free(*suffix_array);
+    *suffix_array = NULL;
+  }
+}
+
+size_t SuffixArray_get_length(SuffixArray_T suffix_array)
+{
+  return suffix_array->length;
+}
+
+size_t SuffixArray_get_suffix(SuffixArray_T suffix_array, size_t rank)
+{
+  return suffix_array->suffixes[rank];
+}
+
+size_t SuffixArray_get_rank(SuffixArray_T suffix_array, size_t pos)
+{
+  return LCE_get_rank(suffix_array->lce, pos);
+}
+
+size_t SuffixArray_get_lcp(SuffixArray_T suffix_array, size_t rank)
+{
+  return LCE_get_lcp(suffix_array->lce, rank);
+}
+
+size_t SuffixArray_lce(SuffixArray_T suffix_array, size_t pos1, size_t pos2)
+{
+  return LCE_lookup(suffix_array->lce, pos1, pos2);
+}
+
+LCE_T SuffixArray_get_lce(SuffixArray_T suffix_array)
+{
+  return suffix_array->lce;
+}
+
+/* Compare two suffixes of str by brute force. */
+int compare_suffixes(const char* str, size_t length, size_t pos1, size_t pos2,
+                     size_t* common)
+{
+  size_t h = 0;
+  while(pos1 + h < length && pos2 + h < length && str[pos1 + h] == str[pos2 + h]) {
+    h++;
+  }
+  *common = h;
+  if(pos1 + h == length) return -1;
+  if(pos2 + h == length) return 1;
+  return (unsigned char)str[pos1 + h] < (unsigned char)str[pos2 + h] ? -1 : 1;
+}
+
+int SuffixArray_verify(SuffixArray_T suffix_array, const char* str)
+{
+  size_t length = suffix_array->length;
+  size_t i = 0, common = 0;
+
+  for(i = 0; i < length; i++) {
+    if(SuffixArray_get_rank(suffix_array, suffix_array->suffixes[i]) != i) {
+      log_warn("Rank of suffix %u is not %zu.", suffix_array->suffixes[i], i);
+      return 1;
+    }
+    if(i == 0) continue;
+
+    int cmp = compare_suffixes(str, length, suffix_array->suffixes[i - 1],
+                               suffix_array->suffixes[i], &common);
+    if(cmp >= 0) {
+      log_warn("Suffixes with ranks %zu and %zu are out of order.", i - 1, i);
+      return 1;
+    }
+    if(common != SuffixArray_get_lcp(suffix_array, i)) {
+      log_warn("LCP at rank %zu should be %zu, but it is %zu.", i, common,
+               SuffixArray_get_lcp(suffix_array, i));
+      return 1;
+    }
+  }
+
+  return LCE_verify(suffix_array->lce, str);
+}
@@ -0,0 +1,101 @@
+#ifndef _suffix_array_H_
+#define _suffix_array_H_
+
+#include <stdlib.h>
+
+#include "lca/lce.h"
+
+/* TYPES */
+
+/*
+ * A SuffixArray_T holds the suffixes of a string in sorted order, the length
+ * of the longest common prefix of each suffix and the one before it, and a
+ * range minimum structure over those lengths. Together they answer the
+ * questions that are otherwise asked of a suffix tree: the order of the
+ * suffixes, and the longest common prefix of any two of them, which is the
+ * string depth of the lowest common ancestor of their leaves.
+ *
+ * Each of the three arrays uses 32 bits per character, so a SuffixArray_T is
+ * a fraction of the size of a SuffixTree_T for the same string. Strings must
+ * be shorter than 2^32 - 1 characters.
+ *
+ * Suffixes are compared as unsigned chars, and a suffix that is a prefix of
+ * another sorts before it, as if the string ended with a unique character
+ * smaller than all others.
+ */
+typedef struct SuffixArray_T* SuffixArray_T;
+
+/* FUNCTIONS */
+
+/*
+ * Create a suffix array with the SA-IS algorithm, then its LCP array with
+ * Kasai's algorithm. Both take linear time.
+ *
+ * Params:
+ *  const char* str     :     The string whose suffixes are sorted. It can
+ *                            contain any character, including '\0'.
+ *  size_t length       :     The length of str. Suffixes are indexed in 32
+ *                            bits, so this must be less than UINT32_MAX - 1.
+ *
+ * Returns:
+ *  The suffix array, or NULL on failure.
+ */
+SuffixArray_T SuffixArray_create(const char* str, size_t length);
+
+/*
+ * Delete the suffix array, freeing all allocated memory.
+ */
+void          SuffixArray_delete(SuffixArray_T* suffix_array);
+
+/*
+ * Get the length of the string the suffix array was created for.
+ */
+size_t        SuffixArray_get_length(SuffixArray_T suffix_array);
+
+/*
+ * Get the start position of the suffix with a given rank. Rank 0 is the
+ * lexicographically smallest suffix.
+ */
+size_t        SuffixArray_get_suffix(SuffixArray_T suffix_array, size_t rank);
+
+/*
+ * Get the rank of the suffix that starts at a position in the string.
+ */
+size_t        SuffixArray_get_rank(SuffixArray_T suffix_array, size_t pos);
+
+/*
+ * Get the length of the longest common prefix of the suffix with a given rank
+ * and the suffix with the rank before it. This is 0 for rank 0.
+ */
+size_t        SuffixArray_get_lcp(SuffixArray_T suffix_array, size_t rank);
+
+/*
+ * Get the length of the longest common prefix of the suffixes that start at
+ * two positions in the string, in constant time.
+ *
+ * Params:
+ *  SuffixArray_T suffix_array  :   Suffix array of the string.
+ *  size_t pos1                 :   Start of the first suffix.
+ *  size_t pos2                 :   Start of the second suffix.
+ *
+ * Returns:
+ *  The length of the longest common prefix. If pos1 == pos2, this is the
+ *  length of the suffix.
+ */
+size_t        SuffixArray_lce(SuffixArray_T suffix_array, size_t pos1, size_t pos2);
+
+/*
+ * Get the LCE_T that answers SuffixArray_lce. It belongs to the suffix array.
+ */
+LCE_T         SuffixArray_get_lce(SuffixArray_T suffix_array);
+
+/*
+ * Run some slow tests to verify that the suffixes are sorted and that the
+ * LCP array and LCE queries are correct.
+ *
+ * Returns:
+ *  0 if tests pass, else 1.
+ */
+int           SuffixArray_verify(SuffixArray_T suffix_array, const char* str);
+
+#endif
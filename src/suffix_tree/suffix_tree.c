@@ -17,9 +17,67 @@ This library is free software; you can redistribute it and/or modify it
 under the same terms as Perl itself.
 *******************************************************************************/
 #include "suffix_tree.h"
+#include "suffix_tree_protected.h"
 
 #include "utils/dbg.h"
 
+/* The largest number of nodes allocated at once by a NodeArena. */
+#define NODE_SLAB_CAPACITY 65536
+
+#define MIN(a,b) ((a) < (b) ? a : b)
+
+
+#ifdef SUFFIX_TREE_COMPACT
+
+/*
+ * In the compact layout all nodes live in one array and refer to each other
+ * by their position in it. A node's position is also its index, so the start
+ * of the array can always be recovered from any node. There is no left
+ * sibling link; the few places that need a left sibling find it by scanning
+ * the father's sons. Edge labels and positions are 32 bits, which limits
+ * the tree to strings shorter than 2^31 characters.
+ */
+
+/* The row of the child table used by a node that has none */
+#define NO_ROW ((uint32_t)-1)
+/* The longest string a compact tree can be built for */
+#define MAX_COMPACT_LENGTH ((SuffixTreeIndex_T)INT32_MAX - 1)
+
+struct Node_T
+{
+   /* A linked list of sons of that node */
+   NodeRef_T   left_son;
+   /* A linked list of right siblings of that node */
+   NodeRef_T   right_sibling;
+   /* That node's father */
+   NodeRef_T   father;
+   /* The node that represents the largest suffix of the current node */
+   NodeRef_T   suffix_link;
+   /* Index of the start position of the node's path */
+   uint32_t    path_position;
+   /* Start index of the incoming edge */
+   uint32_t    edge_label_start;
+   /* End index of the incoming edge */
+   uint32_t    edge_label_end;
+   /* An index for the node, which is also its position in the node array */
+   uint32_t    index;
+   /* The length of the path to the root. */
+   uint32_t    edge_depth;
+   /* The node's row in the tree's child table */
+   uint32_t    children;
+};
+
+/* The reference to a node, which may be NULL */
+static inline NodeRef_T node_ref(Node_T node)
+{
+   return node == NULL ? NO_NODE : (NodeRef_T)node->index;
+}
+
+#define NODE_AT(N, REF)        ((N) - (N)->index + (REF))
+#define REF_TO_NODE(N, REF)    ((REF) == NO_NODE ? NULL : NODE_AT(N, REF))
+#define NODE_TO_REF(M)         node_ref(M)
+
+#else
 
 struct Node_T
 {
@@ -44,24 +102,33 @@ struct Node_T
    SuffixTreeIndex_T                 index;
    /* The length of the path to the root. */
    SuffixTreeIndex_T                 edge_depth;
+   /* The node's row in the tree's child table. This makes the node 88
+   bytes rather than 80; a 32 bit row as in the compact layout would not
+   help, as the fields above leave no padding for it to fill. */
+   SuffixTreeIndex_T                 children;
 };
 
-struct SuffixTree_T
-{
-   /* The virtual end of all leaves */
-   SuffixTreeIndex_T                 e;
-   /* The one and only real source string of the tree. All edge-labels
-      contain only indices to this string and do not contain the characters
-      themselves */
-   char*           tree_string;
-   /* The length of the source string */
-   SuffixTreeIndex_T                 length;
-   /* The number of nodes in the tree */
-   SuffixTreeIndex_T                 num_nodes;
-   /* The node that is the head of all others. It has no siblings nor a
-      father */
-   Node_T                    root;
-};
+/* The row of the child table used by a node that has none */
+#define NO_ROW ((SuffixTreeIndex_T)-1)
+
+#define REF_TO_NODE(N, REF)    (REF)
+#define NODE_TO_REF(M)         (M)
+
+#endif
+
+/* Read and write the link FIELD of node N */
+#define GET_LINK(N, FIELD)     REF_TO_NODE(N, (N)->FIELD)
+#define SET_LINK(N, FIELD, M)  ((N)->FIELD = NODE_TO_REF(M))
+
+/* Node links, which hide how nodes refer to each other. */
+#define SON(N)                 GET_LINK(N, left_son)
+#define SIBLING(N)             GET_LINK(N, right_sibling)
+#define FATHER(N)              GET_LINK(N, father)
+#define SUFFIX_LINK(N)         GET_LINK(N, suffix_link)
+#define SET_SON(N, M)          SET_LINK(N, left_son, M)
+#define SET_SIBLING(N, M)      SET_LINK(N, right_sibling, M)
+#define SET_FATHER(N, M)       SET_LINK(N, father, M)
+#define SET_SUFFIX_LINK(N, M)  SET_LINK(N, suffix_link, M)
 
 /* Used in function trace_string for skipping (Ukkonen's Skip Trick). */
 typedef enum Skip_T     {skip, no_skip}                 Skip_T;
@@ -71,8 +138,6 @@ typedef enum Rule2_T   {new_son, split}                Rule2_T;
 /* Signals whether last matching position is the last one of the current edge */
 typedef enum LastPos_T {last_char_in_edge, other_char} LastPos_T;
 
-Node_T suffixless = NULL;
-
 struct SuffixTreePath
 {
    SuffixTreeIndex_T   begin;
@@ -85,38 +150,237 @@ struct SuffixTreePos
    SuffixTreeIndex_T   edge_pos;
 };
 
+/*
+ * The state of one run of Ukkonen's algorithm. Everything that changes while
+ * a tree is built lives here or in the tree itself, so different trees can be
+ * built at the same time.
+ */
+struct SuffixTreeBuild
+{
+   /* Where the last extension ended */
+   struct SuffixTreePos  pos;
+   /* The internal node created by the last extension, if it has no suffix
+      link yet. There is at most one. */
+   Node_T                suffixless;
+};
+
+
+/*
+ * Prepare an empty NodeArena for a tree that will have at most max_nodes
+ * nodes. No slabs are allocated until the first node is requested.
+ */
+void NodeArena_init(struct NodeArena* arena, SuffixTreeIndex_T max_nodes)
+{
+   arena->slabs               = NULL;
+   arena->num_slabs           = 0;
+   arena->num_allocated_slabs = 0;
+#ifdef SUFFIX_TREE_COMPACT
+   /* Compact nodes find each other relative to the start of the slab, so
+      they must all share one */
+   arena->slab_capacity       = max_nodes;
+#else
+   arena->slab_capacity       = MIN(max_nodes, NODE_SLAB_CAPACITY);
+#endif
+   if(arena->slab_capacity == 0)
+      arena->slab_capacity = 1;
+   /* Pretend the (nonexistent) last slab is full so the first request
+      allocates one */
+   arena->num_used_in_slab    = arena->slab_capacity;
+}
+
+/* Hand out an uninitialized node, allocating a new slab if needed. */
+Node_T NodeArena_alloc(struct NodeArena* arena)
+{
+   Node_T slab = NULL;
+
+   if(arena->num_used_in_slab == arena->slab_capacity)
+   {
+#ifdef SUFFIX_TREE_COMPACT
+      check(arena->num_slabs == 0, "A compact tree ran out of nodes.");
+#endif
+      if(arena->num_slabs == arena->num_allocated_slabs)
+      {
+         size_t new_num_allocated = arena->num_allocated_slabs ?
+                                    2 * arena->num_allocated_slabs : 4;
+         Node_T* tmp_slabs = realloc(arena->slabs, new_num_allocated * sizeof(Node_T));
+         check_mem(tmp_slabs);
+         arena->slabs = tmp_slabs;
+         arena->num_allocated_slabs = new_num_allocated;
+      }
+      slab = malloc(arena->slab_capacity * sizeof(struct Node_T));
+      check_mem(slab);
+      arena->slabs[arena->num_slabs] = slab;
+      arena->num_slabs++;
+      arena->num_used_in_slab = 0;
+   }
+
+   Node_T node = arena->slabs[arena->num_slabs - 1] + arena->num_used_in_slab;
+   arena->num_used_in_slab++;
+   return node;
+
+error:
+   return NULL;
+}
+
+/* Free every node handed out by the arena. */
+void NodeArena_free(struct NodeArena* arena)
+{
+   size_t i = 0;
+   for(i = 0; i < arena->num_slabs; i++)
+      free(arena->slabs[i]);
+   if(arena->slabs) free(arena->slabs);
+   arena->slabs = NULL;
+   arena->num_slabs = 0;
+   arena->num_allocated_slabs = 0;
+}
+
+/*
+ * Prepare the child table of a tree for an alphabet, giving each character a
+ * rank. The terminator '$' is always added to the alphabet. With a NULL
+ * alphabet the table is left empty and sons are found through the sibling
+ * lists.
+ *
+ * Returns:
+ *  0 on success, 1 if the alphabet has too many characters.
+ */
+int ChildTable_init(struct ChildTable* table, const char* alphabet)
+{
+   memset(table->ranks, NOT_IN_ALPHABET, sizeof(table->ranks));
+   table->alphabet_size      = 0;
+   table->sons               = NULL;
+   table->num_rows           = 0;
+   table->num_allocated_rows = 0;
+   if(alphabet == NULL) return 0;
+
+   size_t alphabet_length = strlen(alphabet);
+   size_t i = 0;
+   for(i = 0; i <= alphabet_length; i++)
+   {
+      unsigned char c = i < alphabet_length ? alphabet[i] : '$';
+      if(table->ranks[c] != NOT_IN_ALPHABET) continue;
+      check(table->alphabet_size < NOT_IN_ALPHABET,
+            "Alphabet has more than %d characters.", NOT_IN_ALPHABET);
+      table->ranks[c] = table->alphabet_size;
+      table->alphabet_size++;
+   }
+   return 0;
 
-Node_T create_node(Node_T father, SuffixTreeIndex_T start, SuffixTreeIndex_T end,
-                   SuffixTreeIndex_T position)
+error:
+   return 1;
+}
+
+/* Hand out a row of the table with no sons in it. */
+int ChildTable_add_row(struct ChildTable* table, SuffixTreeIndex_T* row)
+{
+   if(table->num_rows == table->num_allocated_rows)
+   {
+      size_t new_num_allocated = table->num_allocated_rows ?
+                                 2 * table->num_allocated_rows : 64;
+      NodeRef_T* tmp_sons = realloc(table->sons, new_num_allocated *
+                                    table->alphabet_size * sizeof(NodeRef_T));
+      check_mem(tmp_sons);
+      table->sons = tmp_sons;
+      table->num_allocated_rows = new_num_allocated;
+   }
+
+   NodeRef_T* sons = table->sons + table->num_rows * table->alphabet_size;
+   size_t i = 0;
+   for(i = 0; i < table->alphabet_size; i++)
+      sons[i] = NO_NODE;
+
+   *row = table->num_rows;
+   table->num_rows++;
+   return 0;
+
+error:
+   return 1;
+}
+
+void ChildTable_free(struct ChildTable* table)
+{
+   if(table->sons) free(table->sons);
+   table->sons = NULL;
+   table->num_rows = 0;
+   table->num_allocated_rows = 0;
+}
+
+Node_T create_node(SuffixTree_T tree, Node_T father, SuffixTreeIndex_T start,
+                   SuffixTreeIndex_T end, SuffixTreeIndex_T position)
 {
    /*Allocate a node.*/
-   Node_T node   = malloc(sizeof(struct Node_T));
+   Node_T node   = NodeArena_alloc(&tree->node_arena);
    check_mem(node);
 
-   node->left_son             = NULL;
-   node->right_sibling        = NULL;
+#ifdef SUFFIX_TREE_COMPACT
+   /* The node's position in the arena's only slab */
+   node->index                = tree->node_arena.num_used_in_slab - 1;
+#else
    node->left_sibling         = NULL;
-   node->suffix_link          = NULL;
-   node->father               = father;
+#endif
+   SET_SON(node, NULL);
+   SET_SIBLING(node, NULL);
+   SET_SUFFIX_LINK(node, NULL);
+   SET_FATHER(node, father);
    node->path_position        = position;
    node->edge_label_start     = start;
    node->edge_label_end       = end;
+   node->children             = NO_ROW;
    return node;
 
 error:
-   if(node) free(node);
    return NULL;
 }
 
+/*
+ * Give node a row in the child table, so it can have sons. Does nothing if
+ * the tree has no alphabet.
+ */
+int add_child_row(SuffixTree_T tree, Node_T node)
+{
+   if(tree->child_table.alphabet_size == 0) return 0;
+
+   SuffixTreeIndex_T row = 0;
+   int rc = ChildTable_add_row(&tree->child_table, &row);
+   check(rc == 0, "Could not add a row to the child table.");
+   node->children = row;
+   return 0;
+
+error:
+   return 1;
+}
+
+/*
+ * Record son in node's row of the child table, replacing any son whose edge
+ * starts with the same character. Does nothing if the tree has no alphabet.
+ */
+void set_child(SuffixTree_T tree, Node_T node, Node_T son)
+{
+   struct ChildTable* table = &tree->child_table;
+   if(table->alphabet_size == 0) return;
+
+   unsigned char rank = table->ranks[(unsigned char)tree->tree_string[son->edge_label_start]];
+   table->sons[node->children * table->alphabet_size + rank] = NODE_TO_REF(son);
+}
+
 Node_T find_son(const SuffixTree_T tree, const Node_T node, char character)
 {
+   /* With an alphabet, look the son up directly */
+   const struct ChildTable* table = &tree->child_table;
+   if(table->alphabet_size > 0)
+   {
+      unsigned char rank = table->ranks[(unsigned char)character];
+      if(rank == NOT_IN_ALPHABET || node->children == NO_ROW)
+         return NULL;
+      return REF_TO_NODE(node, table->sons[node->children * table->alphabet_size + rank]);
+   }
+
    /* Point to the first son. */
-   Node_T next_node = node->left_son;
+   Node_T next_node = SON(node);
    /* scan all sons (all right siblings of the first son) for their first
    character (it has to match the character given as input to this function. */
    while(next_node != NULL && tree->tree_string[next_node->edge_label_start] != character)
    {
-      next_node = next_node->right_sibling;
+      next_node = SIBLING(next_node);
    }
    return next_node;
 }
@@ -124,7 +388,7 @@ Node_T find_son(const SuffixTree_T tree, const Node_T node, char character)
 SuffixTreeIndex_T get_node_label_end(const SuffixTree_T tree, const Node_T node)
 {
    /* If it's a leaf - return e */
-   if(node->left_son == NULL)
+   if(SON(node) == NULL)
       return tree->e;
    /* If it's not a leaf - return its real end */
    return node->edge_label_end;
@@ -148,13 +412,32 @@ void connect_siblings(Node_T left_sib, Node_T right_sib)
 {
    /* Connect the right node as the right sibling of the left node */
    if(left_sib != NULL)
-      left_sib->right_sibling = right_sib;
+      SET_SIBLING(left_sib, right_sib);
+#ifndef SUFFIX_TREE_COMPACT
    /* Connect the left node as the left sibling of the right node */
    if(right_sib != NULL)
       right_sib->left_sibling = left_sib;
+#endif
 }
 
-Node_T apply_extension_rule_2(Node_T node, SuffixTreeIndex_T edge_label_begin,
+Node_T get_left_sibling(Node_T node)
+{
+#ifdef SUFFIX_TREE_COMPACT
+   /* Compact nodes don't know their left sibling, so look for the son of
+      their father that points to them */
+   Node_T sib = SON(FATHER(node));
+   if(sib == node)
+      return NULL;
+   while(SIBLING(sib) != node)
+      sib = SIBLING(sib);
+   return sib;
+#else
+   return node->left_sibling;
+#endif
+}
+
+Node_T apply_extension_rule_2(SuffixTree_T tree, Node_T node,
+                              SuffixTreeIndex_T edge_label_begin,
                               SuffixTreeIndex_T edge_label_end,
                               SuffixTreeIndex_T path_pos, SuffixTreeIndex_T edge_pos,
                               Rule2_T type)
@@ -164,20 +447,22 @@ Node_T apply_extension_rule_2(Node_T node, SuffixTreeIndex_T edge_label_begin,
    if(type == new_son)                                       
    {
       /* Create a new leaf (4) with the characters of the extension */
-      new_leaf = create_node(node, edge_label_begin, edge_label_end, path_pos);
+      new_leaf = create_node(tree, node, edge_label_begin, edge_label_end, path_pos);
       check(new_leaf, "Could not create node.");
       /* Connect new_leaf (4) as the new son of node (1) */
-      son = node->left_son;
-      while(son->right_sibling != NULL)
-         son = son->right_sibling;
+      son = SON(node);
+      while(SIBLING(son) != NULL)
+         son = SIBLING(son);
       connect_siblings(son, new_leaf);
+      set_child(tree, node, new_leaf);
       /* return (4) */
       return new_leaf;
    }
    /*-------split-------*/
    /* Create a new internal node (3) at the split point */
    new_internal = create_node(
-                      node->father,
+                      tree,
+                      FATHER(node),
                       node->edge_label_start,
                       node->edge_label_start+edge_pos,
                       node->path_position);
@@ -188,6 +473,7 @@ Node_T apply_extension_rule_2(Node_T node, SuffixTreeIndex_T edge_label_begin,
 
    /* Create a new leaf (2) with the characters of the extension */
    new_leaf = create_node(
+                      tree,
                       new_internal,
                       edge_label_begin,
                       edge_label_end,
@@ -196,25 +482,33 @@ Node_T apply_extension_rule_2(Node_T node, SuffixTreeIndex_T edge_label_begin,
    
    /* Connect new_internal (3) where node (1) was */
    /* Connect (3) with (1)'s left sibling */
-   connect_siblings(node->left_sibling, new_internal);   
+   connect_siblings(get_left_sibling(node), new_internal);
    /* connect (3) with (1)'s right sibling */
-   connect_siblings(new_internal, node->right_sibling);
+   connect_siblings(new_internal, SIBLING(node));
+#ifndef SUFFIX_TREE_COMPACT
    node->left_sibling = NULL;
+#endif
 
    /* Connect (3) with (1)'s father */
-   if(new_internal->father->left_son == node)
-      new_internal->father->left_son = new_internal;
+   if(SON(FATHER(new_internal)) == node)
+      SET_SON(FATHER(new_internal), new_internal);
    
    /* Connect new_leaf (2) and node (1) as sons of new_internal (3) */
-   new_internal->left_son = node;
-   node->father = new_internal;
+   SET_SON(new_internal, node);
+   SET_FATHER(node, new_internal);
    connect_siblings(node, new_leaf);
+
+   /* Make the same connections in the child table */
+   set_child(tree, FATHER(new_internal), new_internal);
+   check(add_child_row(tree, new_internal) == 0, "Could not add sons to node.");
+   set_child(tree, new_internal, node);
+   set_child(tree, new_internal, new_leaf);
    /* return (3) */
    return new_internal;
 
 error:
-   if(new_leaf) free(new_leaf);
-   if(new_internal) free(new_internal);
+   /* Nodes that were created belong to the tree's arena and are freed with
+      it */
    return NULL;
 }
 
@@ -380,13 +674,13 @@ void follow_suffix_link(SuffixTree_T tree, struct SuffixTreePos* pos)
       link (it must have one by Ukkonen's lemma). After following, trace down 
       gama - it must exist in the tree (and thus can use the skip trick - see 
       trace_string function description) */
-   if(pos->node->suffix_link == NULL || is_last_char_in_edge(tree,pos->node,pos->edge_pos) == 0)
+   if(SUFFIX_LINK(pos->node) == NULL || is_last_char_in_edge(tree,pos->node,pos->edge_pos) == 0)
    {
       /* If the node's father is the root, than no use following it's link (it 
          is linked to itself). Tracing from the root (like in the naive 
          algorithm) is required and is done by the calling function SEA uppon 
          recieving a return value of tree->root from this function */
-      if(pos->node->father == tree->root)
+      if(FATHER(pos->node) == tree->root)
       {
          pos->node = tree->root;
          return;
@@ -396,66 +690,73 @@ void follow_suffix_link(SuffixTree_T tree, struct SuffixTreePos* pos)
       gama.begin      = pos->node->edge_label_start;
       gama.end      = pos->node->edge_label_start + pos->edge_pos;
       /* Follow father's suffix link */
-      pos->node      = pos->node->father->suffix_link;
+      pos->node      = SUFFIX_LINK(FATHER(pos->node));
       /* Down-walk gama back to suffix_link's son */
       pos->node      = trace_string(tree, pos->node, gama, &(pos->edge_pos), &chars_found, skip);
    }
    else
    {
       /* If a suffix link exists - just follow it */
-      pos->node      = pos->node->suffix_link;
+      pos->node      = SUFFIX_LINK(pos->node);
       pos->edge_pos   = get_node_label_length(tree,pos->node)-1;
    }
 }
 
 void create_suffix_link(Node_T node, Node_T link)
 {
-   node->suffix_link = link;
+   SET_SUFFIX_LINK(node, link);
 }
 
-int SEA(SuffixTree_T tree, struct SuffixTreePos* pos,
+int SEA(SuffixTree_T tree, struct SuffixTreeBuild* build,
          struct SuffixTreePath str, SuffixTreeIndex_T* rule_applied,
          char after_rule_3)
 {
    SuffixTreeIndex_T   chars_found = 0 , path_pos = str.begin;
    Node_T tmp = NULL;
+   struct SuffixTreePos* pos = &build->pos;
  
    /* Follow suffix link only if it's not the first extension after rule 3 was applied */
    if(after_rule_3 == 0)
       follow_suffix_link(tree, pos);
 
-   /* If node is root - trace whole string starting from the root, else - trace last character only */
-   if(pos->node == tree->root)
+   /* If node is root - walk down to the end of all but the last character of
+      str. Those characters are already in the tree, so the skip trick applies,
+      and tracing them one at a time would make runs like AAAA...A quadratic.
+      Then trace the last character only. */
+   if(pos->node == tree->root && str.begin < str.end)
    {
-      pos->node = trace_string(tree, tree->root, str, &(pos->edge_pos), &chars_found, no_skip);
+      struct SuffixTreePath prefix = {str.begin, str.end - 1};
+      pos->node = trace_string(tree, tree->root, prefix, &(pos->edge_pos), &chars_found, skip);
    }
-   else
+   else if(pos->node == tree->root)
    {
-      str.begin = str.end;
-      chars_found = 0;
+      pos->edge_pos = 0;
+   }
+
+   str.begin = str.end;
+   chars_found = 0;
 
-      /* Consider 2 cases:
-         1. last character matched is the last of its edge */
-      if(is_last_char_in_edge(tree,pos->node,pos->edge_pos))
+   /* Consider 2 cases:
+      1. last character matched is the last of its edge */
+   if(is_last_char_in_edge(tree,pos->node,pos->edge_pos))
+   {
+      /* Trace only last symbol of str, search in the  NEXT edge (node) */
+      tmp = find_son(tree, pos->node, tree->tree_string[str.end]);
+      if(tmp != NULL)
       {
-         /* Trace only last symbol of str, search in the  NEXT edge (node) */
-         tmp = find_son(tree, pos->node, tree->tree_string[str.end]);
-         if(tmp != NULL)
-         {
-            pos->node      = tmp;
-            pos->edge_pos   = 0;
-            chars_found      = 1;
-         }
+         pos->node      = tmp;
+         pos->edge_pos   = 0;
+         chars_found      = 1;
       }
-      /* 2. last character matched is NOT the last of its edge */
-      else
+   }
+   /* 2. last character matched is NOT the last of its edge */
+   else
+   {
+      /* Trace only last symbol of str, search in the CURRENT edge (node) */
+      if(tree->tree_string[pos->node->edge_label_start+pos->edge_pos+1] == tree->tree_string[str.end])
       {
-         /* Trace only last symbol of str, search in the CURRENT edge (node) */
-         if(tree->tree_string[pos->node->edge_label_start+pos->edge_pos+1] == tree->tree_string[str.end])
-         {
-            pos->edge_pos++;
-            chars_found   = 1;
-         }
+         pos->edge_pos++;
+         chars_found   = 1;
       }
    }
 
@@ -466,11 +767,11 @@ int SEA(SuffixTree_T tree, struct SuffixTreePos* pos,
       /* If there is an internal node that has no suffix link yet (only one may 
          exist) - create a suffix link from it to the father-node of the 
          current position in the tree (pos) */
-      if(suffixless != NULL)
+      if(build->suffixless != NULL)
       {
-         create_suffix_link(suffixless, pos->node->father);
+         create_suffix_link(build->suffixless, FATHER(pos->node));
          /* Marks that no internal node with no suffix link exists */
-         suffixless = NULL;
+         build->suffixless = NULL;
       }
 
       #ifdef DEBUG   
@@ -484,21 +785,21 @@ int SEA(SuffixTree_T tree, struct SuffixTreePos* pos,
    if(is_last_char_in_edge(tree,pos->node,pos->edge_pos) || pos->node == tree->root)
    {
       /* Decide whether to apply rule 2 (new_son) or rule 1 */
-      if(pos->node->left_son != NULL)
+      if(SON(pos->node) != NULL)
       {
          /* Apply extension rule 2 new son - a new leaf is created and returned 
             by apply_extension_rule_2 */
-         tmp = apply_extension_rule_2(pos->node, str.begin+chars_found, str.end, path_pos, 0, new_son);
+         tmp = apply_extension_rule_2(tree, pos->node, str.begin+chars_found, str.end, path_pos, 0, new_son);
          check(tmp, "Could not apply extension rule 2.");
          *rule_applied = 2;
          /* If there is an internal node that has no suffix link yet (only one 
             may exist) - create a suffix link from it to the father-node of the 
             current position in the tree (pos) */
-         if(suffixless != NULL)
+         if(build->suffixless != NULL)
          {
-            create_suffix_link(suffixless, pos->node);
+            create_suffix_link(build->suffixless, pos->node);
             /* Marks that no internal node with no suffix link exists */
-            suffixless = NULL;
+            build->suffixless = NULL;
          }
       }
    }
@@ -506,20 +807,20 @@ int SEA(SuffixTree_T tree, struct SuffixTreePos* pos,
    {
       /* Apply extension rule 2 split - a new node is created and returned by 
          apply_extension_rule_2 */
-      tmp = apply_extension_rule_2(pos->node, str.begin+chars_found, str.end, path_pos, pos->edge_pos, split);
+      tmp = apply_extension_rule_2(tree, pos->node, str.begin+chars_found, str.end, path_pos, pos->edge_pos, split);
       check(tmp, "Could not apply extension rule 2.");
-      if(suffixless != NULL)
-         create_suffix_link(suffixless, tmp);
+      if(build->suffixless != NULL)
+         create_suffix_link(build->suffixless, tmp);
       /* Link root's sons with a single character to the root */
-      if(get_node_label_length(tree,tmp) == 1 && tmp->father == tree->root)
+      if(get_node_label_length(tree,tmp) == 1 && FATHER(tmp) == tree->root)
       {
-         tmp->suffix_link = tree->root;
+         SET_SUFFIX_LINK(tmp, tree->root);
          /* Marks that no internal node with no suffix link exists */
-         suffixless = NULL;
+         build->suffixless = NULL;
       }
       else
          /* Mark tmp as waiting for a link */
-         suffixless = tmp;
+         build->suffixless = tmp;
       
       /* Prepare pos for the next extension */
       pos->node = tmp;
@@ -531,7 +832,7 @@ error:
    return 1;
 }
 
-int SPA(SuffixTree_T tree, struct SuffixTreePos* pos,
+int SPA(SuffixTree_T tree, struct SuffixTreeBuild* build,
          SuffixTreeIndex_T phase, SuffixTreeIndex_T* extension,
          char* repeated_extension)
 {
@@ -550,7 +851,7 @@ int SPA(SuffixTree_T tree, struct SuffixTreePos* pos,
       str.end         = phase+1;
       
       /* Call Single-Extension-Algorithm */
-      int ret_val = SEA(tree, pos, str, &rule_applied, *repeated_extension);
+      int ret_val = SEA(tree, build, str, &rule_applied, *repeated_extension);
       check(ret_val == 0, "Single Extension Algorithm failed.");
       /* Check if rule 3 was applied for the current extension */
       if(rule_applied == 3)
@@ -569,82 +870,248 @@ error:
    return 1;
 }
 
-void label_nodes(Node_T node, SuffixTree_T tree,
-                 SuffixTreeIndex_T* label,
-                 SuffixTreeIndex_T edge_depth)
+#ifndef SUFFIX_TREE_COMPACT
+/*
+ * Give the nodes their preorder indices and edge depths. Fathers are labeled
+ * before their sons, so a node's depth comes from its father's.
+ */
+void label_nodes(SuffixTree_T tree, SuffixTreeIndex_T* label)
 {
-  size_t edge_length = 0;
-  if(SuffixTree_get_root(tree) != node) {
-    edge_length = Node_get_incoming_edge_length(node, tree);
-  }
-  node->edge_depth = edge_depth + edge_length;
-
-  node->index = *label;
-  (*label)++;
-  Node_T next_node = node->left_son;
-  while(next_node != NULL) {
-    label_nodes(next_node, tree, label, edge_depth + edge_length);
-    next_node = next_node->right_sibling;
+  Node_T node = tree->root;
+  while(node != NULL) {
+    node->edge_depth = 0;
+    if(node != tree->root) {
+      node->edge_depth = FATHER(node)->edge_depth +
+                         Node_get_incoming_edge_length(node, tree);
+    }
+    node->index = *label;
+    (*label)++;
+
+    if(SON(node) != NULL) {
+      node = SON(node);
+      continue;
+    }
+    while(node != NULL && SIBLING(node) == NULL)
+      node = FATHER(node);
+    if(node != NULL)
+      node = SIBLING(node);
   }
 }
+#endif
+
+#ifdef SUFFIX_TREE_COMPACT
+/*
+ * Reorder the nodes of a compact tree so that each node's position in the
+ * node array is its preorder label, then give the array back any nodes it
+ * didn't use. The labels are kept in edge_depth while the nodes are moved,
+ * and edge_depth is filled in properly afterwards.
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+int compact_nodes(SuffixTree_T tree)
+{
+   struct NodeArena* arena = &tree->node_arena;
+   Node_T base = tree->root - tree->root->index;
+   size_t num_nodes = arena->num_used_in_slab;
+   SuffixTreeIndex_T label = 0;
+   size_t i = 0;
+
+   /* Label the nodes in preorder, walking with father links rather than a
+      stack */
+   Node_T node = tree->root;
+   while(node != NULL) {
+      node->edge_depth = label++;
+      if(SON(node) != NULL) {
+         node = SON(node);
+         continue;
+      }
+      while(node != NULL && SIBLING(node) == NULL)
+         node = FATHER(node);
+      if(node != NULL)
+         node = SIBLING(node);
+   }
+   check(label == num_nodes, "Labeled %zu of %zu nodes.", label, num_nodes);
+
+   /* Point every link at the label of the node it refers to */
+   for(i = 0; i < num_nodes; i++) {
+      node = base + i;
+      if(node->left_son != NO_NODE)
+         node->left_son = base[node->left_son].edge_depth;
+      if(node->right_sibling != NO_NODE)
+         node->right_sibling = base[node->right_sibling].edge_depth;
+      if(node->father != NO_NODE)
+         node->father = base[node->father].edge_depth;
+      if(node->suffix_link != NO_NODE)
+         node->suffix_link = base[node->suffix_link].edge_depth;
+   }
+   struct ChildTable* table = &tree->child_table;
+   for(i = 0; i < table->num_rows * table->alphabet_size; i++) {
+      if(table->sons[i] != NO_NODE)
+         table->sons[i] = base[table->sons[i]].edge_depth;
+   }
+
+   /* Move each node to the position given by its label, one cycle of the
+      permutation at a time */
+   for(i = 0; i < num_nodes; i++) {
+      while(base[i].edge_depth != i) {
+         struct Node_T tmp = base[base[i].edge_depth];
+         base[base[i].edge_depth] = base[i];
+         base[i] = tmp;
+      }
+      base[i].index = i;
+   }
+
+   /* Fathers now precede their sons, so depths can be filled in order */
+   base[0].edge_depth = 0;
+   for(i = 1; i < num_nodes; i++) {
+      node = base + i;
+      node->edge_depth = FATHER(node)->edge_depth +
+                         Node_get_incoming_edge_length(node, tree);
+   }
+
+   /* Shrinking is only an optimization, so keep the old block if it fails */
+   Node_T tmp_base = realloc(base, num_nodes * sizeof(struct Node_T));
+   if(tmp_base != NULL) {
+      base = tmp_base;
+      arena->slabs[0] = base;
+      arena->slab_capacity = num_nodes;
+   }
+   tree->root = base;
+   tree->num_nodes = num_nodes;
+   return 0;
+
+error:
+   return 1;
+}
+#endif
+
+static SuffixTree_T create_tree(char* buffer, size_t length, const char* alphabet,
+                                int owns_string);
 
 SuffixTree_T SuffixTree_create(char* str, size_t length)
 {
-   SuffixTree_T tree;
+   return SuffixTree_create_with_alphabet(str, length, NULL);
+}
+
+SuffixTree_T SuffixTree_create_with_alphabet(char* str, size_t length,
+                                             const char* alphabet)
+{
+   if(str == NULL) return NULL;
+
+   /* Allocating the only real string of the tree */
+   char* buffer = malloc(SUFFIX_TREE_BUFFER_LENGTH(length)*sizeof(char));
+   check_mem(buffer);
+   memcpy(buffer+sizeof(char),str,length*sizeof(char));
+
+   return create_tree(buffer, length, alphabet, 1);
+
+error:
+   return NULL;
+}
+
+SuffixTree_T SuffixTree_create_from_buffer(char* buffer, size_t length)
+{
+   if(buffer == NULL) return NULL;
+   return create_tree(buffer, length, NULL, 1);
+}
+
+SuffixTree_T SuffixTree_create_borrowed(char* buffer, size_t length)
+{
+   if(buffer == NULL) return NULL;
+   return create_tree(buffer, length, NULL, 0);
+}
+
+/*
+ * Build the tree of the string in buffer[1:length+1]. If owns_string, the tree
+ * takes ownership of the buffer, even if it fails.
+ */
+static SuffixTree_T create_tree(char* buffer, size_t length, const char* alphabet,
+                                int owns_string)
+{
+   SuffixTree_T tree = NULL;
    SuffixTreeIndex_T phase , extension;
    char repeated_extension = 0;
-   struct SuffixTreePos pos;
+   struct SuffixTreeBuild build;
+   size_t i = 0;
 
-   if(str == NULL) return NULL;
+#ifdef SUFFIX_TREE_COMPACT
+   if(length >= MAX_COMPACT_LENGTH && owns_string) free(buffer);
+   check(length < MAX_COMPACT_LENGTH,
+         "String of length %zu is too long for a compact suffix tree.", length);
+#endif
 
    /* Allocating the tree */
-   tree = malloc(sizeof(struct SuffixTree_T));
+   tree = calloc(1, sizeof(struct SuffixTree_T));
+   if(!tree && owns_string) free(buffer);
    check_mem(tree);
 
    tree->root = NULL;
+   tree->tree_string = buffer;
+   tree->owns_string = owns_string;
 
    /* Calculating string length (with an ending terminator) */
    tree->length = length+1;
-   
-   /* Allocating the only real string of the tree */
-   tree->tree_string = malloc((tree->length+1)*sizeof(char));
-   check_mem(tree->tree_string);
 
-   memcpy(tree->tree_string+sizeof(char),str,length*sizeof(char));
+   /* A tree has at most one leaf per suffix and fewer internal nodes than
+      leaves */
+   NodeArena_init(&tree->node_arena, 2*tree->length);
+
+   check(ChildTable_init(&tree->child_table, alphabet) == 0,
+         "Could not use alphabet %s.", alphabet);
+   if(tree->child_table.alphabet_size > 0)
+   {
+      for(i = 0; i < length; i++)
+      {
+         check(tree->child_table.ranks[(unsigned char)buffer[i + 1]] != NOT_IN_ALPHABET,
+               "Character %d at position %zu is not in the alphabet.", buffer[i + 1], i);
+      }
+   }
 
    tree->tree_string[tree->length] = '$';
    
    /* Allocating the tree root node */
-   tree->root = create_node(0, 0, 0, 0);
+   tree->root = create_node(tree, 0, 0, 0, 0);
    check(tree->root, "Creation of tree root failed.");
 
-   tree->root->suffix_link = NULL;
+   SET_SUFFIX_LINK(tree->root, NULL);
+   check(add_child_row(tree, tree->root) == 0, "Could not add sons to root.");
    tree->e = 0;
 
-   /* Initializing algorithm parameters */
+   /* Initializing algorithm parameters. Phase 1 adds the second character,
+      so that at the start of every phase all suffixes of the characters
+      before it are in the tree. SEA relies on that when it skips down from
+      the root. */
    extension = 2;
-   phase = 2;
+   phase = 1;
    
    /* Allocating first node, son of the root (phase 0), the longest path node */
-   tree->root->left_son = create_node(tree->root, 1, tree->length, 1);
-   check(tree->root->left_son, "Node creation failed.");
+   Node_T first_son = create_node(tree, tree->root, 1, tree->length, 1);
+   check(first_son, "Node creation failed.");
+   SET_SON(tree->root, first_son);
+   set_child(tree, tree->root, first_son);
 
-   suffixless       = NULL;
-   pos.node         = tree->root;
-   pos.edge_pos     = 0;
+   build.suffixless    = NULL;
+   build.pos.node      = tree->root;
+   build.pos.edge_pos  = 0;
 
    /* Ukkonen's algorithm begins here */
    int success = 0;
    for(; phase < tree->length; phase++)
    {
       /* Perform Single Phase Algorithm */
-      success = SPA(tree, &pos, phase, &extension, &repeated_extension);
+      success = SPA(tree, &build, phase, &extension, &repeated_extension);
+      if(success != 0) break;
    }
    check(success == 0, "Ukkonen's suffix tree construction algorithm failed.");
 
+#ifdef SUFFIX_TREE_COMPACT
+   check(compact_nodes(tree) == 0, "Compacting the suffix tree failed.");
+#else
    SuffixTreeIndex_T counter = 0;
-   label_nodes(tree->root, tree, &counter, 0);
+   label_nodes(tree, &counter);
    tree->num_nodes = counter;
+#endif
    return tree;
 
 error:
@@ -652,63 +1119,65 @@ error:
    return NULL;
 }
 
-void SuffixTree_delete_subtree(Node_T node)
-{
-   /* Recoursion stoping condition */
-   if(node == NULL)
-      return;
-   /* Recoursive call for right sibling */
-   if(node->right_sibling!=0)
-      SuffixTree_delete_subtree(node->right_sibling);
-   /* Recoursive call for first son */
-   if(node->left_son!=0)
-      SuffixTree_delete_subtree(node->left_son);
-   /* Delete node itself, after its whole tree was deleted as well */
-   free(node);
-}
-
 void SuffixTree_delete(SuffixTree_T* tree)
 {
    if(!tree) return;
    if(*tree == NULL)
       return;
-   SuffixTree_delete_subtree((*tree)->root);
-   free((*tree)->tree_string);
+   NodeArena_free(&(*tree)->node_arena);
+   ChildTable_free(&(*tree)->child_table);
+   if((*tree)->owns_string) free((*tree)->tree_string);
    free(*tree);
 }
 
-void SuffixTree_print_node(SuffixTree_T tree, Node_T node1, long depth)
+void print_node_line(SuffixTree_T tree, Node_T node1, long depth)
 {
-   Node_T node2 = node1->left_son;
    long  d = depth , start = node1->edge_label_start , end;
    end     = get_node_label_end(tree, node1);
    long orig_start = start;
 
-   if(depth>0)
+   /* Print the branches coming from higher nodes */
+   while(d>1)
    {
-      /* Print the branches coming from higher nodes */
-      while(d>1)
+      printf("|");
+      d--;
+   }
+   printf("+");
+   /* Print the node itself */
+   while(start<=end)
+   {
+      printf("%c",tree->tree_string[start]);
+      start++;
+   }
+
+   printf("\t%zu\t%ld\t%ld\t%ld\t%ld", (size_t)node1->index, orig_start,
+          end, (long)node1->path_position, (long)node1->edge_depth);
+   printf("\n");
+}
+
+void SuffixTree_print_node(SuffixTree_T tree, Node_T node1, long depth)
+{
+   Node_T node2 = node1;
+
+   /* Print node1's subtree in preorder, keeping track of the depth on the
+      way down and back up */
+   while(1)
+   {
+      if(depth>0)
+         print_node_line(tree, node2, depth);
+      if(SON(node2) != NULL)
       {
-         printf("|");
-         d--;
+         node2 = SON(node2);
+         depth++;
+         continue;
       }
-      printf("+");
-      /* Print the node itself */
-      while(start<=end)
+      while(node2 != node1 && SIBLING(node2) == NULL)
       {
-         printf("%c",tree->tree_string[start]);
-         start++;
+         node2 = FATHER(node2);
+         depth--;
       }
-
-      printf("\t%zu\t%ld\t%ld\t%ld\t%ld", node1->index, orig_start,
-             end, node1->path_position, node1->edge_depth);
-      printf("\n");
-   }
-   /* Recoursive call for all node1's sons */
-   while(node2!=0)
-   {
-      SuffixTree_print_node(tree,node2, depth+1);
-      node2 = node2->right_sibling;
+      if(node2 == node1) break;
+      node2 = SIBLING(node2);
    }
 }
 
@@ -756,15 +1225,10 @@ int SuffixTree_verify(SuffixTree_T tree)
 SuffixTreeIndex_T node_array_node_func(SuffixTree_T tree, Node_T node, void* vnode_array,
                                        SuffixTreeIndex_T ct)
 {
+  (void)tree;
   Node_T* node_array = vnode_array;
   node_array[node->index] = node;
-  Node_T next_node = node->left_son;
-
-  while(next_node != NULL) {
-    node_array_node_func(tree, next_node, node_array, ct);
-    next_node = next_node->right_sibling;
-  }
-  return 0;
+  return ct;
 }
 
 Node_T* SuffixTree_create_node_array(SuffixTree_T tree)
@@ -772,8 +1236,9 @@ Node_T* SuffixTree_create_node_array(SuffixTree_T tree)
   Node_T* node_array = calloc(tree->num_nodes, sizeof(Node_T));
   check_mem(node_array);
 
-  SuffixTree_walk(tree, tree->root, node_array_node_func,
-                  node_array, 0);
+  int rc = SuffixTree_walk(tree, tree->root, node_array_node_func,
+                           node_array, 0);
+  check(rc == 0, "Failed to walk the tree.");
   return node_array;
 
 error:
@@ -806,12 +1271,14 @@ Node_T* SuffixTree_create_leaf_array(SuffixTree_T tree)
   Node_T* leaf_array = calloc(tree->length, sizeof(Node_T));
   check_mem(leaf_array);
 
-  SuffixTree_walk(tree, tree->root, leaf_array_node_func,
-                  leaf_array, 0);
+  int rc = SuffixTree_walk(tree, tree->root, leaf_array_node_func,
+                           leaf_array, 0);
+  check(rc == 0, "Failed to walk the tree.");
 
   return leaf_array;
 
 error:
+  if(leaf_array) free(leaf_array);
   return NULL;
 }
 
@@ -839,33 +1306,122 @@ int SuffixTree_verify_leaf_array(SuffixTree_T tree, const Node_T* leaf_array)
   }
   return 0;
 }
-void SuffixTree_walk(SuffixTree_T tree, Node_T node,
-                     NodeFunc_T node_func, void* data,
-                     SuffixTreeIndex_T counter)
+/*
+ * The walks visit nodes by following sons, siblings and fathers, so they need
+ * no recursion. The only thing they have to remember on the way down is what
+ * node_func returned for each ancestor, which they keep in a WalkStack on the
+ * heap. Its size is the depth of the tree, which can be the length of the
+ * string for inputs like long runs of one character.
+ */
+struct WalkFrame
 {
-  SuffixTreeIndex_T new_counter = node_func(tree, node, data, counter);
+  /* The counter given to node_func for the ancestor */
+  SuffixTreeIndex_T in;
+  /* The counter node_func returned for it */
+  SuffixTreeIndex_T out;
+};
 
-  Node_T next_node = node->left_son;
+struct WalkStack
+{
+  struct WalkFrame* frames;
+  size_t length;
+  size_t num_allocated;
+};
 
-  while(next_node != NULL) {
-    SuffixTree_walk(tree, next_node, node_func, data, new_counter);
-    next_node = next_node->right_sibling;
+int WalkStack_push(struct WalkStack* stack, SuffixTreeIndex_T in,
+                   SuffixTreeIndex_T out)
+{
+  if(stack->length == stack->num_allocated) {
+    size_t new_num_allocated = stack->num_allocated ? 2 * stack->num_allocated : 64;
+    struct WalkFrame* tmp_frames = realloc(stack->frames,
+                                           new_num_allocated * sizeof(struct WalkFrame));
+    check_mem(tmp_frames);
+    stack->frames = tmp_frames;
+    stack->num_allocated = new_num_allocated;
   }
+  stack->frames[stack->length].in = in;
+  stack->frames[stack->length].out = out;
+  stack->length++;
+  return 0;
+
+error:
+  return 1;
 }
 
-void SuffixTree_euler_walk(SuffixTree_T tree, Node_T node,
-                           NodeFunc_T node_func, void* data,
-                           SuffixTreeIndex_T counter)
+int SuffixTree_walk(SuffixTree_T tree, Node_T node,
+                    NodeFunc_T node_func, void* data,
+                    SuffixTreeIndex_T counter)
 {
-  SuffixTreeIndex_T new_counter = node_func(tree, node, data, counter);
+  struct WalkStack stack = {NULL, 0, 0};
+  Node_T start = node;
+  SuffixTreeIndex_T in = counter;
+
+  while(1) {
+    SuffixTreeIndex_T out = node_func(tree, node, data, in);
+
+    if(SON(node) != NULL) {
+      check(WalkStack_push(&stack, in, out) == 0, "Failed to descend in walk.");
+      node = SON(node);
+      in = out;
+      continue;
+    }
+
+    /* Climb until there's a sibling to visit, or the walk is over */
+    while(node != start && SIBLING(node) == NULL) {
+      node = FATHER(node);
+      stack.length--;
+    }
+    if(node == start) break;
+    node = SIBLING(node);
+    in = stack.frames[stack.length - 1].out;
+  }
 
-  Node_T next_node = node->left_son;
+  if(stack.frames) free(stack.frames);
+  return 0;
+
+error:
+  if(stack.frames) free(stack.frames);
+  return 1;
+}
+
+int SuffixTree_euler_walk(SuffixTree_T tree, Node_T node,
+                          NodeFunc_T node_func, void* data,
+                          SuffixTreeIndex_T counter)
+{
+  struct WalkStack stack = {NULL, 0, 0};
+  Node_T start = node;
+  SuffixTreeIndex_T in = counter;
+
+  while(1) {
+    SuffixTreeIndex_T out = node_func(tree, node, data, in);
+
+    if(SON(node) != NULL) {
+      check(WalkStack_push(&stack, in, out) == 0, "Failed to descend in walk.");
+      node = SON(node);
+      in = out;
+      continue;
+    }
 
-  while(next_node != NULL) {
-    SuffixTree_euler_walk(tree, next_node, node_func, data, new_counter);
-    node_func(tree, node, data, counter);
-    next_node = next_node->right_sibling;
+    /* Go back up, visiting each father again after each of its sons, until
+       there's a sibling to visit or the walk is over */
+    while(node != start) {
+      struct WalkFrame* father_frame = &stack.frames[stack.length - 1];
+      node_func(tree, FATHER(node), data, father_frame->in);
+      if(SIBLING(node) != NULL) break;
+      node = FATHER(node);
+      stack.length--;
+    }
+    if(node == start) break;
+    node = SIBLING(node);
+    in = stack.frames[stack.length - 1].out;
   }
+
+  if(stack.frames) free(stack.frames);
+  return 0;
+
+error:
+  if(stack.frames) free(stack.frames);
+  return 1;
 }
 
 Node_T SuffixTree_get_root(SuffixTree_T tree)
@@ -899,17 +1455,17 @@ SuffixTreeIndex_T Node_get_index(Node_T node)
 
 Node_T Node_get_child(Node_T node)
 {
-  return node->left_son;
+  return SON(node);
 }
 
 Node_T Node_get_sibling(Node_T node)
 {
-  return node->right_sibling;
+  return SIBLING(node);
 }
 
 Node_T Node_get_parent(Node_T node)
 {
-  return node->father;
+  return FATHER(node);
 }
 
 SuffixTreeIndex_T Node_get_edge_depth(Node_T node)
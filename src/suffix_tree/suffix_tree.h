@@ -30,6 +30,11 @@ under the same terms as Perl itself.
 /*
  * SuffixTree_T is the type of a suffix tree. It is opaque and is
  * manipulated by the SuffixTree functions defined below.
+ *
+ * Building a tree uses no state outside of the tree, so different threads can
+ * create, use and delete different trees at the same time. Once created, a
+ * tree is only read, so one tree can also be searched and walked by several
+ * threads at once.
  */
 typedef struct SuffixTree_T* SuffixTree_T;
 
@@ -58,6 +63,60 @@ typedef size_t SuffixTreeIndex_T;
  */
 SuffixTree_T SuffixTree_create(char* str, size_t length);
 
+/*
+ * Create a suffix tree for a string over a small, known alphabet. The sons
+ * of each internal node are kept in a table indexed by character, so
+ * construction and searching find a son in constant time rather than by
+ * scanning its siblings. This pays off for alphabets like DNA; the table
+ * costs one Node_T's worth of memory per character per internal node.
+ *
+ * Params:
+ *  char* str             :     The string for which the suffix tree will
+ *                              be created. This string cannot contain the
+ *                              character '$'.
+ *  size_t length         :     The length of str, not including its
+ *                              null-terminator.
+ *  const char* alphabet  :     A null-terminated string of the characters
+ *                              that can appear in str, e.g. "ACGTN". The
+ *                              terminator '$' is added automatically.
+ *
+ * Returns:
+ *  The suffix tree, or NULL if str contains a character that is not in
+ *  alphabet or the alphabet has more than 254 characters.
+ */
+SuffixTree_T SuffixTree_create_with_alphabet(char* str, size_t length,
+                                             const char* alphabet);
+
+/*
+ * The number of chars in a buffer for SuffixTree_create_from_buffer to build
+ * the tree of a string of length characters in.
+ */
+#define SUFFIX_TREE_BUFFER_LENGTH(length) ((length) + 2)
+
+/*
+ * Create a suffix tree in a buffer the caller has already filled, instead of
+ * copying the string. The string goes in buffer[1:length+1], using Python
+ * slice syntax, and the tree uses buffer[0] and buffer[length+1] itself, so
+ * the buffer must be malloced with at least SUFFIX_TREE_BUFFER_LENGTH(length)
+ * chars. The tree takes ownership of the buffer, and frees it when deleted or
+ * if creation fails.
+ *
+ * Returns:
+ *  The suffix tree, or NULL on failure.
+ */
+SuffixTree_T SuffixTree_create_from_buffer(char* buffer, size_t length);
+
+/*
+ * Like SuffixTree_create_from_buffer, but the tree borrows the buffer instead
+ * of taking it. The caller keeps ownership, frees it, and must keep it alive
+ * and leave buffer[1:length+1] unchanged for as long as the tree is used. The
+ * buffer need not be malloced.
+ *
+ * Returns:
+ *  The suffix tree, or NULL on failure.
+ */
+SuffixTree_T SuffixTree_create_borrowed(char* buffer, size_t length);
+
 /*
  * Print a text representation of the tree to stdout.
  */
@@ -114,12 +173,22 @@ typedef      SuffixTreeIndex_T (*NodeFunc_T)(SuffixTree_T tree,
  *                                  on the node's children. This is useful for
  *                                  doing things like keeping track of node
  *                                  depth.
+ *
+ * The walk does not recurse, so it handles trees of any depth.
+ *
+ * Returns:
+ *  0 on success, 1 if memory for the traversal could not be allocated.
  */
-void         SuffixTree_walk(SuffixTree_T tree, Node_T node,
+int          SuffixTree_walk(SuffixTree_T tree, Node_T node,
                              NodeFunc_T node_func, void* data,
                              SuffixTreeIndex_T counter);
 
-void         SuffixTree_euler_walk(SuffixTree_T tree, Node_T node,
+/*
+ * Like SuffixTree_walk, but also call node_func on a node again after
+ * returning from each of its children, with the counter the node was first
+ * visited with. This visits nodes in the order of an Euler tour.
+ */
+int          SuffixTree_euler_walk(SuffixTree_T tree, Node_T node,
                                    NodeFunc_T node_func, void* data,
                                    SuffixTreeIndex_T counter);
 /*
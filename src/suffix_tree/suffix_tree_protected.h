@@ -1,15 +1,87 @@
 #ifndef _suffix_tree_protected_H_
 #define _suffix_tree_protected_H_
 
+#include <limits.h>
+#include <stdint.h>
+
 #include "suffix_tree.h"
 
+/*
+ * A reference from one node to another. Nodes of a compact tree refer to
+ * each other by position in the tree's node array, and other nodes by
+ * pointer.
+ */
+#ifdef SUFFIX_TREE_COMPACT
+typedef uint32_t NodeRef_T;
+#define NO_NODE ((NodeRef_T)-1)
+#else
+typedef struct Node_T* NodeRef_T;
+#define NO_NODE NULL
+#endif
+
+/* The rank of a character that isn't in a tree's alphabet */
+#define NOT_IN_ALPHABET UCHAR_MAX
+
+/*
+ * A tree created with an alphabet keeps the sons of each internal node in a
+ * row of a table indexed by the rank of the first character of their edge,
+ * so finding a son doesn't mean walking the list of siblings. The sibling
+ * lists are maintained too, for traversals.
+ */
+struct ChildTable
+{
+   /* The rank of every character in the alphabet, else NOT_IN_ALPHABET */
+   unsigned char             ranks[UCHAR_MAX + 1];
+   /* The number of characters in the alphabet, or 0 if the tree has none */
+   size_t                    alphabet_size;
+   /* alphabet_size sons for each row, NO_NODE where there is no son */
+   NodeRef_T*                sons;
+   /* The number of rows in use and the number of rows allocated */
+   size_t                    num_rows;
+   size_t                    num_allocated_rows;
+};
+
+/*
+ * The nodes of a tree are carved out of large slabs rather than allocated one
+ * at a time, so building a tree costs a handful of mallocs and deleting it a
+ * handful of frees. Nodes created one after another also sit next to each
+ * other in memory.
+ */
+struct NodeArena
+{
+   /* The slabs allocated so far. Only the last one has free nodes. */
+   struct Node_T**           slabs;
+   /* The number of slabs in use and the number of slab pointers allocated. */
+   size_t                    num_slabs;
+   size_t                    num_allocated_slabs;
+   /* The number of nodes in each slab */
+   size_t                    slab_capacity;
+   /* The number of nodes handed out from the last slab */
+   size_t                    num_used_in_slab;
+};
+
 struct SuffixTree_T
 {
+   /* The virtual end of all leaves */
    SuffixTreeIndex_T         e;
+   /* The one and only real source string of the tree. All edge-labels
+      contain only indices to this string and do not contain the characters
+      themselves */
    char*                     tree_string;
+   /* Whether tree_string is freed with the tree, or borrowed from the
+      caller */
+   int                       owns_string;
+   /* The length of the source string */
    SuffixTreeIndex_T         length;
+   /* The number of nodes in the tree */
    SuffixTreeIndex_T         num_nodes;
+   /* The node that is the head of all others. It has no siblings nor a
+      father */
    Node_T                    root;
+   /* Where the nodes of the tree live */
+   struct NodeArena          node_arena;
+   /* The sons of internal nodes, by first character */
+   struct ChildTable         child_table;
 };
 
-#endif  
+#endif
@@ -0,0 +1,78 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+
+#include "utils/dbg.h"
+
+struct MappedFile_T {
+  char*  data;
+  size_t length;
+  /* The length of the mapping, which is 0 for an empty file, where nothing
+   * is mapped. */
+  size_t mapped_length;
+};
+
+MappedFile_T MappedFile_open(const char* path)
+{
+  MappedFile_T file = NULL;
+  int fd = -1;
+
+  check(path, "Cannot map a NULL path.");
+  file = calloc(1, sizeof(struct MappedFile_T));
+  check_mem(file);
+
+  fd = open(path, O_RDONLY);
+  check(fd >= 0, "Could not open %s.", path);
+
+  struct stat file_stat;
+  check(fstat(fd, &file_stat) == 0, "Could not stat %s.", path);
+  check(S_ISREG(file_stat.st_mode), "%s is not a regular file.", path);
+
+  file->mapped_length = file_stat.st_size;
+  if(file->mapped_length > 0) {
+    void* data = mmap(NULL, file->mapped_length, PROT_READ, MAP_PRIVATE, fd, 0);
+    check(data != MAP_FAILED, "Could not map %s.", path);
+    file->data = data;
+  } else {
+    file->data = "";
+  }
+  /* The mapping stays valid once the file is closed. */
+  close(fd);
+  fd = -1;
+
+  file->length = file->mapped_length;
+  if(file->length > 0 && file->data[file->length - 1] == '\n') file->length--;
+  if(file->length > 0 && file->data[file->length - 1] == '\r' &&
+     file->length + 1 == file->mapped_length) {
+    file->length--;
+  }
+
+  return file;
+
+error:
+  if(fd >= 0) close(fd);
+  if(file) free(file);
+  return NULL;
+}
+
+void MappedFile_close(MappedFile_T* file)
+{
+  if(!file || !*file) return;
+  if((*file)->mapped_length > 0) munmap((*file)->data, (*file)->mapped_length);
+  free(*file);
+  *file = NULL;
+}
+
+char* MappedFile_get_data(MappedFile_T file)
+{
+  return file->data;
+}
+
+size_t MappedFile_get_length(MappedFile_T file)
+{
+  return file->length;
+}
@@ -0,0 +1,40 @@
+#ifndef _mapped_file_H_
+#define _mapped_file_H_
+
+#include <stdlib.h>
+
+/* TYPES */
+
+/*
+ * A MappedFile_T is a file mapped read-only into memory, so that its contents
+ * can be searched without reading them into a buffer of their own. Pages are
+ * read in from the file as they're touched, and the kernel can drop them again
+ * under memory pressure, since they are never written.
+ */
+typedef struct MappedFile_T* MappedFile_T;
+
+/* FUNCTIONS */
+
+/*
+ * Map a file. Its contents are the whole file but for one trailing newline,
+ * "\n" or "\r\n", if it has one, so a sequence saved as a line of text is
+ * just the sequence.
+ *
+ * Returns:
+ *  MappedFile_T file, or NULL on failure.
+ */
+MappedFile_T MappedFile_open(const char* path);
+
+/* Unmap a file. */
+void         MappedFile_close(MappedFile_T* file);
+
+/*
+ * The contents of the file. They are read-only, and writing to them is an
+ * error even through a char*.
+ */
+char*        MappedFile_get_data(MappedFile_T file);
+
+/* The length of the contents of the file. */
+size_t       MappedFile_get_length(MappedFile_T file);
+
+#endif
@@ -0,0 +1,136 @@
+#include <stdlib.h>
+
+#include "relation.h"
+
+#include "utils/dbg.h"
+
+/* Characters that pair with nothing map to these on each side. */
+#define UNPAIRED_LEFT 1
+#define UNPAIRED_RIGHT 2
+
+/* A byte that doesn't occur in str, or -1 if every byte does. */
+static int unused_byte(const char* str, size_t length)
+{
+  unsigned char seen[256] = {0};
+  size_t i = 0;
+  int c = 0;
+
+  for(i = 0; i < length; i++) seen[(unsigned char)str[i]] = 1;
+  for(c = 0; c < 256; c++) {
+    if(!seen[c]) return c;
+  }
+  return -1;
+}
+
+/* Copy str through map into a new string. */
+static char* map_copy(const unsigned char* map, const char* str, size_t length)
+{
+  /* One more byte than needed, so an empty string still gets a buffer. */
+  char* mapped = malloc(length + 1);
+  check_mem(mapped);
+
+  size_t i = 0;
+  for(i = 0; i < length; i++) mapped[i] = map[(unsigned char)str[i]];
+  return mapped;
+
+error:
+  return NULL;
+}
+
+static void fill_maps(enum PalindromeRelation relation, unsigned char* left,
+                      unsigned char* right)
+{
+  static const char bases[] = "ACGTacgt";
+  static const char complements[] = "TGCAtgca";
+  int c = 0;
+  int i = 0;
+
+  switch(relation) {
+    case RELATION_CASE_INSENSITIVE:
+      for(c = 0; c < 256; c++) {
+        left[c] = right[c] = c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+      }
+      break;
+    case RELATION_REVERSE_COMPLEMENT:
+      for(c = 0; c < 256; c++) {
+        left[c] = UNPAIRED_LEFT;
+        right[c] = UNPAIRED_RIGHT;
+      }
+      for(i = 0; bases[i]; i++) {
+        left[(unsigned char)bases[i]] = complements[i];
+        right[(unsigned char)bases[i]] = bases[i];
+      }
+      break;
+    default:
+      for(c = 0; c < 256; c++) left[c] = right[c] = c;
+      break;
+  }
+}
+
+int Relation_map_string(enum PalindromeRelation relation, const char* str,
+                        size_t length, char** left_string, char** right_string)
+{
+  unsigned char left_map[256];
+  unsigned char right_map[256];
+
+  *left_string = NULL;
+  *right_string = NULL;
+  check(relation == RELATION_EXACT || relation == RELATION_CASE_INSENSITIVE ||
+        relation == RELATION_REVERSE_COMPLEMENT, "Unknown relation %d.", relation);
+
+  if(relation == RELATION_EXACT) {
+    *left_string = *right_string = (char*)str;
+    return 0;
+  }
+
+  fill_maps(relation, left_map, right_map);
+
+  /* Both arms are folded the same way, so they share one string. */
+  if(relation == RELATION_CASE_INSENSITIVE) {
+    *left_string = map_copy(left_map, str, length);
+    check(*left_string, "Could not map string.");
+    *right_string = *left_string;
+    return 0;
+  }
+
+  /* The right map of RELATION_REVERSE_COMPLEMENT only sets apart the
+   * characters that pair with nothing. If the left map sends those to a byte
+   * str doesn't have, they still pair with nothing, and the right arm can be
+   * str itself. */
+  int unused = unused_byte(str, length);
+  if(relation == RELATION_REVERSE_COMPLEMENT && unused >= 0) {
+    int c = 0;
+    for(c = 0; c < 256; c++) {
+      if(left_map[c] == UNPAIRED_LEFT) left_map[c] = unused;
+    }
+    *left_string = map_copy(left_map, str, length);
+    check(*left_string, "Could not map string.");
+    *right_string = (char*)str;
+    return 0;
+  }
+
+  *left_string = map_copy(left_map, str, length);
+  check(*left_string, "Could not map string.");
+  *right_string = map_copy(right_map, str, length);
+  check(*right_string, "Could not map string.");
+
+  return 0;
+error:
+  Relation_free_strings(str, left_string, right_string);
+  return 1;
+}
+
+void Relation_free_strings(const char* str, char** left_string, char** right_string)
+{
+  if(*right_string && *right_string != str && *right_string != *left_string) {
+    free(*right_string);
+  }
+  if(*left_string && *left_string != str) free(*left_string);
+  *left_string = NULL;
+  *right_string = NULL;
+}
+
+int Relation_is_reflexive(enum PalindromeRelation relation)
+{
+  return relation != RELATION_REVERSE_COMPLEMENT;
+}
@@ -0,0 +1,69 @@
+#ifndef _relation_H_
+#define _relation_H_
+
+#include <stdlib.h>
+
+/* TYPES */
+
+/*
+ * When the character on the left arm of a palindrome pairs with the one on
+ * the right arm.
+ *
+ * RELATION_EXACT                :   They are the same character.
+ * RELATION_CASE_INSENSITIVE     :   They are the same letter in any case.
+ * RELATION_REVERSE_COMPLEMENT   :   They are complementary bases, A with T and
+ *                                   C with G, in the same case. Nothing else
+ *                                   pairs, and no character pairs with itself.
+ *
+ * Each relation is a pair of maps over characters, and a left character x
+ * pairs with a right character y when left[x] == right[y]. Engines map the
+ * string once per call and then compare the mapped strings with ==, so their
+ * inner loops are the same for every relation. Only
+ * relations that can be written this way are offered, since Manacher's
+ * algorithm and the suffix structures rely on pairing being consistent
+ * across the string. RNA G-U wobble pairs G with both C and U, and can't be.
+ */
+enum PalindromeRelation {
+  RELATION_EXACT,
+  RELATION_CASE_INSENSITIVE,
+  RELATION_REVERSE_COMPLEMENT
+};
+
+/* FUNCTIONS */
+
+/*
+ * Map a string for each arm of relation. Arms that don't need mapping are str
+ * itself, so the memory this takes on top of str is:
+ *
+ * RELATION_EXACT                :   Nothing. Both strings are str.
+ * RELATION_CASE_INSENSITIVE     :   length bytes, one string for both arms.
+ * RELATION_REVERSE_COMPLEMENT   :   length bytes for the left arm, and the
+ *                                   right arm is str. Only if str holds every
+ *                                   one of the 256 byte values, so nothing is
+ *                                   left to mark unpaired characters, is the
+ *                                   right arm mapped too, for 2 * length.
+ *
+ * Finding a free byte for RELATION_REVERSE_COMPLEMENT takes one more read of
+ * str. manacher_with_relation doesn't map under RELATION_REVERSE_COMPLEMENT at
+ * all.
+ *
+ * Params:
+ *  enum PalindromeRelation relation    :   Relation to map for
+ *  const char* str                     :   String to map
+ *  size_t length                       :   Length of str
+ *  char** left_string                  :   Set to str mapped for left arms
+ *  char** right_string                 :   Set to str mapped for right arms
+ *
+ * Returns:
+ *  0 on success, else 1.
+ */
+int  Relation_map_string(enum PalindromeRelation relation, const char* str,
+                         size_t length, char** left_string, char** right_string);
+
+/* Free the strings from Relation_map_string, and set them to NULL. */
+void Relation_free_strings(const char* str, char** left_string, char** right_string);
+
+/* Whether a character can pair with itself, as the middle of an odd palindrome. */
+int  Relation_is_reflexive(enum PalindromeRelation relation);
+
+#endif
@@ -0,0 +1,243 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "approximate/edit_palindromes.h"
+#include "manacher/manacher.h"
+
+struct Found {
+  struct EditPalindrome* palindromes;
+  size_t num;
+};
+
+int collect(const struct EditPalindrome* palindrome, void* data)
+{
+  struct Found* found = data;
+  found->palindromes[found->num++] = *palindrome;
+  return 0;
+}
+
+/*
+ * The longest arms at a center within max_edits of each other, with the whole
+ * dynamic programming table of the left arm, reversed, against the right.
+ */
+void brute_force_center(char* str, size_t str_len, size_t pos, size_t max_edits,
+                        size_t* length, size_t* edits)
+{
+  size_t left_start = pos / 2;
+  size_t right_start = (pos + 1) / 2;
+  size_t rows = left_start;
+  size_t columns = str_len - right_start;
+  size_t* table = malloc((rows + 1) * (columns + 1) * sizeof(size_t));
+  size_t i = 0;
+  size_t j = 0;
+
+  *length = 0;
+  *edits = 0;
+  for(i = 0; i <= rows; i++) {
+    for(j = 0; j <= columns; j++) {
+      size_t value = 0;
+      if(i == 0) value = j;
+      else if(j == 0) value = i;
+      else {
+        size_t sub = table[(i - 1) * (columns + 1) + j - 1] +
+                     (str[left_start - i] != str[right_start + j - 1]);
+        size_t del = table[(i - 1) * (columns + 1) + j] + 1;
+        size_t ins = table[i * (columns + 1) + j - 1] + 1;
+        value = sub < del ? sub : del;
+        value = value < ins ? value : ins;
+      }
+      table[i * (columns + 1) + j] = value;
+      if(value <= max_edits && (i + j > *length ||
+                                (i + j == *length && value < *edits))) {
+        *length = i + j;
+        *edits = value;
+      }
+    }
+  }
+  *length += pos % 2;
+  free(table);
+}
+
+char* check_against_brute_force(char* str, size_t str_len, size_t max_edits)
+{
+  struct Found found = {NULL, 0};
+  found.palindromes = malloc((2 * str_len + 1) * sizeof(struct EditPalindrome));
+
+  int rc = edit_palindromes_foreach(str, str_len, max_edits, 0, collect, &found);
+  mu_assert(rc == 0, "edit_palindromes_foreach failed.");
+
+  size_t pos = 0;
+  size_t next = 0;
+  for(pos = 1; pos < 2 * str_len; pos++) {
+    size_t length = 0;
+    size_t edits = 0;
+    brute_force_center(str, str_len, pos, max_edits, &length, &edits);
+    if(length == 0) continue;
+
+    mu_assert(next < found.num && found.palindromes[next].center == pos,
+              "Missing palindrome at center %zu with %zu edits.", pos, max_edits);
+    struct EditPalindrome* palindrome = &found.palindromes[next++];
+    mu_assert(palindrome->length == length,
+              "With %zu edits, palindrome at %zu has length %zu, but should be %zu.",
+              max_edits, pos, palindrome->length, length);
+    mu_assert(palindrome->edits == edits,
+              "With %zu edits, palindrome at %zu has %zu edits, but should have %zu.",
+              max_edits, pos, palindrome->edits, edits);
+    mu_assert(palindrome->start <= pos / 2 &&
+              palindrome->start + palindrome->length >= (pos + 1) / 2 &&
+              palindrome->start + palindrome->length <= str_len,
+              "Palindrome at %zu doesn't contain its center.", pos);
+  }
+  mu_assert(next == found.num, "Found extra palindromes with %zu edits.", max_edits);
+
+  free(found.palindromes);
+  return NULL;
+}
+
+char* test_short()
+{
+  char single[] = "A";
+  char pair[] = "AC";
+  char str[] = "ACGTTGCATTACGGCATGCA";
+  char* result = check_against_brute_force(single, 1, 1);
+  if(!result) result = check_against_brute_force(pair, 2, 0);
+  if(!result) result = check_against_brute_force(pair, 2, 1);
+  size_t k = 0;
+  for(k = 0; k < 4 && !result; k++) {
+    result = check_against_brute_force(str, sizeof(str) - 1, k);
+  }
+
+  struct Found found = {NULL, 0};
+  int rc = edit_palindromes_foreach(str, 0, 1, 0, collect, &found);
+  mu_assert(rc == 0 && found.num == 0, "An empty string has no palindromes.");
+  return result;
+}
+
+char* test_no_edits_is_manacher()
+{
+  const size_t str_len = 5000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+
+  struct Found found = {NULL, 0};
+  found.palindromes = malloc((2 * str_len + 1) * sizeof(struct EditPalindrome));
+  int rc = edit_palindromes_foreach(str, str_len, 0, 0, collect, &found);
+  mu_assert(rc == 0, "edit_palindromes_foreach failed.");
+
+  size_t* radii = manacher(str, str_len);
+  size_t i = 0;
+  size_t pos = 0;
+  for(pos = 1; pos < 2 * str_len; pos++) {
+    size_t length = 2 * radii[pos] + pos % 2;
+    if(length == 0) continue;
+    mu_assert(i < found.num && found.palindromes[i].center == pos &&
+              found.palindromes[i].length == length &&
+              found.palindromes[i].edits == 0,
+              "Palindrome at %zu differs from manacher.", pos);
+    i++;
+  }
+  mu_assert(i == found.num, "Found extra palindromes.");
+
+  free(radii);
+  free(found.palindromes);
+  free(str);
+  return NULL;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 120;
+  char* str = malloc(str_len * sizeof(char));
+  size_t i = 0;
+  char* result = NULL;
+
+  for(i = 0; i < 6 && !result; i++) {
+    random_string(str, str_len);
+    result = check_against_brute_force(str, str_len, i);
+  }
+
+  free(str);
+  return result;
+}
+
+/* Long palindromes broken by indels near their centers need several words. */
+char* test_long_arms()
+{
+  const size_t arm_len = 200;
+  const size_t str_len = 2 * arm_len + 8;
+  char* str = malloc(str_len * sizeof(char));
+  size_t k = 0;
+  char* result = NULL;
+
+  for(k = 1; k < 4 && !result; k++) {
+    size_t i = 0;
+    size_t len = 0;
+    random_string(str, arm_len);
+    len = arm_len;
+    str[len++] = 'A';
+    for(i = 0; i < arm_len; i++) str[len++] = str[arm_len - 1 - i];
+    /* Insert k characters a few places right of the center. */
+    for(i = 0; i < k; i++) {
+      size_t at = arm_len + 3 + 5 * i;
+      memmove(str + at + 1, str + at, len - at);
+      str[at] = 'T';
+      len++;
+    }
+    result = check_against_brute_force(str, len, k);
+
+    size_t whole = 0;
+    size_t edits = 0;
+    brute_force_center(str, len, 2 * arm_len + 1, k, &whole, &edits);
+    mu_assert(whole == len, "The whole string should be a palindrome with %zu edits.",
+              k);
+  }
+
+  free(str);
+  return result;
+}
+
+int stop_after_one(const struct EditPalindrome* palindrome, void* data)
+{
+  (void)palindrome;
+  (*(size_t*)data)++;
+  return 1;
+}
+
+char* test_min_length_and_stop()
+{
+  const size_t str_len = 2000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+
+  struct Found found = {NULL, 0};
+  found.palindromes = malloc((2 * str_len + 1) * sizeof(struct EditPalindrome));
+  int rc = edit_palindromes_foreach(str, str_len, 2, 12, collect, &found);
+  mu_assert(rc == 0, "edit_palindromes_foreach failed.");
+  size_t i = 0;
+  for(i = 0; i < found.num; i++) {
+    mu_assert(found.palindromes[i].length >= 12, "Palindrome shorter than min_length.");
+    mu_assert(found.palindromes[i].edits <= 2, "Palindrome with too many edits.");
+  }
+
+  size_t calls = 0;
+  rc = edit_palindromes_foreach(str, str_len, 2, 0, stop_after_one, &calls);
+  mu_assert(rc == 0 && calls == 1, "Search should stop when asked.");
+
+  free(found.palindromes);
+  free(str);
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_short);
+  mu_run_test(test_no_edits_is_manacher);
+  mu_run_test(test_random_strings);
+  mu_run_test(test_long_arms);
+  mu_run_test(test_min_length_and_stop);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
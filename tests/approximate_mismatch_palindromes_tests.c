@@ -0,0 +1,180 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "approximate/mismatch_palindromes.h"
+#include "manacher/manacher.h"
+
+/* The radius at each center by extending one pair at a time. */
+size_t* brute_force_radii(char* str, size_t str_len, size_t max_mismatches)
+{
+  size_t* radii = calloc(2 * str_len + 1, sizeof(size_t));
+  size_t pos = 0;
+  for(pos = 1; pos < 2 * str_len; pos++) {
+    size_t first = pos / 2;
+    size_t last = (pos - 1) / 2;
+    size_t radius = 0;
+    size_t mismatches = 0;
+    while(first > radius && last + radius + 1 < str_len) {
+      if(str[first - radius - 1] != str[last + radius + 1]) {
+        if(mismatches == max_mismatches) break;
+        mismatches++;
+      }
+      radius++;
+    }
+    radii[pos] = radius;
+  }
+  return radii;
+}
+
+char* check_against_brute_force(char* str, size_t str_len, size_t max_mismatches)
+{
+  size_t* expected = brute_force_radii(str, str_len, max_mismatches);
+  size_t* radii = mismatch_palindromes(str, str_len, max_mismatches);
+  mu_assert(radii, "mismatch_palindromes failed.");
+
+  size_t i = 0;
+  for(i = 0; i < 2 * str_len + 1; i++) {
+    mu_assert(radii[i] == expected[i],
+              "With %zu mismatches, radius at %zu is %zu, but should be %zu.",
+              max_mismatches, i, radii[i], expected[i]);
+  }
+  int rc = verify_mismatch_palindrome_radii(str, str_len, max_mismatches, radii);
+  mu_assert(rc == 0, "Failed verification with %zu mismatches.", max_mismatches);
+
+  free(radii);
+  free(expected);
+  return NULL;
+}
+
+char* test_panama()
+{
+  char str[] = "AMANAPLANACANALPANAMA";
+  size_t str_len = sizeof(str) - 1;
+  size_t k = 0;
+  char* result = NULL;
+  for(k = 0; k < 4 && !result; k++) {
+    result = check_against_brute_force(str, str_len, k);
+  }
+  return result;
+}
+
+char* test_no_mismatches_is_manacher()
+{
+  const size_t str_len = 10000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+
+  size_t* expected = manacher(str, str_len);
+  size_t* radii = mismatch_palindromes(str, str_len, 0);
+  mu_assert(radii, "mismatch_palindromes failed.");
+  size_t i = 0;
+  for(i = 0; i < 2 * str_len + 1; i++) {
+    mu_assert(radii[i] == expected[i], "Radius at %zu differs from manacher.", i);
+  }
+
+  free(radii);
+  free(expected);
+  free(str);
+  return NULL;
+}
+
+char* test_short()
+{
+  char empty[] = "";
+  char single[] = "A";
+  char pair[] = "AC";
+  char* result = check_against_brute_force(empty, 0, 1);
+  if(!result) result = check_against_brute_force(single, 1, 1);
+  if(!result) result = check_against_brute_force(pair, 2, 0);
+  if(!result) result = check_against_brute_force(pair, 2, 1);
+  return result;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 6000;
+  char* str = malloc(str_len * sizeof(char));
+  size_t i = 0;
+  char* result = NULL;
+
+  for(i = 0; i < 6 && !result; i++) {
+    random_string(str, str_len);
+    result = check_against_brute_force(str, str_len, i);
+  }
+  /* A run with scattered changes has long palindromes with many mismatches. */
+  memset(str, 'A', str_len);
+  for(i = 0; i < str_len; i += 1 + rand() % 30) str[i] = 'C';
+  if(!result) result = check_against_brute_force(str, str_len, 5);
+
+  free(str);
+  return result;
+}
+
+char* test_reuse_augmented_string()
+{
+  char str[] = "ACGTTGCATTACGGCATGCA";
+  size_t str_len = sizeof(str) - 1;
+  AugmentedString_T augmented_string = AugmentedString_create(str, str_len);
+  mu_assert(augmented_string, "Failed to create augmented string.");
+
+  size_t k = 0;
+  for(k = 0; k < 3; k++) {
+    size_t* expected = brute_force_radii(str, str_len, k);
+    size_t* radii = mismatch_palindromes_from_augmented_string(augmented_string, k);
+    mu_assert(radii, "mismatch_palindromes_from_augmented_string failed.");
+    size_t i = 0;
+    for(i = 0; i < 2 * str_len + 1; i++) {
+      mu_assert(radii[i] == expected[i], "Radius at %zu is wrong with %zu mismatches.",
+                i, k);
+    }
+    free(radii);
+    free(expected);
+  }
+
+  AugmentedString_delete(&augmented_string);
+  return NULL;
+}
+
+char* test_packed()
+{
+  const size_t str_len = 6000;
+  char* str = malloc(str_len * sizeof(char));
+  size_t k = 0;
+
+  random_string(str, str_len);
+  for(k = 0; k < 300; k++) str[rand() % str_len] = 'N';
+  PackedSequence_T sequence = PackedSequence_create(str, str_len);
+  mu_assert(sequence, "Failed to create packed sequence.");
+
+  for(k = 0; k < 6; k++) {
+    size_t* expected = brute_force_radii(str, str_len, k);
+    size_t* radii = mismatch_palindromes_packed(sequence, k);
+    mu_assert(radii, "mismatch_palindromes_packed failed.");
+    size_t i = 0;
+    for(i = 0; i < 2 * str_len + 1; i++) {
+      mu_assert(radii[i] == expected[i], "Packed radius at %zu is wrong with %zu mismatches.",
+                i, k);
+    }
+    free(radii);
+    free(expected);
+  }
+
+  PackedSequence_delete(&sequence);
+  free(str);
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_panama);
+  mu_run_test(test_no_mismatches_is_manacher);
+  mu_run_test(test_short);
+  mu_run_test(test_random_strings);
+  mu_run_test(test_reuse_augmented_string);
+  mu_run_test(test_packed);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
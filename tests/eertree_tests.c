@@ -0,0 +1,177 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "eertree/eertree.h"
+
+int is_palindrome(const char* str, size_t length)
+{
+  size_t i = 0;
+  for(i = 0; i < length / 2; i++) {
+    if(str[i] != str[length - 1 - i]) return 0;
+  }
+  return 1;
+}
+
+/* Check every statistic of an Eertree_T against brute force. */
+char* check_against_brute_force(const char* str, size_t str_len)
+{
+  Eertree_T tree = Eertree_create(str, str_len);
+  mu_assert(tree, "Failed to create Eertree_T.");
+  mu_assert(Eertree_get_length(tree) == str_len, "Wrong string length.");
+
+  size_t num_palindromes = Eertree_get_num_palindromes(tree);
+  char* seen = calloc(num_palindromes, sizeof(char));
+  size_t num_distinct = 0;
+  size_t start = 0;
+  size_t end = 0;
+
+  for(end = 1; end <= str_len; end++) {
+    size_t longest = 0;
+    for(start = 0; start < end; start++) {
+      size_t length = end - start;
+      if(!is_palindrome(str + start, length)) continue;
+      if(length > longest) longest = length;
+
+      size_t index = 0;
+      int found = Eertree_find(tree, str + start, length, &index);
+      mu_assert(found, "Palindrome at [%zu, %zu) not found.", start, end);
+      mu_assert(Eertree_get_palindrome_length(tree, index) == length,
+                "Palindrome %zu has the wrong length.", index);
+
+      /* The first occurrence is the first time it's seen ending. */
+      if(!seen[index]) {
+        seen[index] = 1;
+        num_distinct++;
+        mu_assert(Eertree_get_first_start(tree, index) == start,
+                  "Palindrome %zu first starts at %zu, not %zu.", index,
+                  Eertree_get_first_start(tree, index), start);
+
+        size_t count = 0;
+        size_t j = 0;
+        for(j = 0; j + length <= str_len; j++) {
+          count += memcmp(str + j, str + start, length) == 0;
+        }
+        mu_assert(Eertree_get_count(tree, index) == count,
+                  "Palindrome %zu occurs %zu times, not %zu.", index, count,
+                  Eertree_get_count(tree, index));
+      }
+    }
+    size_t suffix = Eertree_get_longest_suffix(tree, end - 1);
+    mu_assert(Eertree_get_palindrome_length(tree, suffix) == longest,
+              "Longest palindrome ending at %zu is %zu long, not %zu.", end - 1,
+              longest, Eertree_get_palindrome_length(tree, suffix));
+  }
+  mu_assert(num_distinct == num_palindromes, "Tree has %zu palindromes, not %zu.",
+            num_palindromes, num_distinct);
+
+  free(seen);
+  Eertree_delete(&tree);
+  mu_assert(tree == NULL, "Eertree_delete did not clear the pointer.");
+  return NULL;
+}
+
+char* test_banana()
+{
+  char str[] = "BANANA";
+  return check_against_brute_force(str, sizeof(str) - 1);
+}
+
+char* test_empty()
+{
+  Eertree_T tree = Eertree_create("", 0);
+  mu_assert(tree, "Failed to create empty Eertree_T.");
+  mu_assert(Eertree_get_num_palindromes(tree) == 0, "Empty string has palindromes.");
+  size_t index = 0;
+  mu_assert(!Eertree_find(tree, "A", 1, &index), "Found A in an empty string.");
+  Eertree_delete(&tree);
+  return NULL;
+}
+
+char* test_find()
+{
+  char str[] = "ABACABA";
+  Eertree_T tree = Eertree_create(str, sizeof(str) - 1);
+  size_t index = 0;
+  mu_assert(Eertree_find(tree, "ACA", 3, &index), "Didn't find ACA.");
+  mu_assert(Eertree_get_count(tree, index) == 1, "ACA should occur once.");
+  mu_assert(Eertree_find(tree, "ABA", 3, &index), "Didn't find ABA.");
+  mu_assert(Eertree_get_count(tree, index) == 2, "ABA should occur twice.");
+  mu_assert(!Eertree_find(tree, "AB", 2, &index), "Found AB, which isn't a palindrome.");
+  mu_assert(!Eertree_find(tree, "BB", 2, &index), "Found BB, which doesn't occur.");
+  mu_assert(!Eertree_find(tree, "", 0, &index), "Found the empty palindrome.");
+  Eertree_delete(&tree);
+  return NULL;
+}
+
+char* test_online()
+{
+  /* Counts stay right as the string grows. */
+  char str[] = "AAAA";
+  Eertree_T tree = Eertree_create(str, 2);
+  size_t index = 0;
+  mu_assert(Eertree_find(tree, "A", 1, &index), "Didn't find A.");
+  mu_assert(Eertree_get_count(tree, index) == 2, "A should occur twice.");
+  mu_assert(Eertree_append(tree, 'A') == 0 && Eertree_append(tree, 'A') == 0,
+            "Failed to append.");
+  mu_assert(Eertree_get_count(tree, index) == 4, "A should occur four times.");
+  mu_assert(Eertree_get_num_palindromes(tree) == 4, "AAAA has four palindromes.");
+  Eertree_delete(&tree);
+  return NULL;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 300;
+  char* str = malloc(str_len * sizeof(char));
+  size_t i = 0;
+  char* result = NULL;
+
+  for(i = 0; i < 20 && !result; i++) {
+    random_string(str, str_len);
+    /* Small alphabets make for many palindromes. */
+    if(i % 2) {
+      size_t j = 0;
+      for(j = 0; j < str_len; j++) str[j] = str[j] == 'A' || str[j] == 'C' ? 'A' : 'T';
+    }
+    result = check_against_brute_force(str, str_len);
+  }
+
+  free(str);
+  return result;
+}
+
+char* test_long_string()
+{
+  /* Linear time: a long run has only as many palindromes as characters. */
+  const size_t str_len = 1000000;
+  char* str = malloc(str_len * sizeof(char));
+  memset(str, 'A', str_len);
+  Eertree_T tree = Eertree_create(str, str_len);
+  mu_assert(tree, "Failed to create Eertree_T.");
+  mu_assert(Eertree_get_num_palindromes(tree) == str_len, "Wrong number of palindromes.");
+  size_t index = Eertree_get_longest_suffix(tree, str_len - 1);
+  mu_assert(Eertree_get_count(tree, index) == 1, "Whole string should occur once.");
+  Eertree_delete(&tree);
+
+  random_string(str, str_len);
+  tree = Eertree_create(str, str_len);
+  mu_assert(tree, "Failed to create Eertree_T.");
+  Eertree_delete(&tree);
+  free(str);
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_banana);
+  mu_run_test(test_empty);
+  mu_run_test(test_find);
+  mu_run_test(test_online);
+  mu_run_test(test_random_strings);
+  mu_run_test(test_long_string);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
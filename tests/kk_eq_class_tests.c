@@ -159,6 +159,65 @@ char* test_random_strings()
   return NULL;
 }
 
+/* The suffix array backend should give the same tables and the same common
+ * prefix-suffix lengths as the suffix tree. */
+char* test_suffix_array_backend()
+{
+  const size_t str_len = 2000;
+  char* str = calloc((str_len + 1), sizeof(char));
+  size_t substr_len;
+
+  AugmentedString_T tree_string = NULL;
+  AugmentedString_T array_string = NULL;
+  EquivClassTable_T eq_table = NULL;
+
+  int ret = 0;
+  unsigned int i = 0;
+  for(i = 0; i < 5; i++) {
+    random_string(str, str_len);
+    substr_len = rand() % 20 + 1;
+
+    tree_string = AugmentedString_create(str, str_len);
+    array_string = AugmentedString_create_with_backend(
+        str, str_len, AUGMENTED_STRING_SUFFIX_ARRAY);
+    mu_assert(array_string, "Failed to create suffix array augmented string.");
+    mu_assert(AugmentedString_get_tree(array_string) == NULL,
+              "Suffix array augmented string has a tree.");
+
+    eq_table = EquivClassTable_create(array_string, substr_len);
+    ret = EquivClassTable_verify(str, str_len, eq_table, substr_len);
+    mu_assert(ret == 0, "Failed equivalence class verification.");
+    EquivClassTable_delete(&eq_table);
+
+    size_t j = 0;
+    for(j = 0; j < 1000; j++) {
+      size_t left_pos = rand() % str_len;
+      size_t right_pos = rand() % (str_len + 1);
+      size_t tree_length = AugmentedString_common_prefix_suffix_length(
+          tree_string, left_pos, right_pos);
+      size_t array_length = AugmentedString_common_prefix_suffix_length(
+          array_string, left_pos, right_pos);
+      mu_assert(tree_length == array_length,
+                "Common prefix-suffix length at (%zu, %zu) is %zu with the "
+                "suffix tree but %zu with the suffix array.", left_pos,
+                right_pos, tree_length, array_length);
+
+      size_t pos1 = rand() % (2 * str_len + 1);
+      size_t pos2 = rand() % (2 * str_len + 1);
+      mu_assert(AugmentedString_lce(tree_string, pos1, pos2) ==
+                AugmentedString_lce(array_string, pos1, pos2),
+                "LCE at (%zu, %zu) differs between backends.", pos1, pos2);
+    }
+
+    AugmentedString_delete(&tree_string);
+    AugmentedString_delete(&array_string);
+  }
+
+  free(str);
+
+  return NULL;
+}
+
 char* all_tests()
 {
   mu_suite_start();
@@ -166,6 +225,7 @@ char* all_tests()
   mu_run_test(test_eq_class_verification);
   mu_run_test(test_banana);
   mu_run_test(test_random_strings);
+  mu_run_test(test_suffix_array_backend);
 
   return NULL;
 }
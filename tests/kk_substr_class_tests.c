@@ -130,12 +130,42 @@ char* test_substr_class_verification()
   return NULL;
 }
 
+/*
+ * Test substring class assignment from a suffix array for random strings.
+ */
+char* test_suffix_array_random_strings()
+{
+  const size_t str_len = 5000;
+  char* str = calloc((str_len + 1), sizeof(char));
+  size_t substr_len;
+
+  unsigned int i = 0;
+  int ret = 0;
+  for(i = 0; i < 10; i++) {
+    random_string(str, str_len);
+    SuffixArray_T suffix_array = SuffixArray_create(str, str_len);
+    substr_len = rand() % 100 + 1;
+    size_t* substr_classes = annotate_substr_classes_with_suffix_array(substr_len,
+                                                                       suffix_array);
+
+    ret = verify_substr_classes(str, str_len, substr_len, substr_classes);
+    mu_assert(ret == 0, "Verification of suffix array substring classes failed.");
+
+    SuffixArray_delete(&suffix_array);
+    free(substr_classes);
+  }
+  free(str);
+
+  return NULL;
+}
+
 char* all_tests()
 {
   mu_suite_start();
   
   mu_run_test(test_substr_class_mississippi);
   mu_run_test(test_random_strings);
+  mu_run_test(test_suffix_array_random_strings);
   mu_run_test(test_substr_class_verification);
 
   return NULL;
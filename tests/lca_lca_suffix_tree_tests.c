@@ -83,6 +83,42 @@ char* test_random()
   return NULL;
 }
 
+/* Batch lookups should match single lookups, including a partial batch. */
+char* test_batch()
+{
+  const size_t str_len = 2000;
+  const size_t num_pairs = 1000;
+  char* str = calloc((str_len + 1), sizeof(char));
+  random_string(str, str_len);
+
+  LCASuffixTree_T tree = LCASuffixTree_create(str, str_len);
+  Node_T* node_array = SuffixTree_create_node_array((SuffixTree_T)tree);
+  size_t num_nodes = SuffixTree_get_num_nodes((SuffixTree_T)tree);
+
+  Node_T* pairs = malloc(2 * num_pairs * sizeof(Node_T));
+  Node_T* lcas = malloc(num_pairs * sizeof(Node_T));
+  size_t i = 0;
+  for(i = 0; i < 2 * num_pairs; i++) {
+    pairs[i] = node_array[rand() % num_nodes];
+  }
+
+  int rc = LCASuffixTree_get_lca_batch(tree, pairs, num_pairs, lcas);
+  mu_assert(rc == 0, "Batch LCA lookup failed.");
+  for(i = 0; i < num_pairs; i++) {
+    Node_T lca = LCASuffixTree_get_lca(tree, pairs[2 * i], pairs[2 * i + 1]);
+    mu_assert(lcas[i] == lca, "Batch LCA of pair %zu is node %zu, but it should "
+              "be node %zu.", i, Node_get_index(lcas[i]), Node_get_index(lca));
+  }
+
+  free(lcas);
+  free(pairs);
+  free(node_array);
+  LCASuffixTree_delete(&tree);
+  free(str);
+
+  return NULL;
+}
+
 char* all_tests()
 {
   mu_suite_start();
@@ -90,6 +126,7 @@ char* all_tests()
   mu_run_test(test_banana);
   mu_run_test(test_banana_with_reverse);
   mu_run_test(test_random);
+  mu_run_test(test_batch);
 
   return NULL;
 }
@@ -0,0 +1,169 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "lca/lce.h"
+#include "suffix_tree/suffix_tree.h"
+
+char* test_banana()
+{
+  char str[] = "BANANA";
+  size_t str_len = sizeof(str) - 1;
+
+  SuffixTree_T tree = SuffixTree_create(str, str_len);
+  LCE_T lce = LCE_create_from_suffix_tree(tree);
+  mu_assert(lce, "Failed to create LCE_T.");
+  SuffixTree_delete(&tree);
+
+  mu_assert(LCE_get_length(lce) == str_len, "LCE_T has the wrong length.");
+  mu_assert(LCE_lookup(lce, 1, 3) == 3, "LCE of ANANA and ANA is wrong.");
+  mu_assert(LCE_lookup(lce, 3, 1) == 3, "LCE of ANA and ANANA is wrong.");
+  mu_assert(LCE_lookup(lce, 2, 4) == 2, "LCE of NANA and NA is wrong.");
+  mu_assert(LCE_lookup(lce, 0, 5) == 0, "LCE of BANANA and A is wrong.");
+  mu_assert(LCE_lookup(lce, 5, 5) == 1, "LCE of A and itself is wrong.");
+
+  int rc = LCE_verify(lce, str);
+  mu_assert(rc == 0, "LCE_T verification failed.");
+
+  LCE_delete(&lce);
+  mu_assert(lce == NULL, "LCE_delete did not clear the pointer.");
+
+  return NULL;
+}
+
+char* test_from_arrays()
+{
+  /* ABAB: suffixes in order are AB, ABAB, B, BAB. */
+  uint32_t* ranks = malloc(4 * sizeof(uint32_t));
+  uint32_t* lcp = malloc(4 * sizeof(uint32_t));
+  uint32_t ranks_values[] = {1, 3, 0, 2};
+  uint32_t lcp_values[] = {0, 2, 0, 1};
+  memcpy(ranks, ranks_values, sizeof(ranks_values));
+  memcpy(lcp, lcp_values, sizeof(lcp_values));
+
+  LCE_T lce = LCE_create(ranks, lcp, 4, 4);
+  mu_assert(lce, "Failed to create LCE_T.");
+
+  int rc = LCE_verify(lce, "ABAB");
+  mu_assert(rc == 0, "LCE_T verification failed.");
+
+  LCE_delete(&lce);
+
+  return NULL;
+}
+
+/* 64-bit ranks and LCPs answer the same as the 32-bit ones of a tree. */
+char* test_wide()
+{
+  const size_t str_len = 2000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+
+  SuffixTree_T tree = SuffixTree_create(str, str_len);
+  LCE_T lce = LCE_create_from_suffix_tree(tree);
+  mu_assert(lce, "Failed to create LCE_T.");
+
+  size_t num_ranks = str_len + 1;
+  uint64_t* ranks = malloc(str_len * sizeof(uint64_t));
+  uint64_t* lcp = malloc(num_ranks * sizeof(uint64_t));
+  size_t i = 0;
+  for(i = 0; i < str_len; i++) ranks[i] = LCE_get_rank(lce, i);
+  for(i = 0; i < num_ranks; i++) lcp[i] = LCE_get_lcp(lce, i);
+
+  LCE_T wide_lce = LCE_create_wide(ranks, lcp, str_len, num_ranks);
+  mu_assert(wide_lce, "Failed to create wide LCE_T.");
+  int rc = LCE_verify(wide_lce, str);
+  mu_assert(rc == 0, "Wide LCE_T verification failed.");
+
+  size_t pairs[200];
+  size_t lengths[100];
+  for(i = 0; i < 200; i++) pairs[i] = rand() % str_len;
+  rc = LCE_lookup_batch(wide_lce, pairs, 100, lengths);
+  mu_assert(rc == 0, "Batch lookup failed.");
+  for(i = 0; i < 100; i++) {
+    mu_assert(lengths[i] == LCE_lookup(lce, pairs[2 * i], pairs[2 * i + 1]),
+              "Wide batch lookup %zu is wrong.", i);
+  }
+
+  LCE_delete(&wide_lce);
+  LCE_delete(&lce);
+  SuffixTree_delete(&tree);
+  free(str);
+
+  return NULL;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 3000;
+  char* str = calloc((str_len + 1), sizeof(char));
+
+  unsigned int i = 0;
+  for(i = 0; i < 10; i++) {
+    size_t length = rand() % str_len + 1;
+    random_string(str, length);
+    str[length] = '\0';
+
+    SuffixTree_T tree = SuffixTree_create(str, length);
+    LCE_T lce = LCE_create_from_suffix_tree(tree);
+    mu_assert(lce, "Failed to create LCE_T.");
+
+    int rc = LCE_verify(lce, str);
+    mu_assert(rc == 0, "LCE_T verification failed for random string.");
+
+    LCE_delete(&lce);
+    SuffixTree_delete(&tree);
+  }
+  free(str);
+
+  return NULL;
+}
+
+char* test_batch()
+{
+  const size_t str_len = 5000;
+  const size_t num_pairs = 1001;
+  char* str = calloc((str_len + 1), sizeof(char));
+  random_string(str, str_len);
+
+  SuffixTree_T tree = SuffixTree_create(str, str_len);
+  LCE_T lce = LCE_create_from_suffix_tree(tree);
+  SuffixTree_delete(&tree);
+
+  size_t* pairs = malloc(2 * num_pairs * sizeof(size_t));
+  size_t* lengths = malloc(num_pairs * sizeof(size_t));
+  size_t i = 0;
+  for(i = 0; i < 2 * num_pairs; i++) {
+    pairs[i] = rand() % str_len;
+  }
+  /* Make sure a position paired with itself is covered. */
+  pairs[1] = pairs[0];
+
+  int rc = LCE_lookup_batch(lce, pairs, num_pairs, lengths);
+  mu_assert(rc == 0, "Batch LCE lookup failed.");
+  for(i = 0; i < num_pairs; i++) {
+    size_t expected = LCE_lookup(lce, pairs[2 * i], pairs[2 * i + 1]);
+    mu_assert(lengths[i] == expected, "Batch LCE of pair %zu is %zu, but it "
+              "should be %zu.", i, lengths[i], expected);
+  }
+
+  free(lengths);
+  free(pairs);
+  LCE_delete(&lce);
+  free(str);
+
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_banana);
+  mu_run_test(test_from_arrays);
+  mu_run_test(test_random_strings);
+  mu_run_test(test_wide);
+  mu_run_test(test_batch);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
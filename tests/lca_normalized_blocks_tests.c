@@ -44,67 +44,74 @@ char* test_block_ids()
   return NULL;
 }
 
-char* test_brt_lookup()
+/* Look up ranges of a long block by id, as LCASuffixTree_get_lca does. */
+char* test_brd_lookup_by_id()
 {
   size_t block[20] = {10, 11, 12, 13, 12, 11, 10, 11, 10,  9,
                     /* 0   1   2   3   4   5   6   7   8   9 */
-                       8,  7,  6,  5,  6,  7,  8,  7,  6,  7}; 
+                       8,  7,  6,  5,  6,  7,  8,  7,  6,  7};
 
   size_t block_size = sizeof(block)/sizeof(size_t);
-  
-  BlockRMQTable_T block_rmq_table = BlockRMQTable_create(block, block_size);
-  BlockRMQTable_print(block_rmq_table);
-  size_t ret = 0;
-
-  ret = BlockRMQTable_lookup(block_rmq_table, 5, 12);
-  mu_assert(ret == 11, "BlockRMQTable_lookup failed, expected %d but got %zu",
-            11, ret);
 
-  ret = BlockRMQTable_lookup(block_rmq_table, 12, 5);
-  mu_assert(ret == 11, "BlockRMQTable_lookup failed, expected %d but got %zu",
-            11, ret);
+  BlockRMQDatabase_T block_rmq_db = BlockRMQDatabase_create(block_size);
+  mu_assert(block_rmq_db, "Failed to create BlockRMQDatabase.");
+  unsigned int block_id = get_block_id(block, block_size);
+  size_t ret = 0;
 
-  ret = BlockRMQTable_lookup(block_rmq_table, 1, 7);
-  mu_assert(ret == 6, "BlockRMQTable_lookup failed, expected %d but got %zu",
-            6, ret);
+  ret = BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, 5, 12);
+  mu_assert(ret == 11, "BlockRMQDatabase_lookup_by_id failed, expected %d but "
+            "got %zu", 11, ret);
 
-  ret = BlockRMQTable_lookup(block_rmq_table, 0, 20);
-  mu_assert(ret == 13, "BlockRMQTable_lookup failed, expected %d but got %zu",
-            13, ret);
+  ret = BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, 1, 7);
+  mu_assert(ret == 6, "BlockRMQDatabase_lookup_by_id failed, expected %d but "
+            "got %zu", 6, ret);
 
-  ret = BlockRMQTable_lookup(block_rmq_table, 20, 0);
-  mu_assert(ret == 13, "BlockRMQTable_lookup failed, expected %d but got %zu",
-            13, ret);
+  ret = BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, 0, 20);
+  mu_assert(ret == 13, "BlockRMQDatabase_lookup_by_id failed, expected %d but "
+            "got %zu", 13, ret);
 
-  ret = BlockRMQTable_lookup(block_rmq_table, 14, 19);
-  mu_assert(ret == 14, "BlockRMQTable_lookup failed, expected %d but got %zu",
-            14, ret);
+  ret = BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, 14, 19);
+  mu_assert(ret == 14, "BlockRMQDatabase_lookup_by_id failed, expected %d but "
+            "got %zu", 14, ret);
 
-  BlockRMQTable_delete(&block_rmq_table);
+  BlockRMQDatabase_delete(&block_rmq_db);
 
   return NULL;
 }
 
-char* test_brt_lookup_random()
+/* Check lookups by id on random +-1 blocks against a scan of each range. */
+char* test_brd_lookup_by_id_random()
 {
+  size_t block[16];
+  size_t block_size = 16;
 
-  size_t* block = calloc(50, sizeof(size_t));
-  size_t block_size = 50;
-
-  unsigned int i = 0;
-  for(i = 0; i < 100; i++) {
-    random_sizes(block, block_size);
-    
-    BlockRMQTable_T block_rmq_table = BlockRMQTable_create(block, block_size);
-    
-    int ret = BlockRMQTable_verify(block_rmq_table, block);
-
-    mu_assert(ret == 0, "BlockRMQTable verification failed on random block.");
-    BlockRMQTable_delete(&block_rmq_table);
+  BlockRMQDatabase_T block_rmq_db = BlockRMQDatabase_create(block_size);
+  mu_assert(block_rmq_db, "Failed to create BlockRMQDatabase.");
+
+  unsigned int n = 0;
+  for(n = 0; n < 100; n++) {
+    size_t k = 0;
+    block[0] = block_size;
+    for(k = 0; k + 1 < block_size; k++) {
+      block[k + 1] = rand() % 2 ? block[k] + 1 : block[k] - 1;
+    }
+    unsigned int block_id = get_block_id(block, block_size);
+
+    size_t i = 0, j = 0;
+    for(i = 0; i < block_size; i++) {
+      size_t min_pos = i;
+      for(j = i + 1; j <= block_size; j++) {
+        if(block[j - 1] < block[min_pos]) min_pos = j - 1;
+        size_t ret = BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, i, j);
+        mu_assert(ret == min_pos, "Min element position in [%zu:%zu] should be "
+                  "%zu, but BlockRMQDatabase_lookup_by_id returned %zu.", i, j,
+                  min_pos, ret);
+      }
+    }
   }
-  free(block);
-  return NULL;
 
+  BlockRMQDatabase_delete(&block_rmq_db);
+  return NULL;
 }
 
 /* Test lookups in the BlockRMQDatabase agains some simple expected values. */
@@ -155,25 +162,55 @@ char*  test_brd_lookup_range()
 {
 
   int block_size = 0;
-  for(block_size = 1; block_size < 8; block_size++) {
+  for(block_size = 1; block_size < 13; block_size++) {
     BlockRMQDatabase_T block_rmq_db = BlockRMQDatabase_create(block_size);
-    BlockRMQDatabase_verify(block_rmq_db);
+    int ret = BlockRMQDatabase_verify(block_rmq_db);
+    mu_assert(ret == 0, "BlockRMQDatabase verification failed for block size %d.",
+              block_size);
     BlockRMQDatabase_delete(&block_rmq_db);
   }
 
   return NULL;
 }
 
+/* Short blocks, like the last block of a tour, are looked up by padded id. */
+char* test_brd_short_blocks()
+{
+  size_t block[3] = {7, 6, 7};
+  size_t block_size = 3;
+  BlockRMQDatabase_T block_rmq_db = BlockRMQDatabase_create(6);
+
+  unsigned int block_id = get_padded_block_id(block, block_size, 6);
+  mu_assert(block_id == (1u << 3), "Incorrect padded block id %u.", block_id);
+
+  size_t ret = BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, 0, 3);
+  mu_assert(ret == 1, "Failed BlockRMQDatabase_lookup_by_id. Expected 1, got %zu", ret);
+  ret = BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, 2, 3);
+  mu_assert(ret == 2, "Failed BlockRMQDatabase_lookup_by_id. Expected 2, got %zu", ret);
+  ret = BlockRMQDatabase_lookup(block_rmq_db, block, block_size, 0, 1);
+  mu_assert(ret == 0, "Failed BlockRMQDatabase_lookup. Expected 0, got %zu", ret);
+
+  /* Equal minima resolve to the leftmost. */
+  size_t tied_block[5] = {4, 3, 4, 3, 4};
+  block_id = get_padded_block_id(tied_block, 5, 6);
+  ret = BlockRMQDatabase_lookup_by_id(block_rmq_db, block_id, 0, 5);
+  mu_assert(ret == 1, "Failed BlockRMQDatabase_lookup_by_id. Expected 1, got %zu", ret);
+
+  BlockRMQDatabase_delete(&block_rmq_db);
+  return NULL;
+}
+
 char* all_tests()
 {
   mu_suite_start();
   
   mu_run_test(test_block_ids);
-  mu_run_test(test_brt_lookup);
-  mu_run_test(test_brt_lookup_random);
+  mu_run_test(test_brd_lookup_by_id);
+  mu_run_test(test_brd_lookup_by_id_random);
 
   mu_run_test(test_brd_lookup);
   mu_run_test(test_brd_lookup_range);
+  mu_run_test(test_brd_short_blocks);
 
   return NULL;
 }
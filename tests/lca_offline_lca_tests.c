@@ -0,0 +1,94 @@
+#include "minunit.h"
+#include "test_utils.h"
+
+#include "lca/lca_suffix_tree.h"
+#include "lca/offline_lca.h"
+
+/* Check offline answers for pairs of nodes against LCASuffixTree_get_lca. */
+char* check_against_online(char* str, size_t str_len, size_t num_pairs)
+{
+  LCASuffixTree_T lca_tree = LCASuffixTree_create(str, str_len);
+  SuffixTree_T tree = SuffixTree_create(str, str_len);
+  mu_assert(lca_tree && tree, "Failed to create trees.");
+
+  /* Node indices are the same in both trees, since they're built the same way. */
+  Node_T* lca_nodes = SuffixTree_create_node_array((SuffixTree_T)lca_tree);
+  Node_T* nodes = SuffixTree_create_node_array(tree);
+  size_t num_nodes = SuffixTree_get_num_nodes(tree);
+
+  Node_T* pairs = malloc(2 * num_pairs * sizeof(Node_T));
+  Node_T* lcas = malloc(num_pairs * sizeof(Node_T));
+  size_t* indices = malloc(2 * num_pairs * sizeof(size_t));
+  size_t i = 0;
+  for(i = 0; i < 2 * num_pairs; i++) {
+    indices[i] = rand() % num_nodes;
+    /* Some pairs of a node with itself, and some with the root. */
+    if(i % 7 == 1) indices[i] = indices[i - 1];
+    if(i % 11 == 0) indices[i] = Node_get_index(SuffixTree_get_root(tree));
+    pairs[i] = nodes[indices[i]];
+  }
+
+  int rc = OfflineLCA_find(tree, pairs, num_pairs, lcas);
+  mu_assert(rc == 0, "Offline LCA failed.");
+
+  for(i = 0; i < num_pairs; i++) {
+    Node_T expected = LCASuffixTree_get_lca(lca_tree, lca_nodes[indices[2 * i]],
+                                            lca_nodes[indices[2 * i + 1]]);
+    mu_assert(Node_get_index(lcas[i]) == Node_get_index(expected),
+              "Offline LCA of nodes %zu and %zu is %zu, but it should be %zu.",
+              indices[2 * i], indices[2 * i + 1], Node_get_index(lcas[i]),
+              Node_get_index(expected));
+  }
+
+  free(indices);
+  free(lcas);
+  free(pairs);
+  free(nodes);
+  free(lca_nodes);
+  SuffixTree_delete(&tree);
+  LCASuffixTree_delete(&lca_tree);
+  return NULL;
+}
+
+char* test_banana()
+{
+  char str[] = "BANANA";
+  return check_against_online(str, sizeof(str) - 1, 50);
+}
+
+char* test_random()
+{
+  const size_t str_len = 5000;
+  char* str = calloc((str_len + 1), sizeof(char));
+  unsigned int i = 0;
+  char* result = NULL;
+  for(i = 0; i < 5 && !result; i++) {
+    random_string(str, str_len);
+    result = check_against_online(str, str_len, 20000);
+  }
+  free(str);
+  return result;
+}
+
+char* test_no_pairs()
+{
+  char str[] = "BANANA";
+  SuffixTree_T tree = SuffixTree_create(str, sizeof(str) - 1);
+  int rc = OfflineLCA_find(tree, NULL, 0, NULL);
+  mu_assert(rc == 0, "Offline LCA with no pairs failed.");
+  SuffixTree_delete(&tree);
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_banana);
+  mu_run_test(test_random);
+  mu_run_test(test_no_pairs);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
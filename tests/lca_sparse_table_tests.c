@@ -48,12 +48,68 @@ char* test_random_arrays()
   return NULL;
 }
 
+/* Lookups over the whole array used to read past the end of the table when
+ * the array length was a power of two. */
+char* test_power_of_two_arrays()
+{
+  size_t arr_len = 1;
+  for(arr_len = 1; arr_len <= 256; arr_len *= 2) {
+    size_t* arr = calloc(arr_len, sizeof(size_t));
+    random_sizes(arr, arr_len);
+    SparseTable_T sparse_table = SparseTable_create(arr, arr_len);
+    mu_assert(sparse_table, "Failed to create sparse table.");
+    int ret = SparseTable_verify(sparse_table, arr, arr_len);
+    mu_assert(ret == 0, "SparseTable verification failed for length %zu.", arr_len);
+    SparseTable_delete(&sparse_table);
+    mu_assert(sparse_table == NULL, "SparseTable_delete did not clear the pointer.");
+    free(arr);
+  }
+  return NULL;
+}
+
+/* Long arrays have levels with two and four byte entries. Too long to verify
+ * every interval, so check a sample. */
+char* test_long_array()
+{
+  size_t arr_len = 200003;
+  size_t* arr = calloc(arr_len, sizeof(size_t));
+  size_t i = 0;
+  for(i = 0; i < arr_len; i++) {
+    arr[i] = rand();
+  }
+  SparseTable_T sparse_table = SparseTable_create(arr, arr_len);
+  mu_assert(sparse_table, "Failed to create sparse table.");
+
+  for(i = 0; i < 200; i++) {
+    size_t start = rand() % arr_len;
+    size_t end = start + 1 + rand() % (arr_len - start);
+    if(i == 0) {
+      start = 0;
+      end = arr_len;
+    }
+
+    size_t min_pos = start, pos = 0;
+    for(pos = start; pos < end; pos++) {
+      if(arr[pos] <= arr[min_pos]) min_pos = pos;
+    }
+    size_t test_pos = SparseTable_lookup(sparse_table, arr, start, end);
+    mu_assert(test_pos == min_pos, "Min element position in [%zu:%zu] should be "
+              "%zu, but lookup returned %zu.", start, end, min_pos, test_pos);
+  }
+
+  SparseTable_delete(&sparse_table);
+  free(arr);
+  return NULL;
+}
+
 char* all_tests()
 {
   mu_suite_start();  
 
   mu_run_test(test_array);
   mu_run_test(test_random_arrays);
+  mu_run_test(test_power_of_two_arrays);
+  mu_run_test(test_long_array);
 
   return NULL;
 }
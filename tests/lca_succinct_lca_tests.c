@@ -0,0 +1,101 @@
+#include "minunit.h"
+#include "test_utils.h"
+
+#include "lca/lca_suffix_tree.h"
+#include "lca/succinct_lca.h"
+
+/* Check answers for pairs of nodes against LCASuffixTree_get_lca. */
+char* check_against_lca_suffix_tree(char* str, size_t str_len, size_t num_pairs)
+{
+  LCASuffixTree_T lca_tree = LCASuffixTree_create(str, str_len);
+  SuffixTree_T tree = SuffixTree_create(str, str_len);
+  mu_assert(lca_tree && tree, "Failed to create trees.");
+
+  SuccinctLCA_T lca = SuccinctLCA_create(tree);
+  mu_assert(lca, "Failed to create SuccinctLCA_T.");
+  int rc = SuccinctLCA_verify(lca, tree);
+  mu_assert(rc == 0, "SuccinctLCA_T failed verification.");
+
+  /* Node indices are the same in both trees, since they're built the same way. */
+  Node_T* lca_nodes = SuffixTree_create_node_array((SuffixTree_T)lca_tree);
+  Node_T* nodes = SuffixTree_create_node_array(tree);
+  size_t num_nodes = SuffixTree_get_num_nodes(tree);
+
+  size_t i = 0;
+  for(i = 0; i < num_pairs; i++) {
+    size_t index1 = rand() % num_nodes;
+    size_t index2 = rand() % num_nodes;
+    /* Some pairs of a node with itself, and some with the root. */
+    if(i % 7 == 1) index2 = index1;
+    if(i % 11 == 0) index1 = Node_get_index(SuffixTree_get_root(tree));
+
+    Node_T found = SuccinctLCA_get_lca(lca, nodes[index1], nodes[index2]);
+    Node_T expected = LCASuffixTree_get_lca(lca_tree, lca_nodes[index1],
+                                            lca_nodes[index2]);
+    mu_assert(Node_get_index(found) == Node_get_index(expected),
+              "Succinct LCA of nodes %zu and %zu is %zu, but it should be %zu.",
+              index1, index2, Node_get_index(found), Node_get_index(expected));
+  }
+
+  free(nodes);
+  free(lca_nodes);
+  SuccinctLCA_delete(&lca);
+  mu_assert(lca == NULL, "SuccinctLCA_delete did not clear the pointer.");
+  SuffixTree_delete(&tree);
+  LCASuffixTree_delete(&lca_tree);
+  return NULL;
+}
+
+char* test_banana()
+{
+  char str[] = "BANANA";
+  return check_against_lca_suffix_tree(str, sizeof(str) - 1, 100);
+}
+
+char* test_single_character()
+{
+  char str[] = "A";
+  return check_against_lca_suffix_tree(str, sizeof(str) - 1, 10);
+}
+
+char* test_random()
+{
+  const size_t str_len = 5000;
+  char* str = calloc((str_len + 1), sizeof(char));
+  unsigned int i = 0;
+  char* result = NULL;
+  for(i = 0; i < 5 && !result; i++) {
+    random_string(str, str_len);
+    result = check_against_lca_suffix_tree(str, str_len, 20000);
+  }
+  free(str);
+  return result;
+}
+
+char* test_repetitive()
+{
+  /* Deep trees, so queries span many blocks of the tour. */
+  const size_t str_len = 3000;
+  char* str = calloc((str_len + 1), sizeof(char));
+  size_t i = 0;
+  for(i = 0; i < str_len; i++) {
+    str[i] = i % 3 == 2 ? 'B' : 'A';
+  }
+  char* result = check_against_lca_suffix_tree(str, str_len, 20000);
+  free(str);
+  return result;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_banana);
+  mu_run_test(test_single_character);
+  mu_run_test(test_random);
+  mu_run_test(test_repetitive);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -1,24 +1,380 @@
+#include <ctype.h>
+#include <string.h>
+
 #include "minunit.h"
 #include "test_utils.h"
 #include "kolpakov_kucherov/kolpakov_kucherov.h"
 
 
+/*
+ * Check that a reported palindrome really is a gapped palindrome within the
+ * length constraints, that its arms can't be extended outward, and that its
+ * gap can't be shrunk.
+ */
+int verify_gapped_palindrome(const char* str, size_t str_len,
+                             const struct GappedPalindrome* pal,
+                             size_t min_arm_length, size_t min_gap_length,
+                             size_t max_gap_length)
+{
+  size_t gap_length = pal->gap_end - pal->gap_start;
+  if(pal->arm_length < min_arm_length) return 1;
+  if(gap_length < min_gap_length || gap_length > max_gap_length) return 1;
+  if(pal->left_arm_start + pal->arm_length != pal->gap_start) return 1;
+  if(pal->gap_end + pal->arm_length > str_len) return 1;
+
+  size_t i = 0;
+  for(i = 0; i < pal->arm_length; i++) {
+    if(str[pal->gap_start - 1 - i] != str[pal->gap_end + i]) return 1;
+  }
+
+  if(pal->left_arm_start > 0 && pal->gap_end + pal->arm_length < str_len) {
+    if(str[pal->left_arm_start - 1] == str[pal->gap_end + pal->arm_length]) return 1;
+  }
+
+  if(str[pal->gap_start] == str[pal->gap_end - 1]) return 1;
+
+  return 0;
+}
+
+/* A GappedPalindromeFunc_T that appends to a GappedPalindromeArray_T. */
+int collect_func(const struct GappedPalindrome* palindrome, void* vresults)
+{
+  return GappedPalindromeArray_append(vresults, palindrome);
+}
+
+static int equal_chars(char left, char right)
+{
+  return left == right;
+}
+
+/* Order palindromes by gap, for comparing them as sets. */
+static int compare_palindromes(const void* va, const void* vb)
+{
+  const struct GappedPalindrome* a = va;
+  const struct GappedPalindrome* b = vb;
+  if(a->gap_end != b->gap_end) return a->gap_end < b->gap_end ? -1 : 1;
+  if(a->gap_start != b->gap_start) return a->gap_start < b->gap_start ? -1 : 1;
+  return 0;
+}
+
+/*
+ * Find every palindrome the search should report by trying each gap in turn,
+ * with arms paired by pairs, and check that a search under relation reports
+ * exactly those.
+ */
+static char* check_against_brute_force(char* str, size_t str_len,
+                                       size_t min_arm_length, size_t min_gap_length,
+                                       size_t max_gap_length,
+                                       enum PalindromeRelation relation,
+                                       int (*pairs)(char, char))
+{
+  GappedPalindromeArray_T expected = GappedPalindromeArray_create();
+  struct GappedPalindrome pal;
+  size_t gap_start = 0;
+  size_t gap_end = 0;
+  for(gap_end = min_gap_length; gap_end < str_len; gap_end++) {
+    gap_start = gap_end > max_gap_length ? gap_end - max_gap_length : 0;
+    for(; gap_start + min_gap_length <= gap_end; gap_start++) {
+      size_t arm_length = 0;
+      while(arm_length < gap_start && gap_end + arm_length < str_len &&
+            pairs(str[gap_start - 1 - arm_length], str[gap_end + arm_length])) {
+        arm_length++;
+      }
+      if(arm_length < min_arm_length) continue;
+      if(pairs(str[gap_start], str[gap_end - 1])) continue;
+
+      pal.left_arm_start = gap_start - arm_length;
+      pal.gap_start = gap_start;
+      pal.gap_end = gap_end;
+      pal.arm_length = arm_length;
+      mu_assert(GappedPalindromeArray_append(expected, &pal) == 0,
+                "Failed to append palindrome.");
+    }
+  }
+
+  GappedPalindromeArray_T results = GappedPalindromeArray_create();
+  int rc = length_constrained_palindromes_foreach_with_relation(
+      str, str_len, min_arm_length, min_gap_length, max_gap_length, relation,
+      collect_func, results);
+  mu_assert(rc == 0, "Palindrome search failed.");
+
+  qsort(expected->palindromes, expected->length, sizeof(struct GappedPalindrome),
+        compare_palindromes);
+  qsort(results->palindromes, results->length, sizeof(struct GappedPalindrome),
+        compare_palindromes);
+  mu_assert(results->length == expected->length,
+            "Found %zu palindromes with arms %zu, gaps %zu - %zu, but should find %zu.",
+            results->length, min_arm_length, min_gap_length, max_gap_length,
+            expected->length);
+  size_t i = 0;
+  for(i = 0; i < results->length; i++) {
+    struct GappedPalindrome* a = &results->palindromes[i];
+    struct GappedPalindrome* b = &expected->palindromes[i];
+    mu_assert(memcmp(a, b, sizeof(struct GappedPalindrome)) == 0,
+              "Found (%zu, %zu, %zu, %zu), but should find (%zu, %zu, %zu, %zu).",
+              a->left_arm_start, a->gap_start, a->gap_end, a->arm_length,
+              b->left_arm_start, b->gap_start, b->gap_end, b->arm_length);
+  }
+
+  GappedPalindromeArray_delete(&results);
+  GappedPalindromeArray_delete(&expected);
+  return NULL;
+}
+
+/* A GappedPalindromeFunc_T that counts calls and stops after the first. */
+int stop_after_first_func(const struct GappedPalindrome* palindrome, void* vcount)
+{
+  (void)palindrome;
+  size_t* count = vcount;
+  (*count)++;
+  return 1;
+}
+
 char* test_madam_im_adam()
 {
             /*  012345678901234 */
   char str[] = "MADAMIBCDEMADAM";
   size_t str_len = sizeof(str)/sizeof(char);
-  
+
   length_constrained_palindromes(str, str_len - 1, 3, 2, 5);
 
   return NULL;
 }
 
+char* test_madam_im_adam_collect()
+{
+            /*  012345678901234 */
+  char str[] = "MADAMIBCDEMADAM";
+  size_t str_len = sizeof(str) - 1;
+
+  GappedPalindromeArray_T results = GappedPalindromeArray_create();
+  mu_assert(results, "Failed to create GappedPalindromeArray_T.");
+
+  int rc = length_constrained_palindromes_collect(str, str_len, 3, 2, 5, results);
+  mu_assert(rc == 0, "Palindrome collection failed.");
+  mu_assert(results->length == 1, "Expected 1 palindrome but found %zu.",
+            results->length);
+
+  struct GappedPalindrome pal = results->palindromes[0];
+  mu_assert(pal.left_arm_start == 0 && pal.gap_start == 5 &&
+            pal.gap_end == 10 && pal.arm_length == 5,
+            "Incorrect palindrome (%zu, %zu, %zu, %zu).", pal.left_arm_start,
+            pal.gap_start, pal.gap_end, pal.arm_length);
+
+  GappedPalindromeArray_delete(&results);
+  mu_assert(results == NULL, "GappedPalindromeArray_delete did not clear the pointer.");
+
+  return NULL;
+}
+
+char* test_stop_early()
+{
+  char str[] = "MADAMIBCDEMADAM";
+  size_t str_len = sizeof(str) - 1;
+  size_t count = 0;
+
+  int rc = length_constrained_palindromes_foreach(str, str_len, 3, 2, 5,
+                                                  stop_after_first_func, &count);
+  mu_assert(rc == 0, "Stopping the search early should not be an error.");
+  mu_assert(count == 1, "Search continued after the callback stopped it.");
+
+  return NULL;
+}
+
+char* test_every_item_of_a_run()
+{
+  /* The gaps starting at 10 and 12 both end at 17, and both start with a G
+   * after a left arm of "GC", so they are one run in the class of "GC". Each
+   * item of the run must be reported, not just the first. */
+  char str[] = "ACGCCAACGCGCGCAACCGGTTAGC";
+  size_t str_len = sizeof(str) - 1;
+
+  GappedPalindromeArray_T results = GappedPalindromeArray_create();
+  int rc = length_constrained_palindromes_collect(str, str_len, 2, 2, 7, results);
+  mu_assert(rc == 0, "Palindrome collection failed.");
+  size_t found = 0;
+  size_t i = 0;
+  for(i = 0; i < results->length; i++) {
+    struct GappedPalindrome* pal = &results->palindromes[i];
+    if(pal->gap_start == 12 && pal->gap_end == 17 && pal->arm_length == 2) found = 1;
+  }
+  mu_assert(found, "Missed the palindrome with gap 12 - 17.");
+  GappedPalindromeArray_delete(&results);
+
+  return check_against_brute_force(str, str_len, 2, 2, 7, RELATION_EXACT,
+                                   equal_chars);
+}
+
+char* test_random_collect()
+{
+  const size_t str_len = 2000;
+  char* str = malloc(str_len * sizeof(char));
+  unsigned int i = 0;
+
+  for(i = 0; i < 5; i++) {
+    random_string(str, str_len);
+
+    GappedPalindromeArray_T results = GappedPalindromeArray_create();
+    int rc = length_constrained_palindromes_collect(str, str_len, 4, 1, 20, results);
+    mu_assert(rc == 0, "Palindrome collection failed on random string.");
+
+    size_t j = 0;
+    for(j = 0; j < results->length; j++) {
+      rc = verify_gapped_palindrome(str, str_len, &results->palindromes[j], 4, 1, 20);
+      mu_assert(rc == 0, "Invalid palindrome (%zu, %zu, %zu, %zu).",
+                results->palindromes[j].left_arm_start,
+                results->palindromes[j].gap_start,
+                results->palindromes[j].gap_end,
+                results->palindromes[j].arm_length);
+    }
+    GappedPalindromeArray_delete(&results);
+  }
+
+  /* On short strings, check that nothing is missed either. */
+  char* result = NULL;
+  for(i = 0; i < 500 && !result; i++) {
+    size_t length = 1 + rand() % 100;
+    size_t min_arm_length = 1 + rand() % 4;
+    size_t min_gap_length = rand() % 6;
+    size_t max_gap_length = min_gap_length + rand() % 16;
+    random_string(str, length);
+    result = check_against_brute_force(str, length, min_arm_length, min_gap_length,
+                                       max_gap_length, RELATION_EXACT, equal_chars);
+  }
+  free(str);
+
+  return result;
+}
+
+static int complementary(char left, char right)
+{
+  return (left == 'A' && right == 'T') || (left == 'T' && right == 'A') ||
+         (left == 'C' && right == 'G') || (left == 'G' && right == 'C') ||
+         (left == 'a' && right == 't') || (left == 't' && right == 'a') ||
+         (left == 'c' && right == 'g') || (left == 'g' && right == 'c');
+}
+
+static int same_letter(char left, char right)
+{
+  return tolower((unsigned char)left) == tolower((unsigned char)right);
+}
+
+/* Check inverted repeats from a RELATION_REVERSE_COMPLEMENT search of str. */
+static char* check_inverted_repeats(char* str, size_t str_len)
+{
+  GappedPalindromeArray_T results = GappedPalindromeArray_create();
+  int rc = length_constrained_palindromes_foreach_with_relation(
+      str, str_len, 4, 1, 20, RELATION_REVERSE_COMPLEMENT, collect_func, results);
+  mu_assert(rc == 0, "Reverse complement search failed.");
+  mu_assert(results->length > 0, "Found no inverted repeats.");
+
+  size_t i = 0;
+  for(i = 0; i < results->length; i++) {
+    struct GappedPalindrome* pal = &results->palindromes[i];
+    size_t gap_length = pal->gap_end - pal->gap_start;
+    size_t k = 0;
+    mu_assert(pal->arm_length >= 4 && gap_length >= 1 && gap_length <= 20 &&
+              pal->left_arm_start + pal->arm_length == pal->gap_start &&
+              pal->gap_end + pal->arm_length <= str_len,
+              "Inverted repeat %zu breaks the length constraints.", i);
+    for(k = 0; k < pal->arm_length; k++) {
+      mu_assert(complementary(str[pal->gap_start - 1 - k], str[pal->gap_end + k]),
+                "Inverted repeat %zu has arms that don't pair.", i);
+    }
+    mu_assert(pal->left_arm_start == 0 || pal->gap_end + pal->arm_length == str_len ||
+              !complementary(str[pal->left_arm_start - 1],
+                             str[pal->gap_end + pal->arm_length]),
+              "Inverted repeat %zu could be extended.", i);
+    mu_assert(!complementary(str[pal->gap_start], str[pal->gap_end - 1]),
+              "Inverted repeat %zu could have a shorter gap.", i);
+  }
+  GappedPalindromeArray_delete(&results);
+
+  return NULL;
+}
+
+char* test_relations()
+{
+  const size_t str_len = 2000;
+  char* str = malloc(str_len * sizeof(char));
+  char* upper = malloc(str_len * sizeof(char));
+  size_t i = 0;
+
+  /* Case-insensitive palindromes are exact palindromes of the upper case. */
+  random_string(str, str_len);
+  for(i = 0; i < str_len; i++) {
+    upper[i] = str[i];
+    if(rand() % 2) str[i] = tolower(str[i]);
+  }
+  GappedPalindromeArray_T expected = GappedPalindromeArray_create();
+  int rc = length_constrained_palindromes_collect(upper, str_len, 4, 1, 20, expected);
+  mu_assert(rc == 0, "Palindrome collection failed.");
+  GappedPalindromeArray_T results = GappedPalindromeArray_create();
+  rc = length_constrained_palindromes_foreach_with_relation(
+      str, str_len, 4, 1, 20, RELATION_CASE_INSENSITIVE, collect_func, results);
+  mu_assert(rc == 0, "Case-insensitive search failed.");
+  mu_assert(results->length == expected->length && results->length > 0 &&
+            memcmp(results->palindromes, expected->palindromes,
+                   results->length * sizeof(struct GappedPalindrome)) == 0,
+            "Case-insensitive search found %zu palindromes, but should find %zu.",
+            results->length, expected->length);
+  GappedPalindromeArray_delete(&results);
+  GappedPalindromeArray_delete(&expected);
+
+  /* Inverted repeats pair each base of the left arm with its complement. */
+  random_string(str, str_len);
+  char* result = check_inverted_repeats(str, str_len);
+
+  /* With every byte value in the string, nothing is free to mark unpaired
+   * characters, and both arms are mapped. */
+  for(i = 0; i < 256 && !result; i++) str[i * 7] = (char)i;
+  if(!result) result = check_inverted_repeats(str, str_len);
+
+  /* On short strings, check that neither relation misses anything. Mixed
+   * case leaves some bases unpaired under RELATION_REVERSE_COMPLEMENT. */
+  size_t round = 0;
+  for(round = 0; round < 300 && !result; round++) {
+    size_t length = 1 + rand() % 100;
+    size_t min_arm_length = 1 + rand() % 4;
+    size_t min_gap_length = rand() % 6;
+    size_t max_gap_length = min_gap_length + rand() % 16;
+    random_string(str, length);
+    for(i = 0; i < length; i++) {
+      if(rand() % 4 == 0) str[i] = tolower(str[i]);
+    }
+    result = check_against_brute_force(str, length, min_arm_length, min_gap_length,
+                                       max_gap_length, RELATION_CASE_INSENSITIVE,
+                                       same_letter);
+    if(!result) {
+      result = check_against_brute_force(str, length, min_arm_length,
+                                         min_gap_length, max_gap_length,
+                                         RELATION_REVERSE_COMPLEMENT, complementary);
+    }
+  }
+
+  /* With every byte value in the string, both arms are mapped. */
+  random_string(str, 400);
+  for(i = 0; i < 256; i++) str[i + 100] = (char)i;
+  if(!result) {
+    result = check_against_brute_force(str, 400, 2, 0, 12,
+                                       RELATION_REVERSE_COMPLEMENT, complementary);
+  }
+
+  free(upper);
+  free(str);
+  return result;
+}
+
 char* all_tests()
 {
   mu_suite_start();
-  
+
   mu_run_test(test_madam_im_adam);
+  mu_run_test(test_madam_im_adam_collect);
+  mu_run_test(test_stop_early);
+  mu_run_test(test_every_item_of_a_run);
+  mu_run_test(test_random_collect);
+  mu_run_test(test_relations);
   return NULL;
 }
 
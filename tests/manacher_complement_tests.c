@@ -0,0 +1,142 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "manacher/manacher_complement.h"
+
+static char complement(char c)
+{
+  switch(c) {
+    case 'A': return 'T';
+    case 'C': return 'G';
+    case 'G': return 'C';
+    case 'T': return 'A';
+    case 'a': return 't';
+    case 'c': return 'g';
+    case 'g': return 'c';
+    case 't': return 'a';
+    default: return 0;
+  }
+}
+
+/* Check manacher_complement against extending each center a pair at a time. */
+char* check_against_brute_force(char* str, size_t str_len)
+{
+  size_t* radii = manacher_complement(str, str_len);
+  mu_assert(radii, "manacher_complement failed.");
+
+  size_t pos = 0;
+  for(pos = 0; pos <= str_len; pos++) {
+    size_t radius = 0;
+    while(radius < pos && pos + radius < str_len &&
+          complement(str[pos - radius - 1]) != 0 &&
+          complement(str[pos - radius - 1]) == str[pos + radius]) {
+      radius++;
+    }
+    mu_assert(radii[pos] == radius, "Radius at %zu is %zu, but should be %zu.",
+              pos, radii[pos], radius);
+  }
+
+  int rc = verify_complement_radii(str, str_len, radii);
+  mu_assert(rc == 0, "Failed verification.");
+
+  free(radii);
+  return NULL;
+}
+
+char* test_inverted_repeat()
+{
+  char str[] = "ACCTAGGT";
+  size_t str_len = sizeof(str) - 1;
+  size_t* radii = manacher_complement(str, str_len);
+  mu_assert(radii[4] == 4, "Failed to find the whole ACCTAGGT palindrome.");
+  free(radii);
+
+  /* AT is its own reverse complement, but AA is not. */
+  char mixed[] = "GGATccTTAAnnacgu";
+  return check_against_brute_force(mixed, sizeof(mixed) - 1);
+}
+
+char* test_short()
+{
+  char empty[] = "";
+  char single[] = "A";
+  char pair[] = "CG";
+  char* result = check_against_brute_force(empty, 0);
+  if(!result) result = check_against_brute_force(single, 1);
+  if(!result) result = check_against_brute_force(pair, 2);
+  return result;
+}
+
+/* Nothing pairs with a '\0', which a mapped file can hold. */
+char* test_nul_bytes()
+{
+  char str[100];
+  memset(str, 'N', 40);
+  memset(str + 40, '\0', 40);
+  memcpy(str + 80, "ACGTTAGCAT\0\0\0\0\0AACGTTACGT", 20);
+
+  size_t* radii = manacher_complement(str, sizeof(str));
+  mu_assert(radii[40] == 0, "N paired with a NUL byte.");
+  free(radii);
+
+  return check_against_brute_force(str, sizeof(str));
+}
+
+char* test_verification()
+{
+  char str[] = "ACCTAGGT";
+  size_t str_len = sizeof(str) - 1;
+  size_t radii[] = {0, 0, 0, 0, 4, 0, 0, 0, 0};
+  int rc = verify_complement_radii(str, str_len, radii);
+  mu_assert(rc == 0, "Failed verification for correct radii.");
+
+  radii[4] = 3;
+  fprintf(stderr, "Expect a warning about a non-maximal palindrome here:\n");
+  rc = verify_complement_radii(str, str_len, radii);
+  mu_assert(rc == 1, "Verification passed a palindrome that isn't maximal.");
+
+  radii[4] = 0;
+  radii[2] = 1;
+  fprintf(stderr, "Expect a warning about a failed comparison here:\n");
+  rc = verify_complement_radii(str, str_len, radii);
+  mu_assert(rc == 1, "Verification passed a palindrome that isn't one.");
+  return NULL;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 5000;
+  char* str = malloc(str_len * sizeof(char));
+  size_t i = 0;
+  char* result = NULL;
+
+  for(i = 0; i < 5 && !result; i++) {
+    random_string(str, str_len);
+    result = check_against_brute_force(str, str_len);
+  }
+
+  /* Long inverted repeats, some broken by an N. */
+  for(i = 0; i + 400 <= str_len && !result; i += 400) {
+    size_t j = 0;
+    for(j = 0; j < 150; j++) str[i + 200 + j] = complement(str[i + 199 - j]);
+    if(i % 800 == 0) str[i + 200 + rand() % 150] = 'N';
+  }
+  if(!result) result = check_against_brute_force(str, str_len);
+
+  free(str);
+  return result;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_inverted_repeat);
+  mu_run_test(test_short);
+  mu_run_test(test_nul_bytes);
+  mu_run_test(test_verification);
+  mu_run_test(test_random_strings);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -0,0 +1,70 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "manacher/manacher.h"
+#include "manacher/manacher_packed.h"
+
+/* Check that manacher_packed gives the same radii as manacher. */
+char* check_against_manacher(char* str, size_t str_len)
+{
+  PackedSequence_T sequence = PackedSequence_create(str, str_len);
+  mu_assert(sequence, "Failed to create packed sequence.");
+  size_t* expected = manacher(str, str_len);
+  size_t* radii = manacher_packed(sequence);
+  mu_assert(expected && radii, "Failed to compute radii.");
+
+  size_t i = 0;
+  for(i = 0; i < 2 * str_len + 1; i++) {
+    mu_assert(radii[i] == expected[i], "Radius at %zu is %zu, but should be %zu.",
+              i, radii[i], expected[i]);
+  }
+
+  free(radii);
+  free(expected);
+  PackedSequence_delete(&sequence);
+  return NULL;
+}
+
+char* test_short()
+{
+  char empty[] = "";
+  char single[] = "A";
+  char str[] = "GATTACANNACATTAG";
+  char* result = check_against_manacher(empty, 0);
+  if(!result) result = check_against_manacher(single, 1);
+  if(!result) result = check_against_manacher(str, sizeof(str) - 1);
+  return result;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 20000;
+  char* str = malloc(str_len * sizeof(char));
+  size_t i = 0;
+  char* result = NULL;
+
+  random_string(str, str_len);
+  result = check_against_manacher(str, str_len);
+
+  /* Long runs and alternations, with Ns, make arms run over many words. */
+  for(i = 0; i < str_len; i++) {
+    if((i / 500) % 3 == 0) str[i] = 'A';
+    else if((i / 500) % 3 == 1) str[i] = i % 2 ? 'C' : 'G';
+    if(rand() % 1000 == 0) str[i] = 'N';
+  }
+  if(!result) result = check_against_manacher(str, str_len);
+
+  free(str);
+  return result;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_short);
+  mu_run_test(test_random_strings);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -0,0 +1,118 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "manacher/manacher.h"
+#include "manacher/palindrome_radii.h"
+
+/* Check narrow radii against manacher, and verify them. */
+char* check_against_manacher(char* str, size_t str_len, enum RadiusWidth width)
+{
+  size_t* expected = manacher(str, str_len);
+  PalindromeRadii_T radii = manacher_narrow(str, str_len, width);
+  mu_assert(expected && radii, "Failed to compute radii.");
+  mu_assert(PalindromeRadii_get_length(radii) == 2 * str_len + 1,
+            "Wrong number of radii.");
+
+  size_t i = 0;
+  for(i = 0; i < 2 * str_len + 1; i++) {
+    mu_assert(PalindromeRadii_get(radii, i) == expected[i],
+              "%d-bit radius at %zu is %zu, but should be %zu.", width, i,
+              PalindromeRadii_get(radii, i), expected[i]);
+  }
+
+  int rc = verify_palindrome_radii_narrow(str, str_len, radii);
+  mu_assert(rc == 0, "Failed verification of %d-bit radii.", width);
+
+  char* longest = longest_palindrome(str, str_len, expected);
+  char* longest_narrow = longest_palindrome_narrow(str, str_len, radii);
+  mu_assert(strcmp(longest, longest_narrow) == 0,
+            "Longest palindromes differ for %d-bit radii.", width);
+
+  free(longest);
+  free(longest_narrow);
+  PalindromeRadii_delete(&radii);
+  mu_assert(radii == NULL, "PalindromeRadii_delete did not clear the pointer.");
+  free(expected);
+  return NULL;
+}
+
+char* test_panama()
+{
+  char str[] = "AMANAPLANACANALPANAMA";
+  size_t str_len = sizeof(str) - 1;
+  char* result = check_against_manacher(str, str_len, RADIUS_WIDTH_16);
+  if(!result) result = check_against_manacher(str, str_len, RADIUS_WIDTH_32);
+  return result;
+}
+
+char* test_empty()
+{
+  char str[] = "";
+  char* result = check_against_manacher(str, 0, RADIUS_WIDTH_16);
+  if(!result) result = check_against_manacher(str, 0, RADIUS_WIDTH_32);
+  return result;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 200000;
+  char* str = malloc(str_len * sizeof(char));
+  unsigned int i = 0;
+  char* result = NULL;
+
+  for(i = 0; i < 5 && !result; i++) {
+    random_string(str, str_len);
+    result = check_against_manacher(str, str_len, RADIUS_WIDTH_16);
+    if(!result) result = check_against_manacher(str, str_len, RADIUS_WIDTH_32);
+  }
+
+  free(str);
+  return result;
+}
+
+char* test_overflow()
+{
+  /* A run long enough that many radii don't fit in 16 bits. */
+  const size_t str_len = 150000;
+  char* str = malloc(str_len * sizeof(char));
+  memset(str, 'T', str_len);
+  str[str_len / 10] = 'A';
+
+  PalindromeRadii_T radii = manacher_narrow(str, str_len, RADIUS_WIDTH_16);
+  mu_assert(radii, "Failed to compute radii.");
+  mu_assert(PalindromeRadii_get_num_overflows(radii) > 0,
+            "No 16-bit radii overflowed.");
+  PalindromeRadii_delete(&radii);
+
+  radii = manacher_narrow(str, str_len, RADIUS_WIDTH_32);
+  mu_assert(radii, "Failed to compute radii.");
+  mu_assert(PalindromeRadii_get_num_overflows(radii) == 0,
+            "32-bit radii overflowed.");
+  PalindromeRadii_delete(&radii);
+
+  char* result = check_against_manacher(str, str_len, RADIUS_WIDTH_16);
+  free(str);
+  return result;
+}
+
+char* test_bad_width()
+{
+  char str[] = "BANANA";
+  PalindromeRadii_T radii = manacher_narrow(str, sizeof(str) - 1, 8);
+  mu_assert(radii == NULL, "Created radii 8 bits wide.");
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_panama);
+  mu_run_test(test_empty);
+  mu_run_test(test_random_strings);
+  mu_run_test(test_overflow);
+  mu_run_test(test_bad_width);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
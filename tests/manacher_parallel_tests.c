@@ -0,0 +1,108 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "manacher/manacher.h"
+#include "manacher/manacher_parallel.h"
+
+/* Check that manacher_parallel gives the same radii as manacher. */
+char* check_against_manacher(char* str, size_t str_len, unsigned int num_threads)
+{
+  size_t* expected = manacher(str, str_len);
+  size_t* radii = manacher_parallel(str, str_len, num_threads);
+  mu_assert(expected && radii, "Failed to compute radii.");
+
+  size_t i = 0;
+  for(i = 0; i < 2 * str_len + 1; i++) {
+    mu_assert(radii[i] == expected[i],
+              "With %u threads, radius at %zu is %zu, but should be %zu.",
+              num_threads, i, radii[i], expected[i]);
+  }
+
+  free(radii);
+  free(expected);
+  return NULL;
+}
+
+char* check_thread_counts(char* str, size_t str_len)
+{
+  unsigned int num_threads[] = {0, 1, 2, 3, 4, 7, 16, 64};
+  size_t i = 0;
+  char* result = NULL;
+  for(i = 0; i < sizeof(num_threads) / sizeof(num_threads[0]) && !result; i++) {
+    result = check_against_manacher(str, str_len, num_threads[i]);
+  }
+  return result;
+}
+
+char* test_panama()
+{
+  char str[] = "AMANAPLANACANALPANAMA";
+  return check_thread_counts(str, sizeof(str) - 1);
+}
+
+char* test_short()
+{
+  char empty[] = "";
+  char single[] = "A";
+  char* result = check_thread_counts(empty, 0);
+  if(!result) result = check_thread_counts(single, 1);
+  return result;
+}
+
+char* test_runs()
+{
+  /* Palindromes that cross every segment boundary. */
+  const size_t str_len = 5000;
+  char* str = malloc(str_len * sizeof(char));
+  size_t i = 0;
+
+  memset(str, 'T', str_len);
+  char* result = check_thread_counts(str, str_len);
+
+  for(i = 0; i < str_len; i++) {
+    str[i] = i % 2 ? 'A' : 'T';
+  }
+  if(!result) result = check_thread_counts(str, str_len);
+
+  for(i = 0; i < str_len; i++) {
+    str[i] = "ACGT"[(i / 250) % 4];
+  }
+  if(!result) result = check_thread_counts(str, str_len);
+
+  free(str);
+  return result;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 200000;
+  char* str = malloc(str_len * sizeof(char));
+  unsigned int i = 0;
+  char* result = NULL;
+
+  for(i = 0; i < 5 && !result; i++) {
+    random_string(str, str_len);
+    /* A long palindrome around the middle. */
+    size_t j = 0;
+    for(j = 0; j < 3000; j++) {
+      str[str_len / 2 + j] = str[str_len / 2 - 1 - j];
+    }
+    result = check_thread_counts(str, str_len);
+  }
+
+  free(str);
+  return result;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_panama);
+  mu_run_test(test_short);
+  mu_run_test(test_runs);
+  mu_run_test(test_random_strings);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -0,0 +1,172 @@
+#include <stdint.h>
+
+#include "minunit.h"
+#include "test_utils.h"
+#include "manacher/manacher.h"
+#include "manacher/manacher_stream.h"
+
+#define MIN(A, B) ((A) < (B) ? A : B)
+
+/* Hands out a string a few characters at a time, never more than asked. */
+struct StringReader {
+  const char* str;
+  size_t      str_len;
+  size_t      position;
+};
+
+size_t read_string(char* buffer, size_t length, void* data)
+{
+  struct StringReader* reader = data;
+  size_t num_read = rand() % 50 + 1;
+  num_read = MIN(num_read, length);
+  num_read = MIN(num_read, reader->str_len - reader->position);
+  memcpy(buffer, reader->str + reader->position, num_read);
+  reader->position += num_read;
+  return num_read;
+}
+
+struct Collected {
+  struct MaximalPalindrome* palindromes;
+  size_t                    length;
+  size_t                    stop_after;
+};
+
+int collect_palindrome(const struct MaximalPalindrome* palindrome, void* data)
+{
+  struct Collected* collected = data;
+  collected->palindromes[collected->length++] = *palindrome;
+  return collected->length == collected->stop_after;
+}
+
+/*
+ * Stream str through manacher_stream and check that it reports exactly the
+ * palindromes that manacher finds, with radii capped at max_arm_length.
+ */
+char* check_against_manacher(char* str, size_t str_len, size_t chunk_length,
+                             size_t max_arm_length, size_t min_length)
+{
+  size_t* radii = manacher(str, str_len);
+  mu_assert(radii, "manacher failed.");
+
+  struct StringReader reader = {str, str_len, 0};
+  struct Collected collected = {NULL, 0, 0};
+  collected.palindromes = malloc((2 * str_len + 1) * sizeof(struct MaximalPalindrome));
+  int rc = manacher_stream(read_string, &reader, chunk_length, max_arm_length,
+                           min_length, collect_palindrome, &collected);
+  mu_assert(rc == 0, "manacher_stream failed.");
+
+  size_t found = 0;
+  size_t pos = 0;
+  for(pos = 1; pos < 2 * str_len; pos++) {
+    size_t radius = MIN(radii[pos], max_arm_length);
+    size_t length = pos % 2 == 1 ? 2 * radius + 1 : 2 * radius;
+    if(length == 0 || length < min_length) continue;
+
+    mu_assert(found < collected.length, "Missing palindrome at center %zu.", pos);
+    struct MaximalPalindrome* palindrome = &collected.palindromes[found++];
+    mu_assert(palindrome->start == pos / 2 - radius && palindrome->length == length,
+              "Palindrome at center %zu is %zu long from %zu, but should be "
+              "%zu long from %zu.", pos, palindrome->length, palindrome->start,
+              length, pos / 2 - radius);
+    int truncated = radii[pos] >= max_arm_length && pos / 2 > radius;
+    mu_assert(palindrome->truncated == truncated,
+              "Palindrome at center %zu should%s be truncated.", pos,
+              truncated ? "" : " not");
+  }
+  mu_assert(found == collected.length, "Found %zu palindromes, expected %zu.",
+            collected.length, found);
+
+  free(collected.palindromes);
+  free(radii);
+  return NULL;
+}
+
+char* test_panama()
+{
+  char str[] = "AMANAPLANACANALPANAMA";
+  size_t str_len = sizeof(str) - 1;
+  char* result = check_against_manacher(str, str_len, 4, str_len, 0);
+  if(!result) result = check_against_manacher(str, str_len, 1, 3, 3);
+  return result;
+}
+
+char* test_empty()
+{
+  char str[] = "";
+  return check_against_manacher(str, 0, 16, 8, 0);
+}
+
+char* test_run()
+{
+  /* Every center of a run reaches an end of it, so many are truncated. */
+  char str[] = "TTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTT";
+  size_t str_len = sizeof(str) - 1;
+  char* result = check_against_manacher(str, str_len, 7, str_len, 0);
+  if(!result) result = check_against_manacher(str, str_len, 7, 5, 0);
+  if(!result) result = check_against_manacher(str, str_len, 3, 0, 0);
+  return result;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 100000;
+  char* str = malloc(str_len * sizeof(char));
+  unsigned int i = 0;
+  char* result = NULL;
+
+  for(i = 0; i < 10 && !result; i++) {
+    random_string(str, str_len);
+    /* Long low-complexity stretches make palindromes longer than the arms. */
+    memset(str + i * 1000, 'A', 300 + i * 10);
+    result = check_against_manacher(str, str_len, 1 + rand() % 200,
+                                    rand() % 40, rand() % 12);
+  }
+  if(!result) result = check_against_manacher(str, str_len, 1000, str_len, 0);
+
+  free(str);
+  return result;
+}
+
+char* test_stop()
+{
+  char str[] = "ABBABBABBA";
+  size_t str_len = sizeof(str) - 1;
+  struct StringReader reader = {str, str_len, 0};
+  struct MaximalPalindrome palindromes[21];
+  struct Collected collected = {palindromes, 0, 3};
+
+  int rc = manacher_stream(read_string, &reader, 4, 10, 2, collect_palindrome,
+                           &collected);
+  mu_assert(rc == 0, "manacher_stream failed.");
+  mu_assert(collected.length == 3, "Search did not stop after 3 palindromes.");
+  mu_assert(palindromes[0].start == 0 && palindromes[0].length == 4,
+            "First palindrome should be ABBA.");
+
+  rc = manacher_stream(read_string, &reader, 0, 10, 2, collect_palindrome,
+                       &collected);
+  mu_assert(rc == 1, "manacher_stream accepted an empty chunk.");
+
+  rc = manacher_stream(read_string, &reader, 4, SIZE_MAX, 2, collect_palindrome,
+                       &collected);
+  mu_assert(rc == 1, "manacher_stream accepted an unbounded arm length.");
+  rc = manacher_stream(read_string, &reader, SIZE_MAX - 8, 1, 2, collect_palindrome,
+                       &collected);
+  mu_assert(rc == 1, "manacher_stream accepted a chunk that overflows the window.");
+
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_panama);
+  mu_run_test(test_empty);
+  mu_run_test(test_run);
+  mu_run_test(test_random_strings);
+  mu_run_test(test_stop);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -1,6 +1,9 @@
+#include <ctype.h>
+
 #include "minunit.h"
 #include "test_utils.h"
 #include "manacher/manacher.h"
+#include "manacher/manacher_complement.h"
 
 char* test_panama()
 {
@@ -109,6 +112,129 @@ char* test_random_strings()
   return NULL;
 }
     
+char* test_long_arms()
+{
+  /* Palindromes whose arms stop at every offset within and between the wide
+   * comparisons, and that run into either end of the string. */
+  const size_t str_len = 400;
+  char* str = malloc(str_len * sizeof(char));
+  size_t arm = 0;
+
+  for(arm = 0; arm < 150; arm++) {
+    random_string(str, str_len);
+    size_t center = str_len / 2 + arm % 7;
+    size_t j = 0;
+    for(j = 0; j < arm && j < center; j++) {
+      str[center + j] = str[center - 1 - j];
+    }
+    size_t* radii = manacher(str, str_len);
+    int rc = verify_palindrome_radii(str, str_len, radii);
+    mu_assert(rc == 0, "Failed verification with an arm of %zu.", arm);
+    mu_assert(radii[2 * center] >= arm, "Missed an arm of %zu.", arm);
+    free(radii);
+  }
+
+  memset(str, 'A', str_len);
+  for(arm = 0; arm < str_len; arm += 37) {
+    str[arm] = 'C';
+    size_t* radii = manacher(str, str_len);
+    int rc = verify_palindrome_radii(str, str_len, radii);
+    mu_assert(rc == 0, "Failed verification of a run broken at %zu.", arm);
+    free(radii);
+  }
+
+  free(str);
+  return NULL;
+}
+
+/* Whether left and right pair under relation, written out case by case. */
+int pairs_under(enum PalindromeRelation relation, char left, char right)
+{
+  switch(relation) {
+    case RELATION_CASE_INSENSITIVE:
+      return tolower(left) == tolower(right);
+    case RELATION_REVERSE_COMPLEMENT:
+      return (left == 'A' && right == 'T') || (left == 'T' && right == 'A') ||
+             (left == 'C' && right == 'G') || (left == 'G' && right == 'C') ||
+             (left == 'a' && right == 't') || (left == 't' && right == 'a') ||
+             (left == 'c' && right == 'g') || (left == 'g' && right == 'c');
+    default:
+      return left == right;
+  }
+}
+
+char* check_relation(char* str, size_t str_len, enum PalindromeRelation relation)
+{
+  size_t* radii = manacher_with_relation(str, str_len, relation);
+  mu_assert(radii, "manacher_with_relation failed.");
+
+  size_t pos = 0;
+  for(pos = 0; pos < 2 * str_len + 1; pos++) {
+    size_t radius = 0;
+    if(pos % 2 == 0 || relation != RELATION_REVERSE_COMPLEMENT) {
+      while(pos / 2 > radius && (pos + 1) / 2 + radius < str_len &&
+            pairs_under(relation, str[pos / 2 - radius - 1], str[(pos + 1) / 2 + radius])) {
+        radius++;
+      }
+    }
+    mu_assert(radii[pos] == radius, "Under relation %d, radius at %zu is %zu, not %zu.",
+              relation, pos, radii[pos], radius);
+  }
+
+  free(radii);
+  return NULL;
+}
+
+char* test_relations()
+{
+  const size_t str_len = 5000;
+  char* str = malloc(str_len * sizeof(char));
+  static const char letters[] = "ACGTacgtN";
+  enum PalindromeRelation relations[] = {RELATION_EXACT, RELATION_CASE_INSENSITIVE,
+                                         RELATION_REVERSE_COMPLEMENT};
+  size_t i = 0;
+  char* result = NULL;
+
+  for(i = 0; i < str_len; i++) str[i] = letters[rand() % (sizeof(letters) - 1)];
+  /* Long arms for each relation */
+  for(i = 100; i + 100 < str_len; i += 500) {
+    size_t j = 0;
+    for(j = 0; j < 80; j++) str[i + j] = toupper(str[i - 1 - j]);
+  }
+  for(i = 0; i < 3 && !result; i++) {
+    result = check_relation(str, str_len, relations[i]);
+  }
+
+  char inverted_repeat[] = "ACCTAGGT";
+  size_t* radii = manacher_with_relation(inverted_repeat, 8, RELATION_REVERSE_COMPLEMENT);
+  mu_assert(radii[8] == 4, "Failed to find the whole ACCTAGGT palindrome.");
+  free(radii);
+
+  /* The reverse complement relation is manacher_complement at even centers. */
+  str[10] = '\0';
+  radii = manacher_with_relation(str, str_len, RELATION_REVERSE_COMPLEMENT);
+  size_t* complement_radii = manacher_complement(str, str_len);
+  for(i = 0; i <= str_len; i++) {
+    mu_assert(radii[2 * i] == complement_radii[i] &&
+              (i == str_len || radii[2 * i + 1] == 0),
+              "RELATION_REVERSE_COMPLEMENT differs from manacher_complement at %zu.",
+              i);
+  }
+  free(complement_radii);
+  free(radii);
+
+  /* The exact relation is manacher. */
+  size_t* expected = manacher(str, str_len);
+  radii = manacher_with_relation(str, str_len, RELATION_EXACT);
+  mu_assert(memcmp(radii, expected, (2 * str_len + 1) * sizeof(size_t)) == 0,
+            "RELATION_EXACT should match manacher.");
+  free(radii);
+  free(expected);
+
+  free(str);
+  return result;
+}
+
 char* all_tests()
 {
   mu_suite_start();
@@ -118,6 +244,8 @@ char* all_tests()
   mu_run_test(test_empty);
   mu_run_test(test_verification);
   mu_run_test(test_random_strings);
+  mu_run_test(test_long_arms);
+  mu_run_test(test_relations);
 
   return NULL;
 }
@@ -0,0 +1,139 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "packed/packed_sequence.h"
+
+/* The base PackedSequence_T should store for a character. */
+static char normalized(char c)
+{
+  switch(c) {
+    case 'A': case 'a': return 'A';
+    case 'C': case 'c': return 'C';
+    case 'G': case 'g': return 'G';
+    case 'T': case 't': return 'T';
+    default: return 'N';
+  }
+}
+
+/* A random string with some runs repeated and some Ns. */
+static void repetitive_string(char* str, size_t str_len)
+{
+  random_string(str, str_len);
+  size_t i = 0;
+  for(i = 0; i + 200 < str_len; i += 200) {
+    memcpy(str + i + 100, str + i, 30 + rand() % 70);
+    if(rand() % 2) str[i + rand() % 200] = 'N';
+  }
+}
+
+char* test_get()
+{
+  char str[] = "ACGTacgtNnRX-ACGTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTG";
+  size_t str_len = sizeof(str) - 1;
+  PackedSequence_T sequence = PackedSequence_create(str, str_len);
+  mu_assert(sequence, "Failed to create packed sequence.");
+  mu_assert(PackedSequence_get_length(sequence) == str_len, "Wrong length.");
+
+  size_t i = 0;
+  for(i = 0; i < str_len; i++) {
+    mu_assert(PackedSequence_get(sequence, i) == normalized(str[i]),
+              "Base %zu is %c, but should be %c.", i, PackedSequence_get(sequence, i),
+              normalized(str[i]));
+  }
+
+  PackedSequence_delete(&sequence);
+  mu_assert(sequence == NULL, "Delete should NULL the pointer.");
+
+  sequence = PackedSequence_create(str, 0);
+  mu_assert(sequence && PackedSequence_get_length(sequence) == 0,
+            "Failed to create empty packed sequence.");
+  PackedSequence_delete(&sequence);
+  return NULL;
+}
+
+char* test_size()
+{
+  const size_t str_len = 100000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+  PackedSequence_T sequence = PackedSequence_create(str, str_len);
+  size_t size = PackedSequence_get_size(sequence);
+  mu_assert(size < str_len * 3 / 8 + 100, "Packed sequence takes %zu bytes.", size);
+  PackedSequence_delete(&sequence);
+  free(str);
+  return NULL;
+}
+
+char* test_lce()
+{
+  const size_t str_len = 3000;
+  char* str = malloc(str_len * sizeof(char));
+  repetitive_string(str, str_len);
+  PackedSequence_T sequence = PackedSequence_create(str, str_len);
+
+  size_t i = 0;
+  for(i = 0; i < 20000; i++) {
+    size_t pos1 = rand() % str_len;
+    size_t pos2 = rand() % 2 ? pos1 + 100 : rand() % str_len;
+    if(pos2 >= str_len) pos2 = pos1;
+    size_t expected = 0;
+    while(pos1 + expected < str_len && pos2 + expected < str_len &&
+          normalized(str[pos1 + expected]) == normalized(str[pos2 + expected])) {
+      expected++;
+    }
+    size_t lce = PackedSequence_lce(sequence, pos1, pos2);
+    mu_assert(lce == expected, "LCE of %zu and %zu is %zu, but should be %zu.",
+              pos1, pos2, lce, expected);
+  }
+
+  PackedSequence_delete(&sequence);
+  free(str);
+  return NULL;
+}
+
+char* test_extend_arms()
+{
+  const size_t str_len = 3000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+  size_t i = 0;
+  /* Long palindromes around every 300th position, some broken by an N. */
+  for(i = 150; i + 150 < str_len; i += 300) {
+    size_t j = 0;
+    for(j = 1; j < 120; j++) str[i + j] = str[i - j];
+    if(rand() % 2) str[i + 1 + rand() % 119] = 'N';
+  }
+  PackedSequence_T sequence = PackedSequence_create(str, str_len);
+
+  size_t pos = 0;
+  for(pos = 1; pos < 2 * str_len; pos++) {
+    size_t left = pos / 2;
+    size_t right = (pos - 1) / 2;
+    size_t expected = 0;
+    while(left > expected && right + expected + 1 < str_len &&
+          normalized(str[left - expected - 1]) ==
+          normalized(str[right + expected + 1])) {
+      expected++;
+    }
+    size_t steps = PackedSequence_extend_arms(sequence, left, right);
+    mu_assert(steps == expected, "Arms at center %zu extend %zu, but should %zu.",
+              pos, steps, expected);
+  }
+
+  PackedSequence_delete(&sequence);
+  free(str);
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_get);
+  mu_run_test(test_size);
+  mu_run_test(test_lce);
+  mu_run_test(test_extend_arms);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -0,0 +1,114 @@
+#include "minunit.h"
+#include "test_utils.h"
+#include "suffix_array/suffix_array.h"
+
+char* test_banana()
+{
+  char str[] = "BANANA";
+  size_t str_len = sizeof(str) - 1;
+  /* A, ANA, ANANA, BANANA, NA, NANA */
+  size_t expected_suffixes[] = {5, 3, 1, 0, 4, 2};
+  size_t expected_lcp[] = {0, 1, 3, 0, 0, 2};
+
+  SuffixArray_T suffix_array = SuffixArray_create(str, str_len);
+  mu_assert(suffix_array, "Failed to create suffix array.");
+  mu_assert(SuffixArray_get_length(suffix_array) == str_len,
+            "Suffix array has the wrong length.");
+
+  size_t i = 0;
+  for(i = 0; i < str_len; i++) {
+    mu_assert(SuffixArray_get_suffix(suffix_array, i) == expected_suffixes[i],
+              "Suffix with rank %zu should be %zu, but it is %zu.", i,
+              expected_suffixes[i], SuffixArray_get_suffix(suffix_array, i));
+    mu_assert(SuffixArray_get_lcp(suffix_array, i) == expected_lcp[i],
+              "LCP at rank %zu should be %zu, but it is %zu.", i,
+              expected_lcp[i], SuffixArray_get_lcp(suffix_array, i));
+    mu_assert(SuffixArray_get_rank(suffix_array, expected_suffixes[i]) == i,
+              "Rank of suffix %zu should be %zu.", expected_suffixes[i], i);
+  }
+
+  mu_assert(SuffixArray_lce(suffix_array, 1, 3) == 3, "LCE of ANANA and ANA is wrong.");
+  mu_assert(SuffixArray_lce(suffix_array, 0, 2) == 0, "LCE of BANANA and NANA is wrong.");
+  mu_assert(SuffixArray_lce(suffix_array, 2, 2) == 4, "LCE of NANA and itself is wrong.");
+
+  int rc = SuffixArray_verify(suffix_array, str);
+  mu_assert(rc == 0, "Suffix array verification failed.");
+
+  SuffixArray_delete(&suffix_array);
+  mu_assert(suffix_array == NULL, "SuffixArray_delete did not clear the pointer.");
+
+  return NULL;
+}
+
+char* test_edge_strings()
+{
+  char* strings[] = {"", "A", "AA", "AB", "BA", "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA",
+                     "ABABABABABABABABABABABABABABABABABABABABABABAB",
+                     "MISSISSIPPI", "\xff\x01\xff\x01\x80"};
+  size_t i = 0;
+
+  for(i = 0; i < sizeof(strings)/sizeof(strings[0]); i++) {
+    size_t str_len = strlen(strings[i]);
+    SuffixArray_T suffix_array = SuffixArray_create(strings[i], str_len);
+    mu_assert(suffix_array, "Failed to create suffix array for string %zu.", i);
+    int rc = SuffixArray_verify(suffix_array, strings[i]);
+    mu_assert(rc == 0, "Suffix array verification failed for string %zu.", i);
+    SuffixArray_delete(&suffix_array);
+  }
+
+  return NULL;
+}
+
+char* test_random_strings()
+{
+  const size_t str_len = 5000;
+  char* str = calloc((str_len + 1), sizeof(char));
+
+  unsigned int i = 0;
+  for(i = 0; i < 10; i++) {
+    size_t length = rand() % str_len + 1;
+    random_string(str, length);
+    SuffixArray_T suffix_array = SuffixArray_create(str, length);
+    mu_assert(suffix_array, "Failed to create suffix array.");
+    int rc = SuffixArray_verify(suffix_array, str);
+    mu_assert(rc == 0, "Suffix array verification failed for random string.");
+    SuffixArray_delete(&suffix_array);
+  }
+  free(str);
+
+  return NULL;
+}
+
+char* test_periodic_string()
+{
+  /* Long repeats make SA-IS recurse several times. */
+  const size_t str_len = 20000;
+  char* str = calloc((str_len + 1), sizeof(char));
+  size_t i = 0;
+  for(i = 0; i < str_len; i++) {
+    str[i] = "AACAACAAG"[i % 9];
+  }
+
+  SuffixArray_T suffix_array = SuffixArray_create(str, str_len);
+  mu_assert(suffix_array, "Failed to create suffix array.");
+  int rc = SuffixArray_verify(suffix_array, str);
+  mu_assert(rc == 0, "Suffix array verification failed for periodic string.");
+  SuffixArray_delete(&suffix_array);
+  free(str);
+
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_banana);
+  mu_run_test(test_edge_strings);
+  mu_run_test(test_random_strings);
+  mu_run_test(test_periodic_string);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
@@ -39,12 +39,32 @@ char* test_suffix_tree_allocs()
   return NULL;
 }
 
+char* test_suffix_tree_alphabet_allocs()
+{
+  fprintf(stderr, "\n\nBEGIN SuffixTree_T ALPHABET ALLOC TESTS\n");
+  char str[] = "GATTACACATTAG";
+  size_t str_len = sizeof(str) - 1;
+
+  int i = 0;
+  for(i = 0; i < 25; i++) {
+    SuffixTree_T tree = SuffixTree_create_with_alphabet(str, str_len, "ACGT");
+    if(tree) {
+      int rc = SuffixTree_verify(tree);
+      mu_assert(rc == 0, "Failed suffix tree verification.");
+    }
+    SuffixTree_delete(&tree);
+  }
+
+  fprintf(stderr, "END SuffixTree_T ALPHABET ALLOC TESTS\n\n");
+  return NULL;
+}
 
 char* all_tests()
 {
   mu_suite_start();
   
   mu_run_test(test_suffix_tree_allocs);
+  mu_run_test(test_suffix_tree_alphabet_allocs);
   
   FREE_FAILING_ALLOCS
 
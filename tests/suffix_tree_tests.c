@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "minunit.h"
 #include "test_utils.h"
 #include "suffix_tree/suffix_tree.h"
@@ -151,6 +153,190 @@ char* test_node_array()
   return NULL;
 }
 
+/* Build a tree large enough that its nodes span several arena slabs. */
+char* test_multiple_slabs()
+{
+  const size_t str_len = 100000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+
+  SuffixTree_T stree = SuffixTree_create(str, str_len);
+  mu_assert(stree, "Failed to create suffix tree.");
+  SuffixTreeIndex_T num_nodes = SuffixTree_get_num_nodes(stree);
+  mu_assert(num_nodes > 65536, "Tree should span more than one slab.");
+
+  SuffixTreeIndex_T* label_record = calloc(num_nodes, sizeof(SuffixTreeIndex_T));
+  int ret = label_test_dfs(SuffixTree_get_root(stree), &label_record, num_nodes);
+  mu_assert(ret == 0, "Failed node index verfication for large string.");
+
+  Node_T* leaf_array = SuffixTree_create_leaf_array(stree);
+  ret = SuffixTree_verify_leaf_array(stree, leaf_array);
+  mu_assert(ret == 0, "Failed leaf array verification for large string.");
+
+  free(leaf_array);
+  free(label_record);
+  SuffixTree_delete(&stree);
+  free(str);
+
+  return NULL;
+}
+
+char* test_edge_depths()
+{
+  const size_t str_len = 5000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+
+  SuffixTree_T stree = SuffixTree_create(str, str_len);
+  mu_assert(stree, "Failed to create suffix tree.");
+  Node_T* node_array = SuffixTree_create_node_array(stree);
+  mu_assert(node_array, "Failed to create node array.");
+
+  SuffixTreeIndex_T i = 0;
+  for(i = 0; i < SuffixTree_get_num_nodes(stree); i++) {
+    Node_T node = node_array[i];
+    SuffixTreeIndex_T depth = 0;
+    while(Node_get_parent(node) != NULL) {
+      depth += Node_get_incoming_edge_length(node, stree);
+      node = Node_get_parent(node);
+    }
+    mu_assert(depth == Node_get_edge_depth(node_array[i]),
+              "Node %zu has edge depth %zu but its path is %zu long.", i,
+              Node_get_edge_depth(node_array[i]), depth);
+  }
+
+  free(node_array);
+  SuffixTree_delete(&stree);
+  free(str);
+
+  return NULL;
+}
+
+/* A tree built with an alphabet should be the same as one built without. */
+char* test_alphabet()
+{
+  const size_t str_len = 2000;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+
+  SuffixTree_T stree = SuffixTree_create(str, str_len);
+  SuffixTree_T alpha_stree = SuffixTree_create_with_alphabet(str, str_len, "ACGTN");
+  mu_assert(alpha_stree, "Failed to create suffix tree with alphabet.");
+
+  int rc = SuffixTree_verify(alpha_stree);
+  mu_assert(rc == 0, "Suffix tree with alphabet failed self test.");
+  mu_assert(SuffixTree_get_num_nodes(stree) == SuffixTree_get_num_nodes(alpha_stree),
+            "Trees with and without an alphabet have different sizes.");
+
+  SuffixTreeIndex_T num_nodes = SuffixTree_get_num_nodes(alpha_stree);
+  SuffixTreeIndex_T* label_record = calloc(num_nodes, sizeof(SuffixTreeIndex_T));
+  rc = label_test_dfs(SuffixTree_get_root(alpha_stree), &label_record, num_nodes);
+  mu_assert(rc == 0, "Failed node index verification with alphabet.");
+
+  char absent[] = "ACGTX";
+  SuffixTreeIndex_T pos = SuffixTree_find_substring(alpha_stree, absent,
+                                                    sizeof(absent) - 1);
+  mu_assert(pos == (SuffixTreeIndex_T)-1,
+            "Found a substring that isn't in the alphabet.");
+
+  free(label_record);
+  SuffixTree_delete(&alpha_stree);
+  SuffixTree_delete(&stree);
+  free(str);
+
+  return NULL;
+}
+
+char* test_alphabet_rejects_string()
+{
+  char str[] = "GATTACA";
+  SuffixTree_T stree = SuffixTree_create_with_alphabet(str, sizeof(str) - 1, "ACG");
+  mu_assert(stree == NULL, "Created tree for a string outside its alphabet.");
+
+  return NULL;
+}
+
+/* A NodeFunc_T that counts visits. */
+SuffixTreeIndex_T count_visits_func(SuffixTree_T tree, Node_T node, void* vcount,
+                                    SuffixTreeIndex_T counter)
+{
+  (void)tree;
+  (void)node;
+  size_t* count = vcount;
+  (*count)++;
+  return counter + 1;
+}
+
+/*
+ * The tree of a run of one character is as deep as the string is long, which
+ * is too deep for traversals that recurse.
+ */
+char* test_homopolymer()
+{
+  const size_t str_len = 1000000;
+  char* str = malloc(str_len * sizeof(char));
+  memset(str, 'A', str_len);
+
+  SuffixTree_T stree = SuffixTree_create(str, str_len);
+  mu_assert(stree, "Failed to create suffix tree.");
+  SuffixTreeIndex_T num_nodes = SuffixTree_get_num_nodes(stree);
+
+  size_t count = 0;
+  int rc = SuffixTree_walk(stree, SuffixTree_get_root(stree), count_visits_func,
+                           &count, 0);
+  mu_assert(rc == 0, "Walk failed.");
+  mu_assert(count == num_nodes, "Walk visited %zu of %zu nodes.", count, num_nodes);
+
+  count = 0;
+  rc = SuffixTree_euler_walk(stree, SuffixTree_get_root(stree), count_visits_func,
+                             &count, 0);
+  mu_assert(rc == 0, "Euler walk failed.");
+  mu_assert(count == 2 * num_nodes - 1, "Euler walk made %zu visits for %zu nodes.",
+            count, num_nodes);
+
+  Node_T* node_array = SuffixTree_create_node_array(stree);
+  mu_assert(node_array, "Failed to create node array.");
+  SuffixTreeIndex_T i = 0;
+  SuffixTreeIndex_T max_depth = 0;
+  for(i = 0; i < num_nodes; i++) {
+    mu_assert(Node_get_index(node_array[i]) == i, "Node array is out of order.");
+    if(Node_get_edge_depth(node_array[i]) > max_depth)
+      max_depth = Node_get_edge_depth(node_array[i]);
+  }
+  mu_assert(max_depth == str_len + 1, "Deepest node is at %zu.", max_depth);
+
+  free(node_array);
+  SuffixTree_delete(&stree);
+  free(str);
+
+  return NULL;
+}
+
+/* Build trees in buffers the caller keeps, and in buffers the tree adopts. */
+char* test_borrowed_buffer()
+{
+  const size_t str_len = 1000;
+  char buffer[SUFFIX_TREE_BUFFER_LENGTH(1000)];
+  random_string(buffer + 1, str_len);
+
+  SuffixTree_T stree = SuffixTree_create_borrowed(buffer, str_len);
+  mu_assert(stree, "Failed to create suffix tree.");
+  mu_assert(SuffixTree_verify(stree) == 0, "Suffix tree failed self test.");
+  SuffixTreeIndex_T pos = SuffixTree_find_substring(stree, buffer + 501, 20);
+  mu_assert(pos != (SuffixTreeIndex_T)-1, "Failed to find a substring.");
+  /* The buffer is on the stack, so this would crash if it were freed. */
+  SuffixTree_delete(&stree);
+
+  char* adopted = malloc(SUFFIX_TREE_BUFFER_LENGTH(str_len));
+  memcpy(adopted + 1, buffer + 1, str_len);
+  stree = SuffixTree_create_from_buffer(adopted, str_len);
+  mu_assert(stree, "Failed to create suffix tree.");
+  mu_assert(SuffixTree_verify(stree) == 0, "Suffix tree failed self test.");
+  SuffixTree_delete(&stree);
+
+  return NULL;
+}
+
 char* all_tests()
 {
   mu_suite_start();
@@ -160,6 +346,12 @@ char* all_tests()
   mu_run_test(test_node_labels_banana);
   mu_run_test(test_node_labels_random);
   mu_run_test(test_node_array);
+  mu_run_test(test_multiple_slabs);
+  mu_run_test(test_edge_depths);
+  mu_run_test(test_alphabet);
+  mu_run_test(test_alphabet_rejects_string);
+  mu_run_test(test_homopolymer);
+  mu_run_test(test_borrowed_buffer);
 
   return NULL;
 }
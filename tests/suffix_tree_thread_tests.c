@@ -0,0 +1,147 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "minunit.h"
+#include "test_utils.h"
+#include "suffix_tree/suffix_tree.h"
+#include "lca/lca_suffix_tree.h"
+
+#define NUM_THREADS 8
+#define NUM_ROUNDS  4
+
+/* The work given to one thread, and what it found. */
+struct TreeJob {
+  char* str;
+  size_t str_len;
+  SuffixTreeIndex_T expected_num_nodes;
+  SuffixTree_T shared_tree;
+  int failed;
+};
+
+/*
+ * Build, check and delete a SuffixTree_T and an LCASuffixTree_T for the
+ * job's string, several times over.
+ */
+void* build_trees_thread(void* vjob)
+{
+  struct TreeJob* job = vjob;
+  int round = 0;
+
+  for(round = 0; round < NUM_ROUNDS; round++) {
+    SuffixTree_T tree = SuffixTree_create(job->str, job->str_len);
+    if(tree == NULL ||
+       SuffixTree_get_num_nodes(tree) != job->expected_num_nodes ||
+       SuffixTree_verify(tree) != 0) {
+      job->failed = 1;
+    }
+    SuffixTree_delete(&tree);
+
+    LCASuffixTree_T lca_tree = LCASuffixTree_create(job->str, job->str_len);
+    if(lca_tree == NULL || LCASuffixTree_verify(lca_tree) != 0) {
+      job->failed = 1;
+    }
+    LCASuffixTree_delete(&lca_tree);
+  }
+  return NULL;
+}
+
+/* Search a tree shared with other threads for every substring of a job. */
+void* search_tree_thread(void* vjob)
+{
+  struct TreeJob* job = vjob;
+  size_t start = 0, length = 0;
+
+  for(start = 0; start < job->str_len; start++) {
+    for(length = 1; start + length <= job->str_len; length++) {
+      SuffixTreeIndex_T pos = SuffixTree_find_substring(job->shared_tree,
+                                                        job->str + start,
+                                                        length);
+      if(pos == (SuffixTreeIndex_T)-1) {
+        job->failed = 1;
+        return NULL;
+      }
+    }
+  }
+  return NULL;
+}
+
+/* Trees for different strings built in different threads at the same time. */
+char* test_concurrent_builds()
+{
+  struct TreeJob jobs[NUM_THREADS];
+  pthread_t threads[NUM_THREADS];
+  size_t i = 0;
+
+  for(i = 0; i < NUM_THREADS; i++) {
+    jobs[i].str_len = 200 + 10 * i;
+    jobs[i].str = malloc(jobs[i].str_len * sizeof(char));
+    random_string(jobs[i].str, jobs[i].str_len);
+    jobs[i].failed = 0;
+    jobs[i].shared_tree = NULL;
+
+    SuffixTree_T tree = SuffixTree_create(jobs[i].str, jobs[i].str_len);
+    mu_assert(tree, "Failed to create suffix tree.");
+    jobs[i].expected_num_nodes = SuffixTree_get_num_nodes(tree);
+    SuffixTree_delete(&tree);
+  }
+
+  for(i = 0; i < NUM_THREADS; i++) {
+    int rc = pthread_create(&threads[i], NULL, build_trees_thread, &jobs[i]);
+    mu_assert(rc == 0, "Failed to start thread %zu.", i);
+  }
+  for(i = 0; i < NUM_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  for(i = 0; i < NUM_THREADS; i++) {
+    mu_assert(!jobs[i].failed, "Thread %zu built a bad tree.", i);
+    free(jobs[i].str);
+  }
+
+  return NULL;
+}
+
+/* One tree searched by several threads at the same time. */
+char* test_concurrent_searches()
+{
+  const size_t str_len = 300;
+  char* str = malloc(str_len * sizeof(char));
+  random_string(str, str_len);
+
+  SuffixTree_T tree = SuffixTree_create(str, str_len);
+  mu_assert(tree, "Failed to create suffix tree.");
+
+  struct TreeJob jobs[NUM_THREADS];
+  pthread_t threads[NUM_THREADS];
+  size_t i = 0;
+
+  for(i = 0; i < NUM_THREADS; i++) {
+    jobs[i].str = str;
+    jobs[i].str_len = str_len;
+    jobs[i].shared_tree = tree;
+    jobs[i].failed = 0;
+    int rc = pthread_create(&threads[i], NULL, search_tree_thread, &jobs[i]);
+    mu_assert(rc == 0, "Failed to start thread %zu.", i);
+  }
+  for(i = 0; i < NUM_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+    mu_assert(!jobs[i].failed, "Thread %zu failed to find a substring.", i);
+  }
+
+  SuffixTree_delete(&tree);
+  free(str);
+
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_concurrent_builds);
+  mu_run_test(test_concurrent_searches);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);
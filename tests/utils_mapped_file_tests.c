@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "minunit.h"
+#include "test_utils.h"
+#include "kolpakov_kucherov/augmented_string.h"
+#include "kolpakov_kucherov/kolpakov_kucherov.h"
+#include "manacher/manacher.h"
+#include "utils/mapped_file.h"
+
+/* Write contents to a new temporary file, and put its name in path. */
+static int write_temp_file(char* path, const char* contents, size_t length)
+{
+  strcpy(path, "/tmp/mapped_file_testXXXXXX");
+  int fd = mkstemp(path);
+  if(fd < 0) return 1;
+  ssize_t written = write(fd, contents, length);
+  close(fd);
+  return written != (ssize_t)length;
+}
+
+char* test_trailing_newline()
+{
+  char path[64];
+  const char* contents[] = {"ACGT\n", "ACGT\r\n", "ACGT", "ACGT\n\n", ""};
+  size_t lengths[] = {4, 4, 4, 5, 0};
+
+  size_t i = 0;
+  for(i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    mu_assert(write_temp_file(path, contents[i], strlen(contents[i])) == 0,
+              "Could not write temporary file.");
+    MappedFile_T file = MappedFile_open(path);
+    mu_assert(file, "Failed to map %s.", path);
+    mu_assert(MappedFile_get_length(file) == lengths[i],
+              "Length is %zu, but should be %zu.", MappedFile_get_length(file),
+              lengths[i]);
+    mu_assert(strncmp(MappedFile_get_data(file), contents[i], lengths[i]) == 0,
+              "Mapped contents are wrong.");
+    MappedFile_close(&file);
+    mu_assert(!file, "File was not set to NULL.");
+    unlink(path);
+  }
+
+  mu_assert(!MappedFile_open("/nonexistent/mapped_file_test"),
+            "Mapped a file that doesn't exist.");
+  mu_assert(!MappedFile_open("/tmp"), "Mapped a directory.");
+
+  return NULL;
+}
+
+static int sum_func(const struct GappedPalindrome* palindrome, void* data)
+{
+  size_t* sum = data;
+  *sum += palindrome->left_arm_start * 31 + palindrome->gap_start * 17 +
+          palindrome->gap_end * 7 + palindrome->arm_length;
+  return 0;
+}
+
+char* test_engines_on_file()
+{
+  char path[64];
+  size_t str_len = 3000;
+  char* str = malloc(str_len + 1);
+  random_string(str, str_len);
+  str[str_len] = '\n';
+  mu_assert(write_temp_file(path, str, str_len + 1) == 0,
+            "Could not write temporary file.");
+
+  size_t query_length = 0;
+  size_t* file_radii = manacher_file(path, &query_length);
+  size_t* radii = manacher(str, str_len);
+  mu_assert(file_radii && query_length == str_len, "manacher_file failed.");
+  mu_assert(memcmp(file_radii, radii, (2 * str_len + 1) * sizeof(size_t)) == 0,
+            "Radii from the file differ.");
+  free(file_radii);
+  free(radii);
+
+  size_t file_sum = 0;
+  size_t sum = 0;
+  int rc = length_constrained_palindromes_file(path, 5, 0, 10, sum_func,
+                                               &file_sum);
+  mu_assert(rc == 0, "length_constrained_palindromes_file failed.");
+  length_constrained_palindromes_foreach(str, str_len, 5, 0, 10, sum_func, &sum);
+  mu_assert(file_sum == sum, "Palindromes from the file differ.");
+
+  enum AugmentedStringBackend backends[] = {AUGMENTED_STRING_SUFFIX_TREE,
+                                            AUGMENTED_STRING_SUFFIX_ARRAY};
+  size_t b = 0;
+  for(b = 0; b < 2; b++) {
+    AugmentedString_T file_aug = AugmentedString_create_from_file(path, backends[b]);
+    AugmentedString_T aug = AugmentedString_create_with_backend(str, str_len,
+                                                                backends[b]);
+    mu_assert(file_aug, "AugmentedString_create_from_file failed.");
+    mu_assert(AugmentedString_get_query_length(file_aug) == str_len,
+              "Wrong query length.");
+    size_t i = 0;
+    for(i = 0; i < 1000; i++) {
+      size_t left = rand() % str_len;
+      size_t right = rand() % str_len;
+      mu_assert(AugmentedString_common_prefix_suffix_length(file_aug, left, right) ==
+                AugmentedString_common_prefix_suffix_length(aug, left, right),
+                "Common prefix suffix length differs at %zu %zu.", left, right);
+    }
+    AugmentedString_delete(&file_aug);
+    AugmentedString_delete(&aug);
+  }
+
+  unlink(path);
+  free(str);
+  return NULL;
+}
+
+static int collect_func(const struct GappedPalindrome* palindrome, void* results)
+{
+  return GappedPalindromeArray_append(results, palindrome);
+}
+
+char* test_gapped_palindromes_on_file()
+{
+  char path[64];
+  size_t str_len = 300;
+  char* str = malloc(str_len + 1);
+  random_string(str, str_len);
+  str[str_len] = '\n';
+  mu_assert(write_temp_file(path, str, str_len + 1) == 0,
+            "Could not write temporary file.");
+
+  GappedPalindromeArray_T results = GappedPalindromeArray_create();
+  int rc = length_constrained_palindromes_file(path, 2, 0, 8, collect_func, results);
+  mu_assert(rc == 0, "length_constrained_palindromes_file failed.");
+
+  /* Try every gap, in the order the search reports them: by gap end, then by
+   * gap start. */
+  size_t found = 0;
+  size_t gap_start = 0;
+  size_t gap_end = 0;
+  for(gap_end = 0; gap_end < str_len; gap_end++) {
+    gap_start = gap_end > 8 ? gap_end - 8 : 0;
+    for(; gap_start <= gap_end; gap_start++) {
+      size_t arm_length = 0;
+      while(arm_length < gap_start && gap_end + arm_length < str_len &&
+            str[gap_start - 1 - arm_length] == str[gap_end + arm_length]) {
+        arm_length++;
+      }
+      if(arm_length < 2 || str[gap_start] == str[gap_end - 1]) continue;
+
+      mu_assert(found < results->length, "Missed the palindrome with gap %zu - %zu.",
+                gap_start, gap_end);
+      struct GappedPalindrome* pal = &results->palindromes[found];
+      mu_assert(pal->gap_start == gap_start && pal->gap_end == gap_end &&
+                pal->arm_length == arm_length &&
+                pal->left_arm_start == gap_start - arm_length,
+                "Found (%zu, %zu, %zu), but should find (%zu, %zu, %zu).",
+                pal->gap_start, pal->gap_end, pal->arm_length,
+                gap_start, gap_end, arm_length);
+      found++;
+    }
+  }
+  mu_assert(found == results->length, "Found %zu palindromes, but should find %zu.",
+            results->length, found);
+
+  GappedPalindromeArray_delete(&results);
+  unlink(path);
+  free(str);
+  return NULL;
+}
+
+char* all_tests()
+{
+  mu_suite_start();
+
+  mu_run_test(test_trailing_newline);
+  mu_run_test(test_engines_on_file);
+  mu_run_test(test_gapped_palindromes_on_file);
+
+  return NULL;
+}
+
+RUN_TESTS(all_tests);